@@ -0,0 +1,131 @@
+/*
+ * ============================================================================
+ * BleUart.h
+ * HC-05 藍牙序列埠驅動（USART0 中斷驅動 + 無鎖環形緩衝區）
+ *
+ * 功能：
+ * 1. 以 USART RX 中斷接收資料，寫入單一生產者/單一消費者（SPSC）環形緩衝區
+ * 2. 在中斷中完成命令分框（以 '\r' / '\n' 作為結尾），主迴圈一次取出完整命令
+ * 3. 以 USART UDRE 中斷送出資料（實作 Print 介面，可直接使用 print/println）
+ * 4. 統計溢位、錯誤框與丟棄框數量，供 PC 端查詢（RXSTAT 命令）
+ * 5. 自動辨識二進位命令框（同步位元組 0xA5 開頭），與文字命令並存
+ *
+ * 設計說明：
+ * - 接收端 head 只由中斷寫入，tail 只由主迴圈寫入，因此不需要關閉中斷
+ * - 每一個新命令框開始前，中斷會先確認緩衝區至少剩下 BLE_FRAME_MAX 位元組，
+ *   空間不足時整框丟棄（不會留下半截命令），並累計 rxRingFull
+ * - 命令超過 BLE_FRAME_MAX - 1 字元、含有 CAN 位元組或發生硬體錯誤時，框尾改寫為 CAN (0x18)，
+ *   主迴圈讀到 CAN 即視為損壞框並回覆 ERR（資料中的 CAN 不寫入緩衝區，避免框數與內容錯開）
+ *
+ * 二進位命令框格式（見 README「二進位命令協定」）：
+ *   [0xA5] [opcode(4 位元) | len(4 位元)] [payload × len] [CRC-8]
+ * - CRC-8 多項式 0x07、初始值 0，計算範圍為標頭位元組與 payload
+ * - 文字命令不會以 0xA5 開頭，因此只要看框的第一個位元組即可分辨
+ * - 二進位框內位元組間隔超過 BLE_BIN_TIMEOUT_MS 視為中斷，以 0 補足長度後結束，
+ *   並將標頭的 opcode 改為保留的 0（不論 CRC 是否恰好相符都回覆 NAK），
+ *   避免後續文字命令被當成二進位資料吃掉
+ * ============================================================================
+ */
+
+#ifndef BLE_UART_H
+#define BLE_UART_H
+
+#include <Arduino.h>
+
+// ===== 緩衝區大小（必須為 2 的次方，且不超過 256）=====
+#define BLE_RX_RING_SIZE 128     // 接收環形緩衝區大小（位元組）
+#define BLE_TX_RING_SIZE 64      // 傳送環形緩衝區大小（位元組）
+#define BLE_FRAME_MAX    64      // 單一命令框最大長度（含結尾字元）
+
+// 框結尾標記（寫入環形緩衝區，主迴圈以此判斷命令邊界）
+#define BLE_FRAME_END    '\n'    // 正常結尾
+#define BLE_FRAME_CANCEL 0x18    // 損壞框結尾（ASCII CAN）
+
+// ===== 二進位命令框 =====
+#define BLE_BIN_SYNC       0xA5  // 同步位元組
+#define BLE_BIN_PAYLOAD_MAX 15   // 標頭低 4 位元可表示的最大 payload 長度
+#define BLE_BIN_FRAME_MAX  (1 + 1 + BLE_BIN_PAYLOAD_MAX + 1)  // 同步 + 標頭 + payload + CRC
+#define BLE_BIN_TIMEOUT_MS 20    // 二進位框內位元組最大間隔（9600bps 時每位元組約 1ms）
+#define BLE_BIN_ACK        0x06  // 二進位回覆：成功（ASCII ACK）
+#define BLE_BIN_NAK        0x15  // 二進位回覆：失敗（ASCII NAK）
+
+// ===== 接收統計計數器 =====
+struct BleRxCounters {
+  uint16_t framesOk;       // 成功取出的命令框數
+  uint16_t framesDropped;  // 損壞而丟棄的命令框數（過長或硬體錯誤）
+  uint16_t rxRingFull;     // 因環形緩衝區空間不足而整框丟棄的次數
+  uint16_t rxTooLong;      // 超過 BLE_FRAME_MAX 的命令框數
+  uint16_t rxHwOverrun;    // 硬體資料溢位次數（DOR0）
+  uint16_t rxFrameError;   // 硬體框錯誤 / 同位錯誤次數（FE0 / UPE0）
+  uint16_t rxBinTimeout;   // 二進位框逾時中斷次數
+};
+
+// ===== 主迴圈取框結果 =====
+enum BleFrameType {
+  BLE_FRAME_NONE,     // 目前沒有完整的命令框
+  BLE_FRAME_TEXT,     // 取得一行文字命令
+  BLE_FRAME_BINARY,   // 取得一個二進位命令框（標頭 + payload + CRC，不含同步位元組）
+  BLE_FRAME_DROPPED   // 取得一個損壞框（內容已丟棄）
+};
+
+class BleUart : public Print {
+public:
+  void begin(unsigned long baud);
+  void setBaud(unsigned long baud);                      // 只變更鮑率（HC-05 設定流程使用）
+  static uint16_t baudErrorPermille(unsigned long baud);  // 實際鮑率的誤差（千分比）
+
+  // ===== 傳送（Print 介面）=====
+  virtual size_t write(uint8_t c);
+  using Print::write;
+  void mute(bool on) { txMuted = on; }                       // 靜音期間寫入的資料直接丟棄（批次命令）
+
+  // ===== 接收（主迴圈端）=====
+  uint8_t framesReady() const;                               // 已完整接收的命令框數
+  BleFrameType readFrame(char* buf, size_t bufSize, size_t* len);  // 取出一個命令框
+  void getCounters(BleRxCounters* out);                      // 讀取統計計數器快照
+  void resetCounters();                                      // 清除統計計數器
+
+  // ===== 中斷端（由 ISR 或模擬環境呼叫）=====
+  void onRxByte(uint8_t c, uint8_t status);                  // 收到一個位元組
+  bool onTxReady(uint8_t* c);                                // 取出下一個待送位元組
+
+private:
+  // 接收框狀態機
+  enum RxState : uint8_t {
+    RX_IDLE,      // 等待新框
+    RX_TEXT,      // 文字框接收中
+    RX_DISCARD,   // 已寫入部分資料但框已損壞，等待結尾改寫為 CAN
+    RX_SKIP,      // 空間不足，整框丟棄直到結尾
+    RX_BIN_HDR,   // 二進位框：等待標頭位元組
+    RX_BIN_BODY,  // 二進位框：接收 payload 與 CRC
+    RX_BIN_SKIP   // 二進位框：空間不足，依長度丟棄
+  };
+
+  void pushRx(uint8_t c);
+  uint8_t rxFree() const;
+
+  // 接收環形緩衝區（head: ISR 寫入；tail: 主迴圈寫入）
+  volatile uint8_t rxBuf[BLE_RX_RING_SIZE];
+  volatile uint8_t rxHead;
+  volatile uint8_t rxTail;
+  volatile uint8_t framesIn;     // ISR 完成的框數（只由 ISR 遞增）
+  uint8_t framesOut;             // 主迴圈取出的框數（只由主迴圈遞增）
+
+  // ISR 端分框狀態
+  volatile RxState rxState;
+  volatile uint8_t frameLen;      // 文字框：已接收長度；二進位框：剩餘位元組數
+  volatile uint8_t binHeader;     // 目前二進位框標頭在 rxBuf 的位置（逾時時改寫 opcode）
+  volatile unsigned long lastRxMs;  // 上一個位元組的接收時間（二進位框逾時判斷）
+
+  // 傳送環形緩衝區（head: 主迴圈寫入；tail: ISR 寫入）
+  volatile uint8_t txBuf[BLE_TX_RING_SIZE];
+  volatile uint8_t txHead;
+  volatile uint8_t txTail;
+  bool txMuted;                   // 只由主迴圈讀寫
+
+  volatile BleRxCounters counters;
+};
+
+extern BleUart bleSerial;  // HC-05 藍牙序列埠（取代 Arduino Serial）
+
+#endif
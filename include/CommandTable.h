@@ -0,0 +1,77 @@
+/*
+ * ============================================================================
+ * CommandTable.h
+ * 藍牙文字命令註冊表（編譯期產生，名稱與處理函式皆存放於 PROGMEM）
+ *
+ * 使用方式：
+ * 1. 以 X-macro 列出所有命令：
+ *      #define BLE_COMMANDS(X) \
+ *        X(PING, cmdPing)      \
+ *        X(LOAD, cmdLoad)
+ * 2. 以 DEFINE_COMMAND_TABLE(BLE_COMMANDS) 產生：
+ *    - enum 命令編號（CMD_PING, CMD_LOAD, ..., CMD_COUNT）
+ *    - PROGMEM 名稱字串與 { 名稱, 處理函式 } 表，SRAM 執行次數陣列 commandCount[]（STATS 命令）
+ *    - findCommand()：以雜湊值 switch 查表（常數時間）
+ *
+ * 比對規則：
+ * - 命令動詞為行首連續的大寫字母（例如 "LOAD50" 的動詞為 "LOAD"）
+ * - 雜湊相同後再以 strncmp_P 確認完全相同，"XLOADWRITE" 不會被當成 WRITE
+ * - 兩個命令的雜湊值若相同，switch 會出現重複的 case 而編譯失敗，
+ *   因此新增命令時不需要人工檢查碰撞
+ * ============================================================================
+ */
+
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+
+#include <Arduino.h>
+
+// 命令處理函式：args 為動詞後的參數（已去除前導空白），回傳是否成功
+typedef bool (*CommandHandler)(char* args);
+
+struct CommandEntry {
+  PGM_P name;              // 命令名稱（PROGMEM 字串）
+  CommandHandler handler;  // 處理函式
+};
+
+// ===== 命令雜湊（djb2-xor，16 位元）=====
+// 編譯期版本：供 switch 的 case 標籤使用
+constexpr uint16_t cmdHash(const char* s, uint16_t h = 5381) {
+  return *s ? cmdHash(s + 1, (uint16_t)((uint16_t)(h * 33) ^ (uint8_t)*s)) : h;
+}
+
+// 執行期版本：計算長度為 len 的動詞雜湊（結果與 cmdHash 相同）
+inline uint16_t cmdHashN(const char* s, uint8_t len) {
+  uint16_t h = 5381;
+  while (len--) {
+    h = (uint16_t)(h * 33) ^ (uint8_t)*s++;
+  }
+  return h;
+}
+
+// ===== 產生命令表 =====
+#define CMDTAB_ENUM(name, fn)   CMD_##name,
+#define CMDTAB_NAME(name, fn)   const char cmdName_##name[] PROGMEM = #name;
+#define CMDTAB_ENTRY(name, fn)  { cmdName_##name, fn },
+#define CMDTAB_CASE(name, fn)   case cmdHash(#name): id = CMD_##name; break;
+
+#define DEFINE_COMMAND_TABLE(LIST)                                              \
+  enum CommandId { LIST(CMDTAB_ENUM) CMD_COUNT };                               \
+  LIST(CMDTAB_NAME)                                                             \
+  const CommandEntry commandTable[CMD_COUNT] PROGMEM = { LIST(CMDTAB_ENTRY) };  \
+  uint16_t commandCount[CMD_COUNT];                                             \
+  /* 以雜湊查表並確認名稱完全相同；找不到時回傳 -1 */                           \
+  int8_t findCommand(const char* verb, uint8_t len) {                           \
+    int8_t id;                                                                  \
+    switch (cmdHashN(verb, len)) {                                              \
+      LIST(CMDTAB_CASE)                                                         \
+      default: return -1;                                                       \
+    }                                                                           \
+    PGM_P name = (PGM_P)pgm_read_ptr(&commandTable[id].name);                   \
+    if (strncmp_P(verb, name, len) != 0 || pgm_read_byte(name + len) != '\0') { \
+      return -1;                                                                \
+    }                                                                           \
+    return id;                                                                  \
+  }
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * ============================================================================
+ * DeviceStats.h
+ * 裝置統計（STATS 命令）：loop() 執行時間直方圖與命令解析計數
+ *
+ * 使用方式：
+ * - loop() 結束時呼叫 loopDone(本次執行微秒數)，不含閒置睡眠的時間
+ * - 命令分派失敗時呼叫 parseError()；二進位命令框呼叫 binaryFrame(是否成功)；
+ *   批次命令行呼叫 batch()
+ * - 其他計數器沿用各子系統既有的統計（排程器、接收、WS2812、合成器、EEPROM），
+ *   STATS 命令彙整輸出，STATS RESET 一起清除
+ *
+ * 直方圖：
+ * - 以 2 的次方分組，第 0 組為 0 ~ 7µs，第 n 組為 2^(n+2) ~ 2^(n+3)-1µs，
+ *   最後一組包含所有更長的執行時間（≥ 8192µs）
+ * - 分組只需右移與計數，不做除法
+ * - 每組為 16 位元計數器，達到 65535 後停止增加（STATS 顯示 65535 表示已飽和，
+ *   以 STATS RESET 重新開始）；總次數以 32 位元的 loops 為準
+ * ============================================================================
+ */
+
+#ifndef DEVICE_STATS_H
+#define DEVICE_STATS_H
+
+#include <Arduino.h>
+
+#define STATS_LOOP_BUCKETS 12   // 直方圖組數
+#define STATS_LOOP_MIN_SHIFT 3  // 第 0 組的上限：2^3 = 8µs
+
+class DeviceStats {
+public:
+  void reset();
+
+  // ===== 主迴圈 =====
+  void loopDone(uint32_t us) {
+    loops++;
+    if (us > maxLoop) {
+      maxLoop = us;
+    }
+    uint8_t b = 0;
+    us >>= STATS_LOOP_MIN_SHIFT;
+    while (us && b < STATS_LOOP_BUCKETS - 1) {
+      us >>= 1;
+      b++;
+    }
+    if (hist[b] != 0xFFFF) {
+      hist[b]++;
+    }
+  }
+
+  // ===== 命令 =====
+  void parseError() { parseErrors++; }
+  void binaryFrame(bool ok) {
+    binFrames++;
+    if (!ok) {
+      binNaks++;
+    }
+  }
+  void batch() { batches++; }
+
+  // ===== 查詢 =====
+  uint32_t elapsedMs() const { return millis() - since; }
+  uint32_t loopCount() const { return loops; }
+  uint32_t loopMaxUs() const { return maxLoop; }
+  uint16_t bucket(uint8_t b) const { return hist[b]; }
+  uint16_t parseErrorCount() const { return parseErrors; }
+  uint16_t binaryFrameCount() const { return binFrames; }
+  uint16_t binaryNakCount() const { return binNaks; }
+  uint16_t batchCount() const { return batches; }
+
+private:
+  unsigned long since;    // 上一次清除的時間（毫秒）
+  uint32_t loops;
+  uint32_t maxLoop;       // 最長一次 loop()（微秒）
+  uint16_t hist[STATS_LOOP_BUCKETS];  // 飽和計數
+  uint16_t parseErrors;   // 文字命令分派失敗（未知命令或參數錯誤）
+  uint16_t binFrames;     // 二進位命令框數
+  uint16_t binNaks;       // 其中回覆 NAK 的次數
+  uint16_t batches;       // 批次命令行數（以 ';' 分隔的多個命令）
+};
+
+extern DeviceStats devStats;
+
+#endif
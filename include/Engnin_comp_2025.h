@@ -8,7 +8,7 @@
  * 1. 引入所需的 Adafruit 函式庫（NeoPixel、GFX、ST7735）
  * 2. 引入 FreeMono 字型（9pt, 12pt, 18pt, 24pt）
  * 3. 提供按鍵讀取巨集（keyB, keyC, keyD）
- * 4. 提供 Timer1 初始化函式（timer_ini）
+ * 4. 提供 Timer1 初始化函式（timer_ini：溢位模式；timer_ini_ctc：CTC 模式）
  * 5. 提供 24 位元轉 16 位元顏色轉換函式（convert24to16）
  * ============================================================================
  */
@@ -83,6 +83,49 @@ void timer_ini(uint16_t tm){
   interrupts();             // 重新開啟所有中斷
 }
 
+/*
+ * ============================================================================
+ * 函式名稱：timer_ini_ctc
+ * 功能說明：以 CTC 模式初始化 Timer1（產生不累積誤差的週期性中斷）
+ *
+ * 參數：
+ *   top - 比較值 OCR1A（uint16_t, 0-65535）
+ *
+ * 計算公式：
+ *   中斷頻率 = 16MHz / (預分頻器 × (top + 1))
+ *   預分頻器 = 64
+ *
+ * 範例：
+ *   1kHz (每 1ms): top = 16000000 / 64 / 1000 - 1 = 249
+ *
+ * 與 timer_ini() 的差異：
+ *   timer_ini() 在溢位中斷中重新載入 TCNT1，進入中斷前已經過的計數
+ *   （中斷延遲、中斷被關閉的時間）會被覆蓋掉，週期因此逐次變長；
+ *   CTC 模式由硬體在 TCNT1 == OCR1A 時歸零，中斷何時執行都不影響下一次的時間
+ *
+ * 使用方式：
+ *   timer_ini_ctc(249);  // 設定為 1kHz
+ *   需要配合 ISR(TIMER1_COMPA_vect) 中斷服務程式使用（不需重新載入計數器）
+ * ============================================================================
+ */
+void timer_ini_ctc(uint16_t top){
+  noInterrupts();           // 關閉所有中斷（確保設定過程不被打斷）
+
+  TCCR1A = 0;               // WGM11:10 = 00
+  TCCR1B = (1 << WGM12);    // WGM13:12 = 01 → CTC 模式，TOP = OCR1A
+
+  TCNT1 = 0;                // 從 0 開始計數
+  OCR1A = top;              // 比較值（TCNT1 到達後下一個計數歸零）
+
+  TCCR1B |= (1 << CS11) | (1 << CS10);  // 設定預分頻器為 64 (CS12=0, CS11=1, CS10=1)
+                                        // 16MHz / 64 = 250kHz 計數頻率
+
+  TIFR1 = (1 << OCF1A);     // 清除先前的比較匹配旗標
+  TIMSK1 = (1 << OCIE1A);   // 只啟用比較匹配 A 中斷
+
+  interrupts();             // 重新開啟所有中斷
+}
+
 /*
  * ============================================================================
  * 函式名稱：convert24to16
@@ -113,6 +156,10 @@ void timer_ini(uint16_t tm){
  * 應用場景：
  *   某些 TFT 顯示器（如 ST7735）使用 RGB565 格式，此函式可將
  *   常見的 24 位元顏色碼轉換為顯示器所需的 16 位元格式
+ * 
+ * 注意：
+ *   每次呼叫 3 次 map()（32 位元乘除法），結果相同但不含除法、
+ *   且可在編譯時期計算的版本見 include/Rgb565.h
  * ============================================================================
  */
 uint16_t convert24to16(uint32_t rgb) {
@@ -0,0 +1,104 @@
+/*
+ * ============================================================================
+ * Hc05Config.h
+ * HC-05 開機自動設定（AT 模式狀態機：模組名稱與 UART 鮑率）
+ *
+ * 使用方式：
+ * - setup() 產生藍牙名稱後呼叫 begin(KEY 腳位, 名稱, 記錄的鮑率)；之後由排程器在 ready() 時呼叫 run()
+ * - active() 期間序列資料都是 AT 回覆，一般命令處理（SERIAL 工作）暫停
+ * - 完成後 baud() 為資料模式的鮑率，result() 為設定結果；confirmed() 時模組在 baud() 回覆過 AT，
+ *   呼叫端應保存此鮑率，下次開機傳入 begin()
+ *
+ * 流程（每一步送出一行 AT 命令，等待 OK / ERROR 或 HC05_REPLY_MS 逾時）：
+ * 1. KEY 拉高進入 AT 模式（開機後拉高為「mini AT」，使用目前的資料鮑率）
+ * 2. 探測：依序以 115200 / 57600 / 38400 / 9600 送出 "AT"，第一個回覆 OK 的即為模組目前鮑率
+ * 3. AT+NAME? 與目前名稱相同時不寫入，否則 AT+NAME=<名稱>
+ * 4. AT+UART? 已是目標鮑率時不寫入；否則由高到低嘗試 AT+UART=<鮑率>,0,0
+ *    （目標為 115200 與 57600 中，以目前 F_CPU 的 U2X 分頻誤差不超過 HC05_BAUD_ERROR_MAX 者）
+ * 5. 改變鮑率時 AT+RESET、KEY 拉低，等待模組重新開機後再探測一次確認新鮑率
+ *
+ * 安全退回：
+ * - 任何一步逾時或 ERROR：KEY 拉低，以最後確認可用的鮑率回到資料模式
+ * - 完全沒有回覆（未接 KEY、模組不在或已連線）：回到 begin() 傳入的記錄鮑率
+ *   （沒有記錄時為 HC05_DEFAULT_BAUD）。模組已連線時 AT 命令會直接轉送到遠端，
+ *   而模組可能早已設定為較高的鮑率並存在自身 Flash；MCU 單獨重置後必須沿用該鮑率，否則連線無法通訊
+ * - 已送出 AT+UART 並重新開機後沒有回覆（例如遠端在重新開機後立刻連線）：使用新鮑率（不記錄）
+ * - 模組只在改變設定時寫入自身的 Flash；設定已正確時重新開機只有探測與兩個查詢
+ * ============================================================================
+ */
+
+#ifndef HC05_CONFIG_H
+#define HC05_CONFIG_H
+
+#include <Arduino.h>
+
+#define HC05_DEFAULT_BAUD 9600      // 模組出廠資料鮑率（沒有回覆且沒有記錄的鮑率時使用）
+#define HC05_KEY_SETTLE_MS 50       // KEY 改變後等待模組切換模式
+#define HC05_REPLY_MS 200           // 每一行 AT 命令等待回覆的時間
+#define HC05_RESET_MS 1000          // AT+RESET 後等待模組重新開機
+#define HC05_BAUD_ERROR_MAX 25      // 目標鮑率允許的分頻誤差（千分比）
+#define HC05_LINE_MAX 32            // 回覆行緩衝區（最長的 "+NAME:EVEN-99-1111" 為 18 字元，超過部分截斷）
+
+enum Hc05Result : uint8_t {
+  HC05_PENDING,    // 設定中
+  HC05_OK,         // 名稱與鮑率已是目標值（或已更新並確認）
+  HC05_FALLBACK,   // 模組有回應，但鮑率未能提高（維持可用的鮑率）
+  HC05_NO_MODULE   // 沒有任何 AT 回覆（或模組已連線），使用記錄的鮑率或 HC05_DEFAULT_BAUD
+};
+
+class Hc05Config {
+public:
+  void begin(uint8_t keyPin, const char* name, unsigned long savedBaud);  // savedBaud：0 = 沒有記錄
+
+  bool active() const { return state != HC_DONE; }
+  bool ready() const;  // 有回覆行或目前步驟已到時間（可在中斷關閉時呼叫）
+  void run();          // 處理回覆 / 逾時並前進一步
+
+  unsigned long baud() const { return linkBaud; }
+  Hc05Result result() const { return outcome; }
+  bool confirmed() const { return linkConfirmed; }   // 模組在 baud() 回覆過 AT（可保存為下次的退回鮑率）
+  uint8_t commandCount() const { return commands; }  // 送出的 AT 命令數
+  uint8_t writeCount() const { return writes; }      // 改變模組設定的命令數（AT+NAME= / AT+UART=）
+
+private:
+  enum State : uint8_t {
+    HC_SETTLE,       // KEY 拉高後等待
+    HC_PROBE,        // 探測目前鮑率
+    HC_NAME_QUERY,
+    HC_NAME_SET,
+    HC_UART_QUERY,
+    HC_UART_SET,
+    HC_RESET,        // AT+RESET
+    HC_REBOOT,       // 等待模組重新開機
+    HC_DONE
+  };
+
+  void probe();
+  void command(PGM_P cmd, const char* arg = NULL);
+  void onReply(const char* line);
+  void onTimeout();
+  void nameQueried(bool ok);
+  void setUart();
+  void finish(Hc05Result r, unsigned long baud);
+  void wait(unsigned long ms);
+
+  uint8_t keyPin;
+  const char* name;
+  State state;
+  Hc05Result outcome;
+  bool verifying;            // 重新開機後的確認探測
+  bool valueMatched;         // 本步驟的 +NAME / +UART 回覆與目標相同
+  bool linkConfirmed;        // linkBaud 已由模組的 OK 確認
+  uint8_t probeIndex;        // 目前探測的鮑率（HC05_BAUDS 索引）
+  uint8_t targetIndex;       // 目前嘗試的 AT+UART 目標
+  unsigned long linkBaud;    // 目前 USART 鮑率（探測成功後即為模組鮑率）
+  unsigned long pendingBaud; // AT+UART 設定的新鮑率（重新開機後生效）
+  unsigned long fallbackBaud; // 完全沒有回覆時使用的鮑率（記錄的鮑率或 HC05_DEFAULT_BAUD）
+  unsigned long deadline;    // 目前步驟的逾時時間（millis）
+  uint8_t commands;
+  uint8_t writes;
+};
+
+extern Hc05Config hc05;
+
+#endif
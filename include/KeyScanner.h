@@ -0,0 +1,94 @@
+/*
+ * ============================================================================
+ * KeyScanner.h
+ * 按鍵掃描（PCINT1 腳位變化中斷 + 每鍵防彈跳 + 事件佇列 + 長按 / 自動重複）
+ *
+ * 使用方式：
+ * - 按鍵接在 PORTC 的 PC0 ~ PC3（A0 ~ A3），INPUT_PULLUP，按下為 LOW；
+ *   按鍵編號 = PORTC 位元（A0 = 0）
+ * - begin() 開啟 PCINT1 並清空佇列；之後按下 / 放開由中斷記錄，不必輪詢腳位
+ * - 主程式在 ready() 為 true 時呼叫 poll()，再以 next() 逐一取出事件
+ *
+ * 防彈跳（每個按鍵獨立，不會互相阻擋）：
+ * - 第一個邊緣立即產生事件（時間戳記為中斷當下的 millis()），
+ *   之後 KEY_DEBOUNCE_MS 內同一按鍵的邊緣視為彈跳而忽略
+ * - 忽略期結束時由 poll() 重新取樣；若電位已與目前狀態不同（彈跳中放開的短按），補上一個邊緣
+ *
+ * 事件：
+ * - KEY_EV_PRESS / KEY_EV_RELEASE：按下 / 放開
+ * - KEY_EV_LONG：按住超過 KEY_LONG_MS（每次按下最多一次）
+ * - KEY_EV_REPEAT：setRepeat() 指定的按鍵按住 delayMs 後，每 rateMs 一次
+ * - 事件時間為實際發生時間，與主迴圈多久執行一次無關；長時間重繪期間的按鍵保留在佇列中
+ * - 佇列滿時丟棄新事件（droppedEvents() 計數，STATS 回報為 KEYDROP）
+ * ============================================================================
+ */
+
+#ifndef KEY_SCANNER_H
+#define KEY_SCANNER_H
+
+#include <Arduino.h>
+
+#define KEY_SCAN_KEYS 4       // 按鍵數（PC0 ~ PC3）
+#define KEY_QUEUE_SIZE 8      // 事件佇列長度（2 的次方）
+#define KEY_DEBOUNCE_MS 20    // 邊緣後的彈跳忽略時間
+#define KEY_LONG_MS 800       // 長按判定時間
+
+enum KeyEventType : uint8_t {
+  KEY_EV_PRESS,
+  KEY_EV_RELEASE,
+  KEY_EV_LONG,
+  KEY_EV_REPEAT
+};
+
+struct KeyEvent {
+  uint8_t key;          // 按鍵編號（PORTC 位元）
+  KeyEventType type;
+  unsigned long time;   // 發生時間（millis）
+};
+
+class KeyScanner {
+public:
+  void begin();
+  void setRepeat(uint8_t mask, uint16_t delayMs, uint16_t rateMs);  // mask：位元 n = 按鍵 n
+
+  bool ready() const;          // 佇列有事件，或有按鍵的計時（彈跳結束、長按、重複）已到期
+  void poll();                 // 處理到期的計時（在主迴圈呼叫）
+  bool next(KeyEvent* ev);     // 取出最早的事件
+  bool isDown(uint8_t key) const { return keys[key].flags & K_DOWN; }
+  uint16_t droppedEvents() const;  // 佇列滿而丟棄的事件數（STATS 的 KEYDROP）
+  void resetStats();
+
+  void onChange();  // PCINT1 中斷呼叫
+
+private:
+  enum : uint8_t {
+    K_DOWN   = 0x01,  // 防彈跳後的狀態：按下
+    K_LOCKED = 0x02,  // 彈跳忽略期間
+    K_LONG   = 0x04   // 本次按下已送出長按事件
+  };
+
+  struct KeyState {
+    uint8_t flags;
+    unsigned long edgeAt;    // 最後一次接受的邊緣時間（按下中 = 按下時間）
+    unsigned long repeatAt;  // 下一次自動重複時間
+  };
+
+  void edge(uint8_t key, bool down, unsigned long now);
+  void push(uint8_t key, KeyEventType type, unsigned long time);
+  void schedule();
+
+  // ===== 中斷與主迴圈共用（主迴圈存取時關閉中斷）=====
+  KeyState keys[KEY_SCAN_KEYS];
+  KeyEvent queue[KEY_QUEUE_SIZE];
+  volatile uint8_t head, tail;
+  volatile bool dueValid;      // dueAt 有效（有按鍵在計時）
+  unsigned long dueAt;         // 最早到期的計時
+  uint16_t dropped;
+
+  uint8_t repeatMask;
+  uint16_t repeatDelay, repeatRate;
+};
+
+extern KeyScanner keys;
+
+#endif
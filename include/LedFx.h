@@ -0,0 +1,81 @@
+/*
+ * ============================================================================
+ * LedFx.h
+ * WS2812 動畫引擎（以經過時間驅動的定點數效果，繪製到 LedStage）
+ *
+ * 使用方式：
+ * - 以 solid() / blink() / gradient() / breathe() / chase() / off() 選擇效果；
+ *   參數與目前效果相同時不會重新開始（可在週期更新中重複呼叫）
+ * - render() 由 LEDOUT 工作每幀呼叫一次，依 millis() 計算目前畫面並 present()
+ * - 由呼叫端直接在 LedStage 繪製逐顆內容時（例如多核心 LOAD），先呼叫 hold()
+ *   停止動畫，render() 之後不再覆寫暫存幀
+ *
+ * 時間基準：
+ * - 每個效果的一個週期分為 256 個相位單位；步進量為每毫秒前進的相位（8.8 定點數），
+ *   相位 = 經過毫秒 × 步進量，只需一次 32 位元乘法
+ * - 畫面只由經過時間決定，與呼叫頻率、序列負載無關；延遲的幀直接跳到正確相位
+ * - 步進量取整數部分，週期誤差小於 1 / 步進量（1 秒週期約 0.8%）
+ *
+ * 查表（PROGMEM，各 256 位元組）：
+ * - fxGamma：Gamma 2.6 校正（與 Adafruit_NeoPixel::gamma8() 相同）
+ * - fxHue：已套用 Gamma 的色相斜波，R / G / B 分別取相位 h、h-85、h-171
+ *   （等同 gamma32(ColorHSV())，不需要 6 段分支與乘法）
+ *
+ * 每幀成本固定：靜態效果只在開始時繪製一次；動態效果每顆 LED 最多 3 次查表
+ * ============================================================================
+ */
+
+#ifndef LED_FX_H
+#define LED_FX_H
+
+#include <Arduino.h>
+#include <LedStage.h>
+
+#define FX_ALL 0xFF                // count 參數：全部 LED
+#define FX_STEP(periodMs) ((uint16_t)((256UL * 256UL) / (periodMs)))  // 週期 → 8.8 步進量
+
+enum FxMode : uint8_t {
+  FX_OFF,        // 全暗
+  FX_SOLID,      // 前 count 顆恆亮
+  FX_BLINK,      // 前 count 顆閃爍（週期前半亮），flashes 次後轉為恆亮
+  FX_GRADIENT,   // 色相環平均分布在全部 LED 上旋轉
+  FX_BREATHE,    // 全部 LED 呼吸（三角波亮度經 Gamma 校正）
+  FX_CHASE,      // 單點追逐（前一顆 1/4 亮度拖尾）
+  FX_HOLD        // 不繪製：暫存幀由呼叫端直接寫入 LedStage
+};
+
+class LedFx {
+public:
+  void begin();
+
+  // ===== 選擇效果 =====
+  void off();
+  void solid(uint32_t color, uint8_t count = FX_ALL);
+  void blink(uint32_t color, uint8_t count, uint16_t periodMs, uint8_t flashes = 0);
+  void gradient(uint16_t periodMs);
+  void breathe(uint32_t color, uint16_t periodMs);
+  void chase(uint32_t color, uint16_t periodMs);
+  void hold();
+
+  // ===== 繪製 =====
+  void render();  // 依經過時間繪製目前效果（LEDOUT 工作每幀呼叫）
+
+  FxMode mode() const { return fxMode; }
+
+private:
+  void start(FxMode m, uint32_t color, uint8_t count, uint16_t periodMs, uint8_t flashes);
+  void drawLevel(uint8_t i, uint8_t level);  // 以 color × level / 256 繪製一顆
+
+  FxMode fxMode;
+  uint8_t rgb[3];          // 效果顏色（R, G, B）
+  uint8_t count;           // 使用的 LED 數
+  uint8_t spread;          // 漸層中相鄰 LED 的色相差（256 / count）
+  uint16_t step;           // 每毫秒相位步進量（8.8 定點數）
+  uint8_t flashes;         // 閃爍次數（0 = 持續閃爍）
+  bool drawn;              // 靜態效果已繪製
+  unsigned long startMs;   // 效果開始時間（millis）
+};
+
+extern LedFx ledFx;
+
+#endif
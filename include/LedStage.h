@@ -0,0 +1,68 @@
+/*
+ * ============================================================================
+ * LedStage.h
+ * WS2812 輸出級（暫存幀 + 變化偵測 + 幀率上限）
+ *
+ * 使用方式：
+ * - 以 setPixel() / fill() 在暫存幀中繪製，完成一幀後呼叫 present()
+ * - present() 將暫存幀與上次送出的幀比對：內容相同則不送出
+ * - 實際的 strip.show() 只在 show() 中呼叫（由排程器的 LEDOUT 工作每幀執行一次，
+ *   工作週期即幀率上限）；期間 present() 的多幀只送出最後一幀
+ *
+ * 為何需要：AVR 版 show() 傳送期間關閉中斷，每顆 LED 24 位元 × 1.25µs = 30µs
+ * （8 顆約 240µs），期間 USART 與 Timer1 中斷都會延後
+ *
+ * 統計（LEDSTAT 命令查詢）：
+ * - frames：present() 次數；skipped：與上次送出相同而略過；merged：送出前被下一幀取代
+ * - shows：strip.show() 次數；irqOffUs：show() 關閉中斷的累計時間（依 WS2812 位元時序計算）
+ * ============================================================================
+ */
+
+#ifndef LED_STAGE_H
+#define LED_STAGE_H
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+
+#define LED_STAGE_MAX 16         // 最多 LED 數（暫存幀 + 已送出幀各 3 位元組 / 顆）
+#define LED_BIT_US_X100 125      // WS2812 每位元 1.25µs
+#define LED_IRQ_OFF_US(n) ((uint32_t)(n) * 24 * LED_BIT_US_X100 / 100)
+
+// 輸出統計
+struct LedStats {
+  uint32_t frames;    // present() 次數
+  uint32_t skipped;   // 與上次送出相同而略過的幀數
+  uint32_t merged;    // 尚未送出即被下一幀取代的幀數
+  uint32_t shows;     // strip.show() 次數
+  uint32_t irqOffUs;  // show() 關閉中斷的累計時間（微秒）
+};
+
+class LedStage {
+public:
+  void begin(Adafruit_NeoPixel* strip);
+
+  // ===== 繪製 =====
+  void setPixel(uint8_t n, uint32_t color);
+  void fill(uint32_t color);
+  void present();      // 一幀繪製完成（與上次送出的幀比對）
+
+  // ===== 輸出 =====
+  bool pending() const { return dirty; }  // 有待送出的幀
+  void show();                            // 送出暫存幀
+
+  uint8_t size() const { return count; }
+  const LedStats& stats() const { return ledStats; }
+  void resetStats() { memset(&ledStats, 0, sizeof(ledStats)); }
+
+private:
+  Adafruit_NeoPixel* strip;
+  uint8_t count;
+  bool dirty;                      // 暫存幀與已送出幀不同，等待送出
+  uint8_t frame[LED_STAGE_MAX * 3];  // 暫存幀（R, G, B，未套用亮度）
+  uint8_t sent[LED_STAGE_MAX * 3];   // 上次送出的幀
+  LedStats ledStats;
+};
+
+extern LedStage leds;
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * ============================================================================
+ * PowerManager.h
+ * 閒置睡眠（SLEEP_MODE_IDLE）與 TFT 背光 PWM 淡出
+ *
+ * 使用方式：
+ * - setup() 呼叫 begin(背光腳位, 淡出秒數)：背光全亮、關閉未使用的周邊（ADC、TWI、Timer2）
+ * - loop() 在 sched.runSlice() 沒有工作可執行時呼叫 idle(狀態編號)
+ * - 按鍵或序列資料時呼叫 activity()：背光恢復全亮並重新計時
+ *
+ * 閒置睡眠：
+ * - 關閉中斷後以 sched.pending() 再確認一次沒有工作，才 sleep_enable() → sei() → sleep_cpu()；
+ *   sei 之後的下一個指令一定先執行，期間發生的中斷會在睡眠後立即喚醒，不會被錯過
+ * - SLEEP_MODE_IDLE 保留所有時鐘：USART RX、Timer1 tick、PCINT1 按鍵、EE_READY 與
+ *   Timer0（millis / 背光 PWM）都會喚醒，週期工作最多晚 1ms 釋放
+ * - 每個狀態（由主程式定義，例如目前選單）分別累計經過時間與睡眠時間，
+ *   活動比例 = 1 - 睡眠 / 經過
+ *
+ * 背光淡出：
+ * - 超過 dimTimeout() 秒沒有 activity() 時，以 BACKLIGHT_FADE_MS 由全亮淡出到 BACKLIGHT_DIM
+ * - 計時與淡出都是 TimerWheel 上的軟體計時器；背光為 Timer0 的 OC0A PWM（D6），不影響睡眠
+ * ============================================================================
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+#define POWER_STATES 5            // 統計的狀態數（編號 0 ~ POWER_STATES - 1）
+
+#define BACKLIGHT_FULL 255        // 全亮 PWM 值
+#define BACKLIGHT_DIM 16          // 淡出後的 PWM 值
+#define BACKLIGHT_FADE_MS 1000    // 淡出時間
+#define BACKLIGHT_FADE_STEP_MS 20 // 淡出每一步的間隔
+
+struct PowerStats {
+  uint32_t totalUs;   // 經過時間
+  uint32_t sleepUs;   // 其中睡眠的時間
+};
+
+class PowerManager {
+public:
+  void begin(uint8_t backlightPin, uint8_t dimSeconds);
+
+  uint32_t idle(uint8_t state);  // 沒有工作可執行時呼叫：睡眠直到下一個中斷，回傳睡眠微秒數
+  void activity();               // 有使用者或序列活動：背光全亮並重新計時
+
+  void setDimTimeout(uint8_t seconds);  // 0 = 不淡出
+  uint8_t dimTimeout() const { return dimSeconds; }
+  uint8_t backlight() const { return level; }
+
+  // ===== 統計 =====
+  const PowerStats& stats(uint8_t state) const { return states[state]; }
+  uint16_t activePermille(uint8_t state) const;  // 活動比例（千分比）
+  void resetStats();
+
+  // ===== 計時器回呼 =====
+  void onDim();
+  void onFadeStep();
+
+private:
+  void setBacklight(uint8_t value);
+
+  uint8_t pin;
+  uint8_t level;         // 目前背光 PWM 值
+  uint8_t dimSeconds;
+  PowerStats states[POWER_STATES];
+  unsigned long mark;    // 上一次計入統計的時間（微秒）
+};
+
+extern PowerManager power;
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * ============================================================================
+ * RecordStore.h
+ * EEPROM 耗損平均記錄區（環狀槽位 + 序號 + CRC-16，EE_READY 中斷非同步寫入）
+ *
+ * 使用方式：
+ * 1. 定義固定大小的設定結構（欄位可自由增減，大小改變後舊記錄自動失效）；
+ *    韌體只讀寫 RAM 中的設定結構，EEPROM 只在開機時讀取一次
+ * 2. setup() 中呼叫 eepromStore.begin(0, E2END + 1, sizeof(設定))，
+ *    再以 load() 取回最新一筆記錄（沒有有效記錄時回傳 false，維持預設值）
+ * 3. 設定改變時呼叫 commit()：複製到暫存區後立即返回，由 EE_READY 中斷在背景燒寫；
+ *    內容與最新一筆相同時不寫入
+ * 4. 需要確認資料已寫入 EEPROM 時，等待 busy() 變為 false
+ *
+ * 槽位格式（每槽 recordSize + 4 位元組）：
+ *   [序號低位元組] [序號高位元組] [記錄 × recordSize] [CRC 低位元組] [CRC 高位元組]
+ * - CRC-16（avr-libc _crc16_update，初始值 0xFFFF），計算範圍為記錄大小、序號與記錄內容
+ * - 序號 0xFFFF 保留給未寫入的 EEPROM（出廠內容為 0xFF）
+ *
+ * 耗損平均：
+ * - 每次寫入使用下一個槽位，整個區域輪流使用；每個位元組的寫入次數
+ *   約為寫入次數 / slots()（區域大小 / (recordSize + 4)；1KB、6 位元組的 AppSettings 為 102 槽）
+ * - 只燒寫與 EEPROM 現有內容不同的位元組
+ *
+ * 非同步寫入（回寫快取）：
+ * - EE_READY 中斷每次燒寫一個位元組（約 3.3ms），主迴圈不再忙碌等待
+ * - 燒寫某一槽期間再次 commit()：新內容取代尚未開始燒寫的暫存記錄（合併），
+ *   目前的槽完成後只再寫一槽最新內容
+ * - 暫存記錄由 commit() 在關閉中斷下複製，中斷開始新的一槽時才取用
+ *
+ * 斷電保護：
+ * - 先寫記錄內容與 CRC，最後才寫序號；中途斷電時該槽 CRC 不符，
+ *   開機時仍以前一筆有效記錄為準（尚未燒寫的暫存記錄會遺失）
+ * - 開機時掃描全部槽位，取 CRC 正確且序號最新（序號差以 int16_t 比較，可跨越溢位）者
+ * ============================================================================
+ */
+
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <Arduino.h>
+
+#define STORE_RECORD_MAX 16      // 記錄大小上限（RAM 暫存區大小）
+#define STORE_SLOT_OVERHEAD 4    // 序號 2 + CRC 2
+#define STORE_SEQ_EMPTY 0xFFFF   // 未寫入槽位的序號
+#define STORE_NONE 0xFFFF        // 沒有有效記錄
+
+// 寫入統計（EESTAT 命令查詢）
+struct StoreStats {
+  uint16_t slot;          // 最新已寫入記錄的槽位（STORE_NONE = 無）
+  uint16_t seq;           // 最新已寫入記錄的序號
+  uint16_t commits;       // 實際寫入的槽數
+  uint16_t skipped;       // 內容未改變而略過的次數
+  uint16_t merged;        // 尚未燒寫即被新內容取代的次數
+  uint32_t bytesWritten;  // 實際燒寫的位元組數（平均每槽 = bytesWritten / commits）
+};
+
+class RecordStore {
+public:
+  bool begin(uint16_t base, uint16_t length, uint8_t recordSize);  // 掃描槽位，有有效記錄時回傳 true
+  bool load(void* record) const;     // 讀出最新一筆記錄（已寫入或等待寫入）
+  bool commit(const void* record);   // 排入新記錄（內容未改變時略過並回傳 false）
+
+  bool busy() const { return pending || writing; }  // 還有尚未寫入 EEPROM 的記錄
+
+  // ===== 狀態與統計 =====
+  uint16_t slots() const { return slotCount; }
+  void getStats(StoreStats* out);
+  void resetStats();  // 清除計數器（保留最新槽位與序號）
+
+  void onReady();  // EE_READY 中斷呼叫
+
+private:
+  uint16_t slotAddr(uint16_t slot) const { return base + slot * (recordSize + STORE_SLOT_OVERHEAD); }
+  uint16_t readWord(uint16_t addr) const;
+  uint16_t crcStart(uint16_t seqNo) const;
+  uint16_t slotCrc(uint16_t slot, uint16_t seqNo) const;
+  void startSlot();
+
+  uint16_t base;
+  uint16_t slotCount;
+  uint8_t recordSize;
+  bool hasRecord;                      // 已有記錄（已寫入或已排入）
+  uint8_t shadow[STORE_RECORD_MAX];    // 最新一筆記錄（已寫入或等待寫入）
+
+  // ===== 中斷與主迴圈共用 =====
+  volatile bool pending;               // shadow 尚未開始燒寫
+  volatile bool writing;               // 中斷正在燒寫 image
+  uint8_t image[STORE_RECORD_MAX + STORE_SLOT_OVERHEAD];  // 燒寫中的槽位內容
+  uint16_t wrSlot;                     // 燒寫中的槽位
+  uint8_t wrPos;                       // 下一個檢查的位元組（依燒寫順序）
+  StoreStats storeStats;
+};
+
+extern RecordStore eepromStore;
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * ============================================================================
+ * Rgb565.h
+ * RGB888 → RGB565 顏色轉換（編譯時期常數、執行時期快速版、批次轉換）
+ *
+ * 結果與 Engnin_comp_2025.h 的 convert24to16() 完全相同（每個分量為
+ * v × max / 255 無條件捨去），但不使用 map()：
+ * - convert24to16() 每次呼叫 3 次 map()，各為一次 32 位元乘法與除法，
+ *   AVR 沒有硬體除法器，除法由函式庫以迴圈完成
+ * - 這裡以 8×8 位元硬體乘法加上移位求 x / 255：(x + (x >> 8) + 1) >> 8，
+ *   x < 65535 時與整數除法結果相同（x 最大為 255 × 63 = 16065）
+ *
+ * 使用方式：
+ * - RGB565(0xFF5500)：編譯時期常數（樣板參數，保證摺疊成常數，可用於 PROGMEM 表）
+ * - rgb565(color) / rgb565(r, g, b)：constexpr 函式；參數為常數時同樣在編譯時期計算，
+ *   否則為不含除法的行內程式碼
+ * - rgb565Convert() / rgb565Convert_P()：批次轉換 RAM / PROGMEM 中的 24 位元顏色陣列
+ *
+ * 基準測試：tools/rgb565bench（主機上比較四種寫法的執行時間並逐一比對輸出）
+ * ============================================================================
+ */
+
+#ifndef RGB565_H
+#define RGB565_H
+
+#include <Arduino.h>
+
+// 8 位元分量 v 縮放為 0 ~ max（v × max / 255，無條件捨去）
+constexpr uint8_t rgb565Scale(uint8_t v, uint8_t max) {
+  return (uint8_t)(((uint16_t)v * max + (((uint16_t)v * max) >> 8) + 1) >> 8);
+}
+
+constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((uint16_t)rgb565Scale(r, 0x1F) << 11) |
+         ((uint16_t)rgb565Scale(g, 0x3F) << 5) |
+         rgb565Scale(b, 0x1F);
+}
+
+constexpr uint16_t rgb565(uint32_t rgb) {
+  return rgb565((uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb);
+}
+
+// 編譯時期常數：樣板參數必須是常數運算式，結果一定摺疊成立即值
+template <uint32_t RGB>
+struct Rgb565Const {
+  enum : uint16_t { value = rgb565(RGB) };
+};
+#define RGB565(rgb) ((uint16_t)Rgb565Const<(rgb)>::value)
+
+// ===== 批次轉換 =====
+void rgb565Convert(const uint32_t* src, uint16_t* dst, uint16_t count);
+void rgb565Convert_P(const uint32_t* srcProgmem, uint16_t* dst, uint16_t count);
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * ============================================================================
+ * Scheduler.h
+ * 協同式工作排程器（每個工作有週期、優先權與時間預算，並統計錯過截止時間次數）
+ *
+ * 使用方式：
+ * 1. 以 X-macro 列出所有工作：
+ *      //     名稱    函式        觸發條件     週期ms 預算us 優先權 旗標
+ *      #define APP_TASKS(X)                                              \
+ *        X(SERIAL, taskSerial, serialReady, 10,    2000,  0,     SCHED_PREEMPT) \
+ *        X(LED,    taskLed,    NULL,        500,   100,   3,     0)
+ * 2. 以 DEFINE_TASK_TABLE(APP_TASKS) 產生：
+ *    - enum 工作編號（TASK_SERIAL, TASK_LED, ..., TASK_COUNT）
+ *    - PROGMEM 名稱字串與工作表 taskTable[]，SRAM 狀態陣列 taskState[]
+ * 3. setup() 結束前呼叫 sched.begin(taskTable, taskState, TASK_COUNT)，
+ *    loop() 呼叫 sched.runSlice()；沒有工作可執行時（回傳 false）可以進入睡眠，
+ *    睡眠前在關閉中斷的狀態下以 pending() 再確認一次，避免錯過剛發生的事件
+ *
+ * 排程規則：
+ * - 週期工作（觸發條件為 NULL）：每 periodMs 釋放一次，截止時間為下一次釋放
+ * - 事件工作（觸發條件不為 NULL）：排程器看到 ready() 為 true 時釋放，
+ *   periodMs 為相對截止時間（從釋放到執行完成的上限）；
+ *   ready() 必須可以在中斷關閉時呼叫，且不得開啟中斷（需要時保存並恢復 SREG）
+ * - 每個切片只執行一個工作：已釋放且優先權數字最小者（0 最高）
+ * - 耗時的工作（例如 UiCompositor 重繪）在內部呼叫 sched.yield() 標示切片邊界，
+ *   帶有 SCHED_PREEMPT 旗標、優先權較高且已釋放的工作會在此先執行。
+ *   可插入的工作不得使用被插入工作正在使用的資源（例如序列工作不直接繪圖）
+ *
+ * 統計（TASKS 命令查詢）：
+ * - misses：完成時間超過截止時間的次數（週期工作完成時已過了幾次釋放，
+ *   就跳過並計入幾次，不會連續補跑）
+ * - overruns：單次執行時間超過 budgetUs 的次數
+ * - maxSliceUs：相鄰兩個切片邊界的最大間隔，即事件工作最久的等待時間
+ * ============================================================================
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// ===== 工作旗標 =====
+#define SCHED_PREEMPT 0x01  // 可在其他工作的切片邊界（yield）插入執行
+#define SCHED_STOPPED 0x02  // 開機時為停止狀態，需以 start() 啟動
+
+#define SCHED_NONE 0xFF     // 沒有工作在執行
+
+typedef void (*TaskFunction)();
+typedef bool (*TaskReady)();
+
+// 工作定義（存放於 PROGMEM）
+struct TaskDef {
+  PGM_P name;          // 工作名稱（PROGMEM 字串）
+  TaskFunction run;    // 工作函式
+  TaskReady ready;     // 事件觸發條件（NULL = 週期工作）
+  uint16_t periodMs;   // 週期工作：執行週期；事件工作：相對截止時間
+  uint16_t budgetUs;   // 單次執行時間預算
+  uint8_t priority;    // 優先權（0 最高）
+  uint8_t flags;       // SCHED_PREEMPT / SCHED_STOPPED
+};
+
+// 工作統計
+struct TaskStats {
+  uint32_t runs;        // 執行次數
+  uint16_t misses;      // 錯過截止時間次數
+  uint16_t overruns;    // 超過時間預算次數
+  uint32_t maxRunUs;    // 最長單次執行時間
+  uint32_t totalRunUs;  // 累計執行時間（平均 = totalRunUs / runs）
+};
+
+// 工作執行期狀態（SRAM）
+struct TaskState {
+  unsigned long release;  // 週期工作：下一次釋放時間；事件工作：釋放時間（微秒）
+  uint8_t flags;          // 內部狀態（啟用 / 已釋放）
+  TaskStats stats;
+};
+
+class Scheduler {
+public:
+  void begin(const TaskDef* table, TaskState* state, uint8_t count);
+
+  bool runSlice();   // 執行一個切片（由 loop() 呼叫）；沒有已釋放的工作時回傳 false
+  bool pending();    // 有已釋放的工作（可在中斷關閉時呼叫）
+  void wake();       // 睡眠醒來後呼叫：睡眠時間不計入切片間隔
+  void yield();      // 切片邊界：讓可插入的高優先權工作先執行
+
+  void start(uint8_t id, uint16_t delayMs = 0);  // 啟動工作（delayMs 後第一次釋放）
+  void stop(uint8_t id);                         // 停止工作（不再釋放）
+  bool active(uint8_t id) const;
+
+  // ===== 統計 =====
+  uint8_t count() const { return taskCount; }
+  PGM_P name(uint8_t id) const;
+  const TaskStats& stats(uint8_t id) const { return state[id].stats; }
+  uint32_t maxSliceUs() const { return sliceMaxUs; }
+  void resetStats();
+
+private:
+  bool isDue(uint8_t id, unsigned long now);
+  void runTask(uint8_t id);
+  void boundary(unsigned long now);
+
+  const TaskDef* table;
+  TaskState* state;
+  uint8_t taskCount;
+  uint8_t running;            // 目前執行中的工作（SCHED_NONE = 無）
+  bool inYield;               // 插入執行中（不可重入）
+  uint32_t stolenUs;          // 目前工作執行期間被插入工作占用的時間
+  unsigned long lastBoundary; // 上一個切片邊界的時間（微秒）
+  uint32_t sliceMaxUs;
+};
+
+extern Scheduler sched;
+
+// ===== 產生工作表 =====
+#define TASKTAB_ENUM(name, fn, ready, period, budget, prio, flags)  TASK_##name,
+#define TASKTAB_NAME(name, fn, ready, period, budget, prio, flags)  const char taskName_##name[] PROGMEM = #name;
+#define TASKTAB_ENTRY(name, fn, ready, period, budget, prio, flags) \
+  { taskName_##name, fn, ready, period, budget, prio, flags },
+
+#define DEFINE_TASK_TABLE(LIST)                                         \
+  enum TaskId { LIST(TASKTAB_ENUM) TASK_COUNT };                        \
+  LIST(TASKTAB_NAME)                                                    \
+  const TaskDef taskTable[TASK_COUNT] PROGMEM = { LIST(TASKTAB_ENTRY) }; \
+  TaskState taskState[TASK_COUNT];
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * ============================================================================
+ * TimerWheel.h
+ * 系統 tick（Timer1 CTC 1kHz）與階層式軟體計時器輪
+ *
+ * 使用方式：
+ * - setup() 以 timer_ini_ctc(TIMER_TICK_OCR) 設定 Timer1，
+ *   ISR(TIMER1_COMPA_vect) 只呼叫 timers.tick()
+ * - 每個計時器是一個 SoftTimer 全域變數（SoftTimer t(callback);），以 start() / stop() 登記與取消，
+ *   兩者都是 O(1)（插入 / 移出雙向串列，不搜尋）
+ * - 主程式在 ready() 為 true 時呼叫 run()，到期的回呼函式在主迴圈中依到期順序執行
+ *
+ * 不會累積誤差：
+ * - CTC 模式由硬體在比較匹配時將 TCNT1 歸零，中斷延遲（含中斷關閉期間）不影響下一次 tick
+ * - 週期計時器的下一次到期時間為「上一次到期時間 + 週期」，與回呼何時實際執行無關；
+ *   主迴圈延誤時回呼延後，但之後的到期時間不會跟著漂移
+ *
+ * 計時器輪：TIMER_WHEEL_LEVELS 層、每層 TIMER_WHEEL_SLOTS 槽，第 n 層每槽 16^n tick：
+ * - 依距離到期的 tick 數放入對應層的槽；上層的槽在下層轉完一圈時整槽下移（cascade）
+ * - 超過最上層範圍的計時器放在最上層最後一槽，下移時重新計算
+ * - 每層以 16 位元圖記錄非空槽，ready() 只需比較下一個事件時間，
+ *   run() 直接跳到下一個事件，空的 tick 不需處理
+ * ============================================================================
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <Arduino.h>
+
+#define TIMER_TICK_HZ 1000                                // 系統 tick 頻率
+#define TIMER_TICK_OCR (F_CPU / 64 / TIMER_TICK_HZ - 1)   // Timer1 預分頻 64 時的 OCR1A（16MHz：249）
+
+#define TIMER_WHEEL_BITS 4
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)  // 每層槽數（16）
+#define TIMER_WHEEL_LEVELS 3                       // 層數：直接涵蓋 16^3 = 4096 tick
+
+#define TIMER_IDLE 0  // SoftTimer::slot：未登記
+
+typedef void (*TimerCallback)();
+
+struct SoftTimer {
+  constexpr SoftTimer(TimerCallback cb)
+    : fn(cb), period(0), expires(0), next(NULL), prev(NULL), slot(TIMER_IDLE) {}
+
+  TimerCallback fn;    // 到期時呼叫（主迴圈中執行）
+  uint16_t period;     // 週期（tick）；0 = 單次
+  uint32_t expires;    // 到期時間（tick）
+  SoftTimer* next;     // 同一槽的雙向串列
+  SoftTimer* prev;
+  uint8_t slot;        // 所在的槽（層 × TIMER_WHEEL_SLOTS + 索引 + 1），TIMER_IDLE = 未登記
+};
+
+class TimerWheel {
+public:
+  void begin();
+
+  void start(SoftTimer* t, uint32_t delay, uint16_t period = 0);  // delay tick 後到期（至少 1）
+  void stop(SoftTimer* t);
+  bool active(const SoftTimer* t) const { return t->slot != TIMER_IDLE; }
+
+  bool ready() const;   // 有計時器到期，或有上層的槽需要下移
+  void run();           // 處理到目前 tick 為止的所有事件（在主迴圈呼叫）
+
+  uint32_t now() const;  // 目前 tick 數（開機後的毫秒，不受主迴圈延誤影響）
+
+  void tick() { ticks++; }  // Timer1 比較匹配中斷呼叫
+
+private:
+  void insert(SoftTimer* t);
+  void unlink(SoftTimer* t);
+  void cascade(uint8_t level);
+  void expire();
+  void schedule();
+
+  SoftTimer* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+  uint16_t occupied[TIMER_WHEEL_LEVELS];  // 非空槽位元圖
+  uint32_t wheelTime;                     // 計時器輪已處理到的 tick
+  uint32_t dueAt;                         // 下一個事件的 tick
+  bool dueValid;                          // 有登記的計時器（dueAt 有效）
+
+  volatile uint32_t ticks;                // 中斷累加的 tick 數
+};
+
+extern TimerWheel timers;
+
+#endif
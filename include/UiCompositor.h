@@ -0,0 +1,117 @@
+/*
+ * ============================================================================
+ * UiCompositor.h
+ * TFT 保留式畫面合成器（文字欄位 + 色塊，只傳送有變化的字元格）
+ *
+ * 使用方式：
+ * - 每個畫面元素佔用一個固定編號（文字欄位 UiTextSlot、色塊 UiBarSlot）
+ * - 切換畫面：beginScreen() → 宣告新畫面的所有元素 → flush()
+ *   新畫面沒有宣告的舊元素會在 flush() 時以背景色清除
+ * - 局部更新：直接呼叫 text() / bar() 後 flush()，其他元素保持不變
+ * - 固定文字以 F("...") 傳入（PROGMEM，不占 SRAM）；執行期組出的文字傳入一般字串
+ *
+ * 重繪規則：
+ * - 文字欄位以「字元格」（6x8 × 字體大小）為單位比對，只重繪內容或顏色改變的格子
+ *   （例如倒數 00:00:10 → 00:00:09 只傳送最後一格 18x24 像素）
+ * - 元素位置、大小或欄寬改變時，先清除舊範圍再完整重繪
+ * - 清除或重繪色塊時，與其重疊的其他元素會標記為需要完整重繪（維持繪製順序：
+ *   色塊在下、文字在上）
+ * - 字元格以單一位址視窗 + 同色像素連續傳送，不經過 drawChar() 的逐點 fillRect
+ *
+ * 面板內容由合成器全權管理；若其他程式直接以 tft 繪圖，需呼叫 invalidate()
+ *
+ * 切片邊界：每傳送一個字元格或一段色塊 / 清除範圍（UI_ERASE_BAND 列）後
+ * 呼叫 setYield() 設定的函式，讓序列資料等高優先權工作不必等整個畫面畫完。
+ * 該函式不可再呼叫合成器
+ * ============================================================================
+ */
+
+#ifndef UI_COMPOSITOR_H
+#define UI_COMPOSITOR_H
+
+#include <Arduino.h>
+#include <Adafruit_SPITFT.h>
+
+// ===== 容量設定（SRAM 用量約 UI_MAX_TEXTS × 33 + UI_MAX_BARS × 7 位元組）=====
+#define UI_MAX_TEXTS 9     // 文字欄位數
+#define UI_MAX_BARS  2     // 色塊數
+#define UI_TEXT_MAX  18    // 單一文字欄位最大字元數（主選單項目 "> 1.Connect to BLE"；dirty 遮罩為 32 位元）
+#define UI_BG        0x0000  // 畫面背景色（ST77XX_BLACK）
+#define UI_ERASE_BAND 4      // 填滿色塊 / 清除範圍時每段的列數（每段之後為一個切片邊界）
+
+// 合成器統計（可用於評估每次更新的傳輸量）
+struct UiStats {
+  uint32_t cells;    // 重繪的字元格數
+  uint32_t pixels;   // 傳送到面板的像素數（含清除與色塊）
+};
+
+class UiCompositor {
+public:
+  void begin(Adafruit_SPITFT* display);
+
+  // ===== 畫面宣告 =====
+  void beginScreen();   // 開始宣告新畫面（未宣告的舊元素在 flush() 時清除）
+  void text(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+            const char* str, uint16_t fg, uint16_t bg = UI_BG);
+  void text(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+            const __FlashStringHelper* str, uint16_t fg, uint16_t bg = UI_BG);
+  void number(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+              long value, uint16_t fg, uint16_t bg = UI_BG);
+  void bar(uint8_t slot, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color);
+  void flush();         // 傳送所有變化到面板
+
+  void invalidate();    // 面板內容未知（例如外部 fillScreen 後），全部元素下次重繪
+  void clear();         // 以背景色清除整個面板（分段讓出），全部元素下次重繪
+  void setYield(void (*fn)()) { yieldFn = fn; }  // 切片邊界回呼（NULL = 不讓出）
+  const UiStats& stats() const { return uiStats; }
+  void resetStats() { memset(&uiStats, 0, sizeof(uiStats)); }
+
+private:
+  enum : uint8_t {
+    F_VISIBLE  = 0x01,  // 目前顯示在面板上
+    F_DECLARED = 0x02,  // 本次畫面已宣告
+    F_FULL     = 0x04   // 需要完整重繪
+  };
+
+  struct Rect {
+    uint8_t x, y, w, h;
+  };
+
+  struct TextItem {
+    Rect r;                   // 占用範圍（cols × 6size, 8size）
+    uint8_t size, cols, flags;
+    uint16_t fg, bg;
+    uint32_t dirty;           // 需要重繪的字元格
+    char shown[UI_TEXT_MAX];  // 面板上（或即將）顯示的內容，不足部分為空白
+  };
+
+  struct BarItem {
+    Rect r;
+    uint8_t flags;
+    uint16_t color;
+  };
+
+  static bool overlaps(const Rect& a, const Rect& b);
+  void setText(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+               const char* str, bool progmem, uint16_t fg, uint16_t bg);
+  void fillBands(const Rect& r, uint16_t color);
+  void erase(const Rect& r);
+  void markOverlaps(const Rect& r);
+  void drawCell(const TextItem& t, uint8_t col);
+  void yieldSlice() {
+    if (yieldFn) {
+      yieldFn();
+    }
+  }
+
+  Adafruit_SPITFT* tft;
+  TextItem texts[UI_MAX_TEXTS];
+  BarItem bars[UI_MAX_BARS];
+  bool screenOpen;
+  void (*yieldFn)();
+  UiStats uiStats;
+};
+
+extern UiCompositor ui;
+
+#endif
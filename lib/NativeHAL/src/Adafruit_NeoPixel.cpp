@@ -0,0 +1,157 @@
+/*
+ * Adafruit_NeoPixel.cpp（NativeHAL 版本）
+ * 色彩運算（亮度縮放、ColorHSV、gamma）與原函式庫相同
+ */
+
+#include <Adafruit_NeoPixel.h>
+#include <HalSim.h>
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type)
+    : numLEDs_(n), brightness_(0), begun_(false), lastShowEnd_(0), showCount_(0), irqOffCycles_(0) {
+  (void)pin;
+  (void)type;
+  pixels_ = (uint8_t*)calloc(n * 3, 1);
+  sent_ = (uint8_t*)calloc(n * 3, 1);
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+  free(pixels_);
+  free(sent_);
+}
+
+bool Adafruit_NeoPixel::canShow(void) {
+  return HalSim::cycles() - lastShowEnd_ >= NEO_LATCH_US * (F_CPU / 1000000UL);
+}
+
+void Adafruit_NeoPixel::show(void) {
+  // 等待上一幀的 latch 時間（中斷開啟）
+  uint64_t latch = NEO_LATCH_US * (F_CPU / 1000000UL);
+  uint64_t since = HalSim::cycles() - lastShowEnd_;
+  if (showCount_ > 0 && since < latch) {
+    HalSim::advanceCycles(latch - since);
+  }
+
+  // 傳送資料：24 位元 × 1.25µs / LED，期間中斷關閉
+  uint64_t busy = (uint64_t)numLEDs_ * 24 * 20;  // 1.25µs = 20 週期
+  uint8_t saved = SREG;
+  cli();
+  HalSim::advanceCycles(busy);
+  memcpy(sent_, pixels_, numLEDs_ * 3);
+  if (saved & (1 << SREG_I)) {
+    sei();
+  }
+
+  irqOffCycles_ += busy;
+  showCount_++;
+  lastShowEnd_ = HalSim::cycles();
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+  if (n >= numLEDs_) {
+    return;
+  }
+  if (brightness_) {
+    r = (r * brightness_) >> 8;
+    g = (g * brightness_) >> 8;
+    b = (b * brightness_) >> 8;
+  }
+  uint8_t* p = &pixels_[n * 3];
+  p[0] = g;  // NEO_GRB 順序
+  p[1] = r;
+  p[2] = b;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+  setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+void Adafruit_NeoPixel::fill(uint32_t c, uint16_t first, uint16_t count) {
+  uint16_t end = (count == 0 || first + count > numLEDs_) ? numLEDs_ : first + count;
+  for (uint16_t i = first; i < end; i++) {
+    setPixelColor(i, c);
+  }
+}
+
+void Adafruit_NeoPixel::clear(void) {
+  memset(pixels_, 0, numLEDs_ * 3);
+}
+
+void Adafruit_NeoPixel::setBrightness(uint8_t b) {
+  uint8_t newBrightness = b + 1;
+  if (newBrightness == brightness_) {
+    return;
+  }
+  // 與原函式庫相同：重新縮放已存的像素值
+  uint8_t oldBrightness = brightness_ - 1;
+  uint16_t scale;
+  if (oldBrightness == 0) {
+    scale = 0;
+  } else if (b == 255) {
+    scale = 65535 / oldBrightness;
+  } else {
+    scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+  }
+  for (uint16_t i = 0; i < numLEDs_ * 3; i++) {
+    pixels_[i] = (pixels_[i] * scale) >> 8;
+  }
+  brightness_ = newBrightness;
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const {
+  if (n >= numLEDs_) {
+    return 0;
+  }
+  const uint8_t* p = &pixels_[n * 3];
+  uint8_t r = p[1], g = p[0], b = p[2];
+  if (brightness_) {
+    r = (r << 8) / brightness_;
+    g = (g << 8) / brightness_;
+    b = (b << 8) / brightness_;
+  }
+  return Color(r, g, b);
+}
+
+uint32_t Adafruit_NeoPixel::lastFrame(uint16_t n) const {
+  if (n >= numLEDs_) {
+    return 0;
+  }
+  const uint8_t* p = &sent_[n * 3];
+  return Color(p[1], p[0], p[2]);
+}
+
+uint32_t Adafruit_NeoPixel::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val) {
+  uint8_t r, g, b;
+  hue = (hue * 1530L + 32768) / 65536;
+  if (hue < 510) {
+    b = 0;
+    if (hue < 255) { r = 255; g = hue; } else { r = 510 - hue; g = 255; }
+  } else if (hue < 1020) {
+    r = 0;
+    if (hue < 765) { g = 255; b = hue - 510; } else { g = 1020 - hue; b = 255; }
+  } else if (hue < 1530) {
+    g = 0;
+    if (hue < 1275) { r = hue - 1020; b = 255; } else { r = 255; b = 1530 - hue; }
+  } else {
+    r = 255;
+    g = b = 0;
+  }
+  uint32_t v1 = 1 + val;
+  uint16_t s1 = 1 + sat;
+  uint8_t s2 = 255 - sat;
+  return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+         (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+         (((((b * s1) >> 8) + s2) * v1) >> 8);
+}
+
+uint8_t Adafruit_NeoPixel::gamma8(uint8_t x) {
+  // 原函式庫的查表值以 gamma 2.6 產生
+  return (uint8_t)(pow(x / 255.0, 2.6) * 255.0 + 0.5);
+}
+
+uint32_t Adafruit_NeoPixel::gamma32(uint32_t x) {
+  uint8_t* y = (uint8_t*)&x;
+  for (uint8_t i = 0; i < 4; i++) {
+    y[i] = gamma8(y[i]);
+  }
+  return x;
+}
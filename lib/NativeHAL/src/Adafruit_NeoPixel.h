@@ -0,0 +1,64 @@
+/*
+ * ============================================================================
+ * Adafruit_NeoPixel.h（NativeHAL 版本）
+ * 與 Adafruit NeoPixel 相同的介面；show() 依 WS2812 時序推進虛擬時鐘
+ *
+ * 成本模型（與 AVR 版本相同）：
+ * - 每顆 LED 24 位元 × 1.25µs，傳送期間中斷關閉
+ * - 兩次 show() 之間至少間隔 300µs 的 latch 時間（不足時忙碌等待）
+ * ============================================================================
+ */
+
+#ifndef NATIVE_HAL_NEOPIXEL_H
+#define NATIVE_HAL_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_GRB    ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGB    ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+#define NEO_LATCH_US 300
+
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800);
+  ~Adafruit_NeoPixel();
+
+  void begin(void) { begun_ = true; }
+  void show(void);
+  bool canShow(void);
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+  void setPixelColor(uint16_t n, uint32_t c);
+  void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0);
+  void setBrightness(uint8_t b);
+  void clear(void);
+  uint8_t getBrightness(void) const { return brightness_ - 1; }
+  uint8_t* getPixels(void) const { return pixels_; }
+  uint16_t numPixels(void) const { return numLEDs_; }
+  uint32_t getPixelColor(uint16_t n) const;
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+  static uint32_t ColorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255);
+  static uint8_t gamma8(uint8_t x);
+  static uint32_t gamma32(uint32_t x);
+
+  // ===== 模擬統計 =====
+  uint32_t showCount() const { return showCount_; }          // show() 呼叫次數
+  uint64_t irqOffCycles() const { return irqOffCycles_; }    // 累計中斷關閉週期
+  uint32_t lastFrame(uint16_t n) const;                      // 最後一次送出的 LED 顏色
+
+private:
+  uint16_t numLEDs_;
+  uint8_t brightness_;
+  uint8_t* pixels_;
+  uint8_t* sent_;
+  bool begun_;
+  uint64_t lastShowEnd_;
+  uint32_t showCount_;
+  uint64_t irqOffCycles_;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * ============================================================================
+ * Adafruit_SPITFT.h（NativeHAL 版本）
+ * SPI TFT 共用層：畫面緩衝區 + SPI 傳輸成本模型
+ *
+ * 成本模型：
+ * - 每次設定位址視窗（CASET + RASET + RAMWR）傳送 11 位元組
+ * - 每個像素傳送 2 位元組（RGB565）
+ * - 軟體 SPI（五參數建構子）每位元組 64 週期（約 4µs）
+ * - 硬體 SPI（三參數建構子，8MHz）每位元組 20 週期（約 1.25µs，含迴圈開銷）
+ * 傳輸期間中斷維持開啟，因此長時間重繪時序列埠中斷仍會正常觸發
+ * ============================================================================
+ */
+
+#ifndef NATIVE_HAL_SPITFT_H
+#define NATIVE_HAL_SPITFT_H
+
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+#define HAL_TFT_MAX_DIM 160
+#define HAL_TFT_SWSPI_CYCLES_PER_BYTE 64
+#define HAL_TFT_HWSPI_CYCLES_PER_BYTE 20
+
+// TFT 傳輸統計
+struct HalTftStats {
+  uint32_t pixels;    // 寫入面板的像素數
+  uint32_t windows;   // 位址視窗設定次數
+  uint32_t writes;    // writeColor() 呼叫次數（同色連續像素段數）
+  uint32_t commands;  // 其他命令次數（初始化、旋轉等）
+  uint64_t bytes;     // SPI 傳輸位元組數
+  uint64_t cycles;    // 傳輸耗用的 CPU 週期
+};
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t cs, int8_t dc, int8_t mosi, int8_t sck, int8_t rst);
+  Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t cs, int8_t dc, int8_t rst);
+
+  void initSPI(uint32_t freq = 0, uint8_t spiMode = SPI_MODE0);
+  void setSPISpeed(uint32_t freq) { (void)freq; }
+  void sendCommand(uint8_t commandByte, const uint8_t* dataBytes = NULL, uint8_t numDataBytes = 0);
+
+  virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void writeColor(uint16_t color, uint32_t len);
+  void writePixels(uint16_t* colors, uint32_t len, bool block = true, bool bigEndian = false);
+  void pushColor(uint16_t color) { writeColor(color, 1); }
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color);
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+
+  // ===== 模擬介面 =====
+  const HalTftStats& halStats() const { return stats_; }
+  void halResetStats() { stats_ = HalTftStats(); }
+  bool halSoftwareSpi() const { return swSpi_; }
+  uint16_t halPixel(int16_t x, int16_t y) const;   // 讀取畫面緩衝區（邏輯座標）
+  bool halSavePpm(const char* path) const;         // 輸出目前畫面（PPM 格式）
+
+protected:
+  void busTransfer(uint32_t nbytes);
+
+  int8_t _cs, _dc, _rst;
+  bool swSpi_;
+  HalTftStats stats_;
+  uint16_t winX_, winY_, winW_, winH_;   // 目前位址視窗
+  uint32_t winPos_;                      // 視窗內寫入位置
+  uint16_t fb_[HAL_TFT_MAX_DIM * HAL_TFT_MAX_DIM];
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * Adafruit_ST7735.cpp（NativeHAL 版本）
+ * Adafruit_SPITFT / Adafruit_ST77xx / Adafruit_ST7735 模擬實作
+ */
+
+#include <Adafruit_ST7735.h>
+#include <HalSim.h>
+#include <stdio.h>
+
+SPIClass SPI;
+
+// ========== Adafruit_SPITFT ==========
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t cs, int8_t dc, int8_t mosi,
+                                 int8_t sck, int8_t rst)
+    : Adafruit_GFX(w, h), _cs(cs), _dc(dc), _rst(rst), swSpi_(true), stats_(),
+      winX_(0), winY_(0), winW_(0), winH_(0), winPos_(0) {
+  (void)mosi;
+  (void)sck;
+  memset(fb_, 0, sizeof(fb_));
+}
+
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t cs, int8_t dc, int8_t rst)
+    : Adafruit_GFX(w, h), _cs(cs), _dc(dc), _rst(rst), swSpi_(false), stats_(),
+      winX_(0), winY_(0), winW_(0), winH_(0), winPos_(0) {
+  memset(fb_, 0, sizeof(fb_));
+}
+
+void Adafruit_SPITFT::busTransfer(uint32_t nbytes) {
+  uint64_t c = (uint64_t)nbytes *
+               (swSpi_ ? HAL_TFT_SWSPI_CYCLES_PER_BYTE : HAL_TFT_HWSPI_CYCLES_PER_BYTE);
+  stats_.bytes += nbytes;
+  stats_.cycles += c;
+  HalSim::advanceCycles(c);
+}
+
+void Adafruit_SPITFT::initSPI(uint32_t freq, uint8_t spiMode) {
+  (void)freq;
+  (void)spiMode;
+  if (_cs >= 0) {
+    pinMode(_cs, OUTPUT);
+    digitalWrite(_cs, HIGH);
+  }
+  pinMode(_dc, OUTPUT);
+  if (_rst >= 0) {
+    // 與原函式庫相同的硬體重置時序
+    pinMode(_rst, OUTPUT);
+    digitalWrite(_rst, HIGH);
+    delay(100);
+    digitalWrite(_rst, LOW);
+    delay(100);
+    digitalWrite(_rst, HIGH);
+    delay(200);
+  }
+}
+
+void Adafruit_SPITFT::sendCommand(uint8_t commandByte, const uint8_t* dataBytes, uint8_t numDataBytes) {
+  (void)commandByte;
+  (void)dataBytes;
+  stats_.commands++;
+  busTransfer(1 + numDataBytes);
+}
+
+void Adafruit_SPITFT::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  winX_ = x;
+  winY_ = y;
+  winW_ = w;
+  winH_ = h;
+  winPos_ = 0;
+  stats_.windows++;
+  busTransfer(11);  // CASET(1+4) + RASET(1+4) + RAMWR(1)
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
+  uint32_t area = (uint32_t)winW_ * winH_;
+  for (uint32_t i = 0; i < len; i++) {
+    if (area != 0) {
+      uint32_t pos = winPos_ % area;
+      int16_t px = winX_ + pos % winW_;
+      int16_t py = winY_ + pos / winW_;
+      if (px < HAL_TFT_MAX_DIM && py < HAL_TFT_MAX_DIM) {
+        fb_[py * HAL_TFT_MAX_DIM + px] = color;
+      }
+    }
+    winPos_++;
+  }
+  stats_.pixels += len;
+  stats_.writes++;
+  busTransfer(len * 2);
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t* colors, uint32_t len, bool block, bool bigEndian) {
+  (void)block;
+  (void)bigEndian;
+  for (uint32_t i = 0; i < len; i++) {
+    writeColor(colors[i], 1);
+  }
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height)) {
+    setAddrWindow(x, y, 1, 1);
+    writeColor(color, 1);
+  }
+}
+
+void Adafruit_SPITFT::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width) { w = _width - x; }
+  if (y + h > _height) { h = _height - y; }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_SPITFT::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+uint16_t Adafruit_SPITFT::halPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= HAL_TFT_MAX_DIM || y >= HAL_TFT_MAX_DIM) {
+    return 0;
+  }
+  return fb_[y * HAL_TFT_MAX_DIM + x];
+}
+
+bool Adafruit_SPITFT::halSavePpm(const char* path) const {
+  FILE* f = fopen(path, "wb");
+  if (!f) {
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", _width, _height);
+  for (int16_t y = 0; y < _height; y++) {
+    for (int16_t x = 0; x < _width; x++) {
+      uint16_t c = halPixel(x, y);
+      uint8_t rgb[3] = {(uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC), (uint8_t)(c << 3)};
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// ========== Adafruit_ST77xx ==========
+void Adafruit_ST77xx::displayInit(const uint8_t* addr) {
+  uint8_t numCommands = pgm_read_byte(addr++);
+  while (numCommands--) {
+    uint8_t cmd = pgm_read_byte(addr++);
+    uint8_t numArgs = pgm_read_byte(addr++);
+    uint16_t ms = numArgs & ST_CMD_DELAY;
+    numArgs &= ~ST_CMD_DELAY;
+    sendCommand(cmd, addr, numArgs);
+    addr += numArgs;
+    if (ms) {
+      ms = pgm_read_byte(addr++);
+      if (ms == 255) {
+        ms = 500;
+      }
+      delay(ms);
+    }
+  }
+}
+
+void Adafruit_ST77xx::commonInit(const uint8_t* cmdList) {
+  begin();
+  if (cmdList) {
+    displayInit(cmdList);
+  }
+}
+
+// ========== Adafruit_ST7735 ==========
+// 與原函式庫 Rcmd1 + Rcmd2red + Rcmd3 相同的命令數與延遲時間
+static const uint8_t PROGMEM halRcmd[] = {
+  21,
+  ST77XX_SWRESET, ST_CMD_DELAY, 150,
+  ST77XX_SLPOUT, ST_CMD_DELAY, 255,
+  ST7735_FRMCTR1, 3, 0x01, 0x2C, 0x2D,
+  ST7735_FRMCTR2, 3, 0x01, 0x2C, 0x2D,
+  ST7735_FRMCTR3, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D,
+  ST7735_INVCTR, 1, 0x07,
+  ST7735_PWCTR1, 3, 0xA2, 0x02, 0x84,
+  ST7735_PWCTR2, 1, 0xC5,
+  ST7735_PWCTR3, 2, 0x0A, 0x00,
+  ST7735_PWCTR4, 2, 0x8A, 0x2A,
+  ST7735_PWCTR5, 2, 0x8A, 0xEE,
+  ST7735_VMCTR1, 1, 0x0E,
+  ST77XX_INVOFF, 0,
+  ST77XX_MADCTL, 1, 0xC8,
+  ST77XX_COLMOD, 1, 0x05,
+  ST77XX_CASET, 4, 0x00, 0x00, 0x00, 0x7F,
+  ST77XX_RASET, 4, 0x00, 0x00, 0x00, 0x9F,
+  ST7735_GMCTRP1, 16, 0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d,
+                      0x29, 0x25, 0x2B, 0x39, 0x00, 0x01, 0x03, 0x10,
+  ST7735_GMCTRN1, 16, 0x03, 0x1d, 0x07, 0x06, 0x2E, 0x2C, 0x29, 0x2D,
+                      0x2E, 0x2E, 0x37, 0x3F, 0x00, 0x00, 0x02, 0x10,
+  ST77XX_NORON, ST_CMD_DELAY, 10,
+  ST77XX_DISPON, ST_CMD_DELAY, 100,
+};
+
+void Adafruit_ST7735::initR(uint8_t options) {
+  commonInit(halRcmd);
+  tabcolor = options;
+  if (options == INITR_BLACKTAB) {
+    uint8_t madctl = 0xC0;
+    sendCommand(ST77XX_MADCTL, &madctl, 1);
+  }
+  setRotation(0);
+}
+
+void Adafruit_ST7735::setRotation(uint8_t m) {
+  Adafruit_GFX::setRotation(m);
+  uint8_t madctl = 0;
+  sendCommand(ST77XX_MADCTL, &madctl, 1);
+}
@@ -0,0 +1,52 @@
+/*
+ * Adafruit_ST7735.h（NativeHAL 版本）
+ * initR() 依原函式庫的初始化命令表延遲時間推進虛擬時鐘
+ */
+
+#ifndef NATIVE_HAL_ST7735_H
+#define NATIVE_HAL_ST7735_H
+
+#include <Adafruit_ST77xx.h>
+
+#define INITR_GREENTAB   0x00
+#define INITR_REDTAB     0x01
+#define INITR_BLACKTAB   0x02
+#define INITR_18GREENTAB INITR_GREENTAB
+#define INITR_18REDTAB   INITR_REDTAB
+#define INITR_18BLACKTAB INITR_BLACKTAB
+#define INITR_144GREENTAB 0x01
+#define INITR_MINI160x80 0x04
+#define INITR_HALLOWING  0x05
+
+#define ST7735_TFTWIDTH_128  128
+#define ST7735_TFTHEIGHT_160 160
+
+#define ST7735_FRMCTR1 0xB1
+#define ST7735_FRMCTR2 0xB2
+#define ST7735_FRMCTR3 0xB3
+#define ST7735_INVCTR  0xB4
+#define ST7735_PWCTR1  0xC0
+#define ST7735_PWCTR2  0xC1
+#define ST7735_PWCTR3  0xC2
+#define ST7735_PWCTR4  0xC3
+#define ST7735_PWCTR5  0xC4
+#define ST7735_VMCTR1  0xC5
+#define ST7735_GMCTRP1 0xE0
+#define ST7735_GMCTRN1 0xE1
+
+class Adafruit_ST7735 : public Adafruit_ST77xx {
+public:
+  Adafruit_ST7735(int8_t CS, int8_t RS, int8_t SID, int8_t SCLK, int8_t RST = -1)
+      : Adafruit_ST77xx(ST7735_TFTWIDTH_128, ST7735_TFTHEIGHT_160, CS, RS, SID, SCLK, RST), tabcolor(0) {}
+  Adafruit_ST7735(int8_t CS, int8_t RS, int8_t RST = -1)
+      : Adafruit_ST77xx(ST7735_TFTWIDTH_128, ST7735_TFTHEIGHT_160, CS, RS, RST), tabcolor(0) {}
+
+  void initB(void) { initR(INITR_BLACKTAB); }
+  void initR(uint8_t options = INITR_GREENTAB);
+  void setRotation(uint8_t m);
+
+protected:
+  uint8_t tabcolor;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Adafruit_ST77xx.h（NativeHAL 版本）
+ */
+
+#ifndef NATIVE_HAL_ST77XX_H
+#define NATIVE_HAL_ST77XX_H
+
+#include <Adafruit_SPITFT.h>
+
+#define ST_CMD_DELAY 0x80
+
+#define ST77XX_NOP     0x00
+#define ST77XX_SWRESET 0x01
+#define ST77XX_SLPIN   0x10
+#define ST77XX_SLPOUT  0x11
+#define ST77XX_NORON   0x13
+#define ST77XX_INVOFF  0x20
+#define ST77XX_INVON   0x21
+#define ST77XX_DISPOFF 0x28
+#define ST77XX_DISPON  0x29
+#define ST77XX_CASET   0x2A
+#define ST77XX_RASET   0x2B
+#define ST77XX_RAMWR   0x2C
+#define ST77XX_COLMOD  0x3A
+#define ST77XX_MADCTL  0x36
+
+#define ST77XX_MADCTL_MY  0x80
+#define ST77XX_MADCTL_MX  0x40
+#define ST77XX_MADCTL_MV  0x20
+#define ST77XX_MADCTL_ML  0x10
+#define ST77XX_MADCTL_RGB 0x00
+
+#define ST77XX_BLACK   0x0000
+#define ST77XX_WHITE   0xFFFF
+#define ST77XX_RED     0xF800
+#define ST77XX_GREEN   0x07E0
+#define ST77XX_BLUE    0x001F
+#define ST77XX_CYAN    0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW  0xFFE0
+#define ST77XX_ORANGE  0xFC00
+
+class Adafruit_ST77xx : public Adafruit_SPITFT {
+public:
+  Adafruit_ST77xx(uint16_t w, uint16_t h, int8_t CS, int8_t RS, int8_t SID, int8_t SCLK, int8_t RST = -1)
+      : Adafruit_SPITFT(w, h, CS, RS, SID, SCLK, RST), _colstart(0), _rowstart(0) {}
+  Adafruit_ST77xx(uint16_t w, uint16_t h, int8_t CS, int8_t RS, int8_t RST = -1)
+      : Adafruit_SPITFT(w, h, CS, RS, RST), _colstart(0), _rowstart(0) {}
+
+  void enableDisplay(bool enable) { sendCommand(enable ? ST77XX_DISPON : ST77XX_DISPOFF); }
+  void enableSleep(bool enable) { sendCommand(enable ? ST77XX_SLPIN : ST77XX_SLPOUT); }
+
+protected:
+  void begin(uint32_t freq = 0) { initSPI(freq); }
+  void commonInit(const uint8_t* cmdList);
+  void displayInit(const uint8_t* addr);
+  void setColRowStart(int8_t col, int8_t row) { _colstart = col; _rowstart = row; }
+
+  uint8_t _colstart, _rowstart;
+};
+
+#endif
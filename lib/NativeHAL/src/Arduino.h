@@ -0,0 +1,175 @@
+/*
+ * ============================================================================
+ * Arduino.h（NativeHAL 版本）
+ * 在 Linux 上模擬 Arduino UNO 核心 API，讓 src/ 內的韌體邏輯可直接編譯執行
+ *
+ * 模擬範圍：
+ * 1. 時間：millis() / micros() / delay() 使用虛擬時鐘（16MHz 週期計數）
+ * 2. GPIO：pinMode / digitalRead / digitalWrite / analogWrite
+ * 3. 中斷：cli() / sei() / ISR() 與 SREG 的 I 旗標
+ * 4. 暫存器：USART0、Timer1、EEPROM、PINB/PINC/PIND 與 PCINT1（由 HalSim 依虛擬時間觸發中斷）
+ * 5. PROGMEM：pgm_read_* 與 F() 在主機上直接讀取一般記憶體
+ *
+ * 模擬控制介面（注入序列資料、按鍵、推進時間）請見 HalSim.h
+ * ============================================================================
+ */
+
+#ifndef NATIVE_HAL_ARDUINO_H
+#define NATIVE_HAL_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include <avr/pgmspace.h>
+#include "Print.h"
+#include "WString.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// ===== 腳位與電位 =====
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define LED_BUILTIN 13
+#define NUM_DIGITAL_PINS 20
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+// ===== 時間 =====
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ===== GPIO =====
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+// ===== 數學輔助 =====
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ===== 中斷 =====
+// SREG 只模擬 I 旗標（bit 7）；ISR 由 HalSim 在虛擬時間推進時呼叫
+extern volatile uint8_t SREG;
+#define SREG_I 7
+void cli(void);
+void sei(void);
+#define noInterrupts() cli()
+#define interrupts()   sei()
+
+#define ISR(vector, ...) extern "C" void vector(void); extern "C" void vector(void)
+
+// 中斷向量名稱（對應 ATmega328P 的 vector 名稱）
+#define USART_RX_vect    hal_isr_usart_rx
+#define USART_UDRE_vect  hal_isr_usart_udre
+#define TIMER1_OVF_vect  hal_isr_timer1_ovf
+#define TIMER1_COMPA_vect hal_isr_timer1_compa
+#define PCINT1_vect      hal_isr_pcint1
+#define EE_READY_vect    hal_isr_ee_ready
+
+// ===== USART0 暫存器 =====
+// UCSR0A 讀取時 UDRE0 永遠為 1（傳送端立即完成）；UDR0 寫入即送到模擬輸出
+struct HalUcsr0a {
+  volatile uint8_t flags;
+  operator uint8_t() const;
+  HalUcsr0a& operator=(uint8_t v) { flags = v; return *this; }
+};
+struct HalUdr0 {
+  volatile uint8_t rx;
+  operator uint8_t() const { return rx; }
+  HalUdr0& operator=(uint8_t c);
+};
+extern HalUcsr0a UCSR0A;
+extern HalUdr0 UDR0;
+extern volatile uint8_t UCSR0B, UCSR0C, UBRR0H, UBRR0L;
+
+#define RXC0  7
+#define TXC0  6
+#define UDRE0 5
+#define FE0   4
+#define DOR0  3
+#define UPE0  2
+#define U2X0  1
+#define RXCIE0 7
+#define TXCIE0 6
+#define UDRIE0 5
+#define RXEN0  4
+#define TXEN0  3
+#define UCSZ01 2
+#define UCSZ00 1
+
+// ===== Timer1 暫存器 =====
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A;
+
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define TOIE1 0
+#define OCIE1A 1
+#define OCF1A 1
+
+// ===== EEPROM 暫存器 =====
+// 寫入 EEMPE 後再寫入 EEPE 開始燒寫（EEAR / EEDR），燒寫期間讀取 EECR 的 EEPE 為 1；
+// 寫入 EERE 立即將 EEAR 的內容讀到 EEDR。EERIE 為 1 且未在燒寫時持續觸發 EE_READY_vect
+struct HalEecr {
+  volatile uint8_t bits;
+  operator uint8_t() const;
+  HalEecr& operator=(uint8_t v);
+  HalEecr& operator|=(uint8_t v) { return *this = (uint8_t)(bits | v); }
+  HalEecr& operator&=(uint8_t v) { return *this = (uint8_t)(bits & v); }
+};
+extern HalEecr EECR;
+extern volatile uint16_t EEAR;
+extern volatile uint8_t EEDR;
+
+#define EERE  0
+#define EEPE  1
+#define EEMPE 2
+#define EERIE 3
+
+// ===== GPIO 輸入暫存器（由 HalSim 依腳位狀態更新）=====
+extern volatile uint8_t PINB, PINC, PIND;
+
+// ===== 腳位變化中斷（只模擬 PORTC / PCINT1）=====
+// PCICR 的 PCIE1 為 1 時，PCMSK1 選取的 PORTC 腳位電位改變即觸發 PCINT1_vect
+extern volatile uint8_t PCICR, PCIFR, PCMSK1;
+
+#define PCIE1  1
+#define PCIF1  1
+#define PCINT8  0
+#define PCINT9  1
+#define PCINT10 2
+#define PCINT11 3
+#define PCINT12 4
+#define PCINT13 5
+
+#endif
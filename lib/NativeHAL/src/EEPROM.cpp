@@ -0,0 +1,14 @@
+/*
+ * EEPROM.cpp（NativeHAL 版本）
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <HalSim.h>
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::write(int idx, uint8_t val) {
+  program(idx, val);
+  HalSim::advanceMicros(EEPROM_WRITE_US);  // 與 AVR 相同：等待寫入完成
+}
@@ -0,0 +1,73 @@
+/*
+ * ============================================================================
+ * EEPROM.h（NativeHAL 版本）
+ * 模擬 ATmega328P 的 1KB EEPROM
+ *
+ * - 初始內容為 0xFF（與出廠晶片相同）
+ * - write() 依資料手冊推進虛擬時鐘 3.3ms（與 AVR 版本相同為忙碌等待）
+ * - 也可直接操作 EECR / EEAR / EEDR 暫存器非同步燒寫（見 Arduino.h），
+ *   燒寫期間不推進時鐘，3.3ms 後觸發 EE_READY_vect
+ * - 記錄每個位元組的寫入次數，用於評估寫入耗損
+ * ============================================================================
+ */
+
+#ifndef NATIVE_HAL_EEPROM_H
+#define NATIVE_HAL_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define E2END 0x3FF
+#define EEPROM_WRITE_US 3300   // 單一位元組寫入時間（微秒）
+
+class EEPROMClass {
+public:
+  EEPROMClass() { clear(); }
+
+  uint8_t read(int idx) const { return data_[idx & E2END]; }
+  void write(int idx, uint8_t val);
+  void update(int idx, uint8_t val) {
+    if (read(idx) != val) {
+      write(idx, val);
+    }
+  }
+  uint16_t length() const { return E2END + 1; }
+
+  template <typename T> T& get(int idx, T& t) const {
+    for (size_t i = 0; i < sizeof(T); i++) {
+      ((uint8_t*)&t)[i] = read(idx + i);
+    }
+    return t;
+  }
+  template <typename T> const T& put(int idx, const T& t) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+      update(idx + i, ((const uint8_t*)&t)[i]);
+    }
+    return t;
+  }
+
+  // ===== 模擬用介面 =====
+  void program(int idx, uint8_t val) {  // 燒寫一個位元組（不推進時鐘，暫存器燒寫使用）
+    idx &= E2END;
+    data_[idx] = val;
+    wear_[idx]++;
+    writes_++;
+  }
+  void clear() {
+    memset(data_, 0xFF, sizeof(data_));
+    memset(wear_, 0, sizeof(wear_));
+    writes_ = 0;
+  }
+  uint8_t* image() { return data_; }                 // 直接存取內容（預載或檢查）
+  uint32_t wear(int idx) const { return wear_[idx & E2END]; }  // 單一位元組寫入次數
+  uint32_t totalWrites() const { return writes_; }   // 全部寫入次數
+
+private:
+  uint8_t data_[E2END + 1];
+  uint32_t wear_[E2END + 1];
+  uint32_t writes_;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * FreeMono24pt7b.h（NativeHAL 版本）
+ * 模擬環境不繪製自訂字型，只提供空的字型物件讓程式可以編譯
+ */
+
+#ifndef NATIVE_HAL_FREEMONO24PT7B_H
+#define NATIVE_HAL_FREEMONO24PT7B_H
+
+#include <Adafruit_GFX.h>
+
+const GFXfont FreeMono24pt7b = {NULL, NULL, 0x20, 0x7E, 24};
+
+#endif
@@ -0,0 +1,543 @@
+/*
+ * ============================================================================
+ * HalSim.cpp
+ * NativeHAL 核心：虛擬時鐘、中斷派送、USART0 / Timer1 / GPIO 模擬
+ * ============================================================================
+ */
+
+#include <Arduino.h>
+#include <HalSim.h>
+#include <EEPROM.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <deque>
+
+// ========== 預設（空）中斷向量 ==========
+// 韌體若以 ISR() 定義同名函式，連結器會使用韌體版本
+extern "C" {
+__attribute__((weak)) void hal_isr_usart_rx(void) {}
+__attribute__((weak)) void hal_isr_usart_udre(void) {}
+__attribute__((weak)) void hal_isr_timer1_ovf(void) {}
+__attribute__((weak)) void hal_isr_timer1_compa(void) {}
+__attribute__((weak)) void hal_isr_pcint1(void) {}
+__attribute__((weak)) void hal_isr_ee_ready(void) {}
+}
+
+// ========== 模擬暫存器 ==========
+volatile uint8_t SREG = 0;
+HalUcsr0a UCSR0A = {0};
+HalUdr0 UDR0 = {0};
+volatile uint8_t UCSR0B, UCSR0C, UBRR0H, UBRR0L;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A;
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t PCICR, PCIFR, PCMSK1;
+HalEecr EECR = {0};
+volatile uint16_t EEAR;
+volatile uint8_t EEDR;
+
+// ========== 內部狀態 ==========
+namespace {
+
+struct RxByte {
+  uint64_t at;   // 到達時間（週期）
+  uint8_t c;
+};
+
+uint64_t now = 0;
+bool inIsr = false;
+
+// USART0
+std::deque<RxByte> rxQueue;      // 尚未到達的位元組
+uint64_t rxLastArrival = 0;
+uint8_t rxFifo[2];               // 硬體接收 FIFO（中斷關閉時暫存）
+uint8_t rxFifoCount = 0;
+bool rxDorPending = false;
+std::string txOutput;
+void (*txHook)(uint8_t) = NULL;
+uint32_t lineBaud = 0;           // PC 端線路鮑率覆寫（0 = 依 UBRR0）
+
+// Timer1
+uint32_t t1Residual = 0;         // 不足一個計數的預分頻週期
+uint64_t t1LastEvent = 0;        // 最後一次溢位 / 比較匹配的時間（週期）
+bool t1OvfPending = false;
+bool t1CompaPending = false;
+
+// EEPROM
+uint64_t eeBusyUntil = 0;        // 暫存器燒寫完成時間（週期）
+
+// 睡眠
+#define TIMER0_OVF_CYCLES 16384  // Arduino 核心的 Timer0（millis）溢位週期：預分頻 64 × 256
+uint64_t sleptTotal = 0;         // sleep_cpu() 累計睡眠週期
+
+// GPIO
+uint8_t pinModes[NUM_DIGITAL_PINS];
+uint8_t pinOut[NUM_DIGITAL_PINS];
+uint8_t pinIn[NUM_DIGITAL_PINS];
+int pinPwmValue[NUM_DIGITAL_PINS];
+
+HalSim::IsrStats stats;
+unsigned long randState = 1;
+
+bool interruptsEnabled() {
+  return (SREG & (1 << SREG_I)) && !inIsr;
+}
+
+void runIsr(void (*vector)(void)) {
+  uint8_t saved = SREG;
+  inIsr = true;
+  SREG &= ~(1 << SREG_I);
+  vector();
+  inIsr = false;
+  SREG = saved;
+}
+
+uint32_t timer1Prescaler() {
+  static const uint16_t table[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  return table[TCCR1B & 0x07];
+}
+
+bool timer1Ctc() {
+  return (TCCR1B & (1 << WGM12)) != 0;
+}
+
+// 距離下一個 Timer1 事件（溢位或比較匹配歸零）還有多少週期；0 表示計時器停止
+uint64_t timer1CyclesToEvent() {
+  uint32_t p = timer1Prescaler();
+  if (p == 0) {
+    return 0;
+  }
+  uint32_t top = timer1Ctc() ? OCR1A : 0xFFFF;
+  uint32_t ticks = (TCNT1 <= top) ? (top - TCNT1 + 1) : (0x10000 - TCNT1);
+  return (uint64_t)ticks * p - t1Residual;
+}
+
+void timer1Count(uint64_t n) {
+  uint32_t p = timer1Prescaler();
+  if (p == 0) {
+    return;
+  }
+  uint64_t total = n + t1Residual;
+  TCNT1 = (uint16_t)(TCNT1 + total / p);
+  t1Residual = total % p;
+}
+
+bool eeBusy() {
+  return now < eeBusyUntil;
+}
+
+// EE_READY 為準位觸發：EERIE 為 1 且未在燒寫時持續觸發，直到 ISR 開始燒寫或關閉 EERIE
+void serviceEeReady() {
+  while ((EECR.bits & (1 << EERIE)) && !eeBusy() && interruptsEnabled()) {
+    stats.eeReady++;
+    runIsr(hal_isr_ee_ready);
+  }
+}
+
+void deliverRx(uint8_t c, uint8_t extraStatus) {
+  UDR0.rx = c;
+  uint8_t saved = UCSR0A.flags;
+  UCSR0A.flags = saved | extraStatus;
+  stats.usartRx++;
+  runIsr(hal_isr_usart_rx);
+  UCSR0A.flags = saved;
+}
+
+// 派送所有已擱置（中斷關閉期間發生）的中斷
+void servicePending() {
+  if (!interruptsEnabled()) {
+    return;
+  }
+  if (UCSR0B & (1 << RXCIE0)) {
+    for (uint8_t i = 0; i < rxFifoCount; i++) {
+      uint8_t status = 0;
+      if (i == rxFifoCount - 1 && rxDorPending) {
+        status = (1 << DOR0);
+        rxDorPending = false;
+      }
+      deliverRx(rxFifo[i], status);
+    }
+    rxFifoCount = 0;
+  }
+  if (t1OvfPending) {
+    t1OvfPending = false;
+    stats.timer1++;
+    runIsr(hal_isr_timer1_ovf);
+  }
+  if (t1CompaPending) {
+    t1CompaPending = false;
+    stats.timer1++;
+    runIsr(hal_isr_timer1_compa);
+  }
+  if ((PCIFR & (1 << PCIF1)) && (PCICR & (1 << PCIE1))) {
+    PCIFR &= ~(1 << PCIF1);
+    stats.pcint++;
+    runIsr(hal_isr_pcint1);
+  }
+  serviceEeReady();
+}
+
+// PORTC 腳位改變：設定 PCIF1，中斷開啟時立即派送（關閉期間多次變化只觸發一次，與硬體相同）
+void onPortCChange(uint8_t bit) {
+  if (!(PCMSK1 & (1 << bit))) {
+    return;
+  }
+  PCIFR |= (1 << PCIF1);
+  if (!(PCICR & (1 << PCIE1))) {
+    return;
+  }
+  if (interruptsEnabled()) {
+    PCIFR &= ~(1 << PCIF1);
+    stats.pcint++;
+    runIsr(hal_isr_pcint1);
+  } else {
+    stats.deferred++;
+  }
+}
+
+void onRxArrival(uint8_t c) {
+  if (!(UCSR0B & (1 << RXEN0))) {
+    return;  // 接收端未啟用，位元組直接遺失
+  }
+  if (interruptsEnabled() && (UCSR0B & (1 << RXCIE0)) && rxFifoCount == 0) {
+    deliverRx(c, 0);
+    return;
+  }
+  stats.deferred++;
+  if (rxFifoCount < sizeof(rxFifo)) {
+    rxFifo[rxFifoCount++] = c;
+  } else {
+    stats.rxLost++;
+    rxDorPending = true;
+  }
+}
+
+void onTimer1Event() {
+  bool ctc = timer1Ctc();
+  t1LastEvent = now;
+  TCNT1 = 0;
+  t1Residual = 0;
+  if (ctc) {
+    if (TIMSK1 & (1 << OCIE1A)) {
+      if (interruptsEnabled()) {
+        stats.timer1++;
+        runIsr(hal_isr_timer1_compa);
+      } else {
+        stats.deferred++;
+        t1CompaPending = true;
+      }
+    }
+  } else if (TIMSK1 & (1 << TOIE1)) {
+    if (interruptsEnabled()) {
+      stats.timer1++;
+      runIsr(hal_isr_timer1_ovf);
+    } else {
+      stats.deferred++;
+      t1OvfPending = true;
+    }
+  }
+}
+
+}  // namespace
+
+// ========== USART0 暫存器行為 ==========
+HalUcsr0a::operator uint8_t() const {
+  return flags | (1 << UDRE0);  // 傳送端永遠就緒
+}
+
+HalUdr0& HalUdr0::operator=(uint8_t c) {
+  txOutput.push_back((char)c);
+  if (txHook) {
+    txHook(c);
+  }
+  return *this;
+}
+
+// ========== EEPROM 暫存器行為 ==========
+HalEecr::operator uint8_t() const {
+  return eeBusy() ? (bits | (1 << EEPE)) : bits;
+}
+
+HalEecr& HalEecr::operator=(uint8_t v) {
+  if (v & (1 << EERE)) {
+    EEDR = EEPROM.read(EEAR);  // 讀取立即完成（燒寫期間的讀取由韌體自行避免）
+  }
+  if ((v & (1 << EEPE)) && (bits & (1 << EEMPE)) && !eeBusy()) {
+    EEPROM.program(EEAR, EEDR);
+    eeBusyUntil = now + (uint64_t)EEPROM_WRITE_US * (F_CPU / 1000000UL);
+  }
+  // EEMPE 只在下一次寫入 EEPE 時有效；EERE / EEPE 為觸發位元，不保留
+  bits = v & ((1 << EERIE) | ((v & (1 << EEPE)) ? 0 : (1 << EEMPE)));
+  serviceEeReady();  // 開啟 EERIE 時若未在燒寫，立即觸發
+  return *this;
+}
+
+// ========== 中斷控制 ==========
+void cli(void) {
+  SREG &= ~(1 << SREG_I);
+}
+
+void sei(void) {
+  SREG |= (1 << SREG_I);
+  servicePending();
+}
+
+// ========== 睡眠 ==========
+// SLEEP_MODE_IDLE：任何中斷都會喚醒；除了模擬的周邊，Arduino 核心的 Timer0 溢位每 1.024ms 也會喚醒一次
+void hal_sleep_cpu(void) {
+  if (!interruptsEnabled()) {
+    fprintf(stderr, "sim: sleep_cpu() with interrupts disabled never wakes\n");
+    return;
+  }
+  uint64_t wake = (now / TIMER0_OVF_CYCLES + 1) * TIMER0_OVF_CYCLES;
+  if (!rxQueue.empty() && rxQueue.front().at < wake) {
+    wake = rxQueue.front().at;
+  }
+  uint64_t t1 = timer1CyclesToEvent();
+  if (t1 != 0 && now + t1 < wake) {
+    wake = now + t1;
+  }
+  if ((EECR.bits & (1 << EERIE)) && eeBusy() && eeBusyUntil < wake) {
+    wake = eeBusyUntil;
+  }
+  sleptTotal += wake - now;
+  HalSim::advanceCycles(wake - now);
+}
+
+// ========== 時間 ==========
+unsigned long millis(void) {
+  return (unsigned long)(now / (F_CPU / 1000UL));
+}
+
+unsigned long micros(void) {
+  return (unsigned long)(now / (F_CPU / 1000000UL));
+}
+
+void delay(unsigned long ms) {
+  HalSim::advanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  HalSim::advanceMicros(us);
+}
+
+// ========== GPIO ==========
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  pinOut[pin] = val ? HIGH : LOW;
+  pinPwmValue[pin] = -1;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) return LOW;
+  if (pinModes[pin] == OUTPUT) {
+    return pinOut[pin];
+  }
+  return pinIn[pin];
+}
+
+void analogWrite(uint8_t pin, int val) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  pinPwmValue[pin] = val;
+  pinOut[pin] = val > 0 ? HIGH : LOW;
+}
+
+// ========== 數學輔助 ==========
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    randState = seed;
+  }
+}
+
+long random(long howbig) {
+  if (howbig == 0) {
+    return 0;
+  }
+  randState = randState * 1103515245UL + 12345UL;
+  return (long)((randState >> 16) % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) {
+    return howsmall;
+  }
+  return random(howbig - howsmall) + howsmall;
+}
+
+// ========== 模擬控制介面 ==========
+namespace HalSim {
+
+void reset() {
+  now = 0;
+  inIsr = false;
+  SREG = (1 << SREG_I);  // Arduino 核心在 setup() 前已開啟全域中斷
+  UCSR0A.flags = 0;
+  UDR0.rx = 0;
+  UCSR0B = UCSR0C = UBRR0H = UBRR0L = 0;
+  TCCR1A = TCCR1B = TIMSK1 = TIFR1 = 0;
+  TCNT1 = OCR1A = 0;
+  rxQueue.clear();
+  rxLastArrival = 0;
+  lineBaud = 0;
+  rxFifoCount = 0;
+  rxDorPending = false;
+  txOutput.clear();
+  t1Residual = 0;
+  t1OvfPending = t1CompaPending = false;
+  for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++) {
+    pinModes[i] = INPUT;
+    pinOut[i] = LOW;
+    pinIn[i] = HIGH;  // 按鍵未按下（上拉）
+    pinPwmValue[i] = -1;
+  }
+  PINB = PINC = PIND = 0xFF;
+  PCICR = PCIFR = PCMSK1 = 0;
+  EECR.bits = 0;
+  EEAR = 0;
+  EEDR = 0;
+  eeBusyUntil = 0;
+  sleptTotal = 0;
+  stats = IsrStats();
+}
+
+uint64_t cycles() {
+  return now;
+}
+
+void advanceCycles(uint64_t n) {
+  uint64_t target = now + n;
+  for (;;) {
+    // 找出下一個到期事件
+    uint64_t next = target;
+    int kind = 0;  // 0 = 無事件, 1 = USART 接收, 2 = Timer1, 3 = EEPROM 燒寫完成
+    if (!rxQueue.empty() && rxQueue.front().at <= next) {
+      next = rxQueue.front().at;
+      kind = 1;
+    }
+    uint64_t t1 = timer1CyclesToEvent();
+    if (t1 != 0 && now + t1 <= next) {
+      next = now + t1;
+      kind = 2;
+    }
+    if ((EECR.bits & (1 << EERIE)) && eeBusy() && eeBusyUntil <= next) {
+      next = eeBusyUntil;
+      kind = 3;
+    }
+
+    timer1Count(next - now);
+    now = next;
+
+    if (kind == 0) {
+      break;
+    } else if (kind == 1) {
+      uint8_t c = rxQueue.front().c;
+      rxQueue.pop_front();
+      onRxArrival(c);
+    } else if (kind == 2) {
+      onTimer1Event();
+    } else {
+      serviceEeReady();  // 中斷關閉時由 sei() 補派送
+    }
+  }
+}
+
+void advanceMicros(uint64_t us) {
+  advanceCycles(us * (F_CPU / 1000000UL));
+}
+
+void advanceMillis(uint64_t ms) {
+  advanceCycles(ms * (F_CPU / 1000UL));
+}
+
+uint32_t serialBaud() {
+  uint16_t ubrr = ((uint16_t)UBRR0H << 8) | UBRR0L;
+  if (ubrr == 0) {
+    return 9600;
+  }
+  uint32_t div = (UCSR0A.flags & (1 << U2X0)) ? 8 : 16;
+  return F_CPU / (div * (ubrr + 1UL));
+}
+
+void serialSend(const uint8_t* data, size_t len) {
+  uint64_t byteCycles = 10ULL * F_CPU / (lineBaud ? lineBaud : serialBaud());  // 8N1 = 10 位元
+  uint64_t at = rxLastArrival > now ? rxLastArrival : now;
+  for (size_t i = 0; i < len; i++) {
+    at += byteCycles;
+    rxQueue.push_back({at, data[i]});
+  }
+  rxLastArrival = at;
+}
+
+void setLineBaud(uint32_t baud) {
+  lineBaud = baud;
+}
+
+void serialSend(const char* text) {
+  serialSend((const uint8_t*)text, strlen(text));
+}
+
+size_t serialPending() {
+  return rxQueue.size();
+}
+
+std::string& serialOutput() {
+  return txOutput;
+}
+
+void setTxHook(void (*hook)(uint8_t c)) {
+  txHook = hook;
+}
+
+void setPinInput(uint8_t pin, bool level) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  pinIn[pin] = level ? HIGH : LOW;
+  volatile uint8_t* port = pin < 8 ? &PIND : (pin < 14 ? &PINB : &PINC);
+  uint8_t bit = pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14);
+  uint8_t before = *port;
+  if (level) {
+    *port |= (1 << bit);
+  } else {
+    *port &= ~(1 << bit);
+  }
+  if (port == &PINC && *port != before) {
+    onPortCChange(bit);
+  }
+}
+
+uint8_t pinOutput(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pinOut[pin] : LOW;
+}
+
+int pinPwm(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pinPwmValue[pin] : -1;
+}
+
+const IsrStats& isrStats() {
+  return stats;
+}
+
+uint64_t timer1LastEvent() {
+  return t1LastEvent;
+}
+
+uint64_t sleptCycles() {
+  return sleptTotal;
+}
+
+}  // namespace HalSim
+
+// 靜態初始化時重置一次，確保腳位預設為上拉（按鍵未按下）
+namespace {
+struct HalAutoReset {
+  HalAutoReset() { HalSim::reset(); }
+} halAutoReset;
+}
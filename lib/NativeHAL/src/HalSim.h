@@ -0,0 +1,68 @@
+/*
+ * ============================================================================
+ * HalSim.h
+ * NativeHAL 模擬控制介面（虛擬時鐘、中斷派送、序列埠與腳位注入）
+ *
+ * 時間模型：
+ * - 以 16MHz CPU 週期為單位的虛擬時鐘，只有在呼叫 advance*() 時才會前進
+ * - 周邊模擬（TFT 傳輸、WS2812 show、EEPROM 寫入、delay）會依成本模型推進時鐘
+ * - 時鐘前進時依序派送到期事件：USART 接收位元組、Timer1 溢位 / 比較匹配、EEPROM 燒寫完成；
+ *   setPinInput() 改變 PORTC 腳位時派送 PCINT1
+ * - sleep_cpu()（avr/sleep.h）直接將時鐘推進到下一個中斷，含 Timer0（millis）每 1.024ms 的溢位
+ * - 事件發生時若 SREG 的 I 旗標為 0，中斷延後到 sei() 時才執行（與硬體相同）
+ *
+ * USART 模型：
+ * - 接收：依 UBRR0 計算的鮑率逐位元組到達；硬體 FIFO 深度 2，
+ *         中斷被關閉期間超過 FIFO 容量的位元組會遺失並設定 DOR0
+ * - 傳送：寫入 UDR0 立即完成（不模擬傳送端鮑率），輸出可由 serialOutput() 取得
+ * ============================================================================
+ */
+
+#ifndef NATIVE_HAL_SIM_H
+#define NATIVE_HAL_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+namespace HalSim {
+
+// ===== 虛擬時鐘 =====
+void reset();                        // 重置所有模擬狀態（時鐘、腳位、暫存器、序列埠）
+uint64_t cycles();                   // 目前虛擬 CPU 週期數
+void advanceCycles(uint64_t n);      // 推進時鐘並派送到期中斷
+void advanceMicros(uint64_t us);
+void advanceMillis(uint64_t ms);
+
+// ===== 序列埠（USART0）=====
+void serialSend(const uint8_t* data, size_t len);  // 排入 PC→板子 的資料（依鮑率到達）
+void serialSend(const char* text);
+size_t serialPending();                             // 尚未到達的位元組數
+uint32_t serialBaud();                              // 依 UBRR0 計算的目前鮑率
+void setLineBaud(uint32_t baud);                    // 覆寫 PC 端送出速率（0 = 依 UBRR0，基準測試用）
+std::string& serialOutput();                        // 板子→PC 的所有輸出
+void setTxHook(void (*hook)(uint8_t c));            // 每送出一個位元組時呼叫（可為 NULL）
+
+// ===== 腳位 =====
+void setPinInput(uint8_t pin, bool level);  // 設定外部輸入電位（按鍵按下 = LOW）
+uint8_t pinOutput(uint8_t pin);             // 讀取 digitalWrite 輸出電位
+int pinPwm(uint8_t pin);                    // 讀取 analogWrite 輸出值（未使用為 -1）
+
+// ===== 中斷統計 =====
+struct IsrStats {
+  uint32_t usartRx;     // USART_RX_vect 執行次數
+  uint32_t timer1;      // Timer1 中斷執行次數
+  uint32_t eeReady;     // EE_READY_vect 執行次數
+  uint32_t pcint;       // PCINT1_vect 執行次數
+  uint32_t deferred;    // 因中斷關閉而延後派送的次數
+  uint32_t rxLost;      // 因硬體 FIFO 滿而遺失的接收位元組數
+};
+const IsrStats& isrStats();
+uint64_t timer1LastEvent();  // 最後一次 Timer1 溢位 / 比較匹配發生的虛擬時間（週期，不含中斷延後）
+
+// ===== 睡眠 =====
+uint64_t sleptCycles();      // sleep_cpu() 累計睡眠的週期數（其餘為 CPU 執行中）
+
+}  // namespace HalSim
+
+#endif
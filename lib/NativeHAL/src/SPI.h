@@ -0,0 +1,34 @@
+/*
+ * SPI.h（NativeHAL 版本）
+ * 只提供介面；傳輸成本由 Adafruit_SPITFT 模擬
+ */
+
+#ifndef NATIVE_HAL_SPI_H
+#define NATIVE_HAL_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE3 0x0C
+#define MSBFIRST 1
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
+    (void)clock; (void)bitOrder; (void)dataMode;
+  }
+};
+
+class SPIClass {
+public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) { return data; }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * WString.h（NativeHAL 版本）
+ * Arduino String 的最小子集（串接與轉換），僅供舊程式碼在主機上編譯
+ */
+
+#ifndef NATIVE_HAL_WSTRING_H
+#define NATIVE_HAL_WSTRING_H
+
+#include <string>
+
+class String {
+public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int n) : s_(std::to_string(n)) {}
+  explicit String(unsigned int n) : s_(std::to_string(n)) {}
+  explicit String(long n) : s_(std::to_string(n)) {}
+  explicit String(unsigned long n) : s_(std::to_string(n)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+
+  String& operator+=(const String& rhs) { s_ += rhs.s_; return *this; }
+  String& operator+=(const char* rhs) { s_ += rhs; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b) { return String(a.s_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s_); }
+
+  bool operator==(const char* rhs) const { return s_ == rhs; }
+
+private:
+  std::string s_;
+};
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * avr/pgmspace.h（NativeHAL 版本）
+ * 主機上沒有獨立的程式記憶體，PROGMEM 資料直接放在一般記憶體中讀取
+ */
+
+#ifndef NATIVE_HAL_PGMSPACE_H
+#define NATIVE_HAL_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)   (*(void* const*)(addr))
+
+#define strcmp_P(a, b)     strcmp((a), (b))
+#define strncmp_P(a, b, n) strncmp((a), (b), (n))
+#define strcpy_P(a, b)     strcpy((a), (b))
+#define strncpy_P(a, b, n) strncpy((a), (b), (n))
+#define strstr_P(a, b)     strstr((a), (b))
+#define strlen_P(a)        strlen(a)
+#define memcpy_P(a, b, n)  memcpy((a), (b), (n))
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * avr/power.h（NativeHAL 版本）
+ * 主機模擬不區分周邊電源，PRR 相關巨集不做任何事
+ */
+
+#ifndef NATIVE_HAL_POWER_H
+#define NATIVE_HAL_POWER_H
+
+#define power_adc_disable()
+#define power_twi_disable()
+#define power_timer2_disable()
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * avr/sleep.h（NativeHAL 版本）
+ * sleep_cpu() 將虛擬時鐘推進到下一個中斷（USART 接收、Timer1、EEPROM 燒寫完成、
+ * Timer0 溢位），期間的週期計入 HalSim::sleptCycles()
+ */
+
+#ifndef NATIVE_HAL_SLEEP_H
+#define NATIVE_HAL_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0
+
+#define set_sleep_mode(mode) ((void)(mode))
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu() hal_sleep_cpu()
+
+void hal_sleep_cpu(void);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * util/crc16.h（NativeHAL 版本）
+ * 與 avr-libc 相同的 CRC 更新函式（逐位元計算）
+ */
+
+#ifndef NATIVE_HAL_CRC16_H
+#define NATIVE_HAL_CRC16_H
+
+#include <stdint.h>
+
+// CRC-8，多項式 0x07（x^8 + x^2 + x + 1），初始值由呼叫端決定（通常為 0）
+static inline uint8_t _crc8_ccitt_update(uint8_t inCrc, uint8_t inData) {
+  uint8_t data = inCrc ^ inData;
+  for (uint8_t i = 0; i < 8; i++) {
+    data = (data & 0x80) ? (uint8_t)((data << 1) ^ 0x07) : (uint8_t)(data << 1);
+  }
+  return data;
+}
+
+// CRC-16，多項式 0xA001（反射的 0x8005，CRC-16/IBM），初始值由呼叫端決定
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t a) {
+  crc ^= a;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+  }
+  return crc;
+}
+
+#endif
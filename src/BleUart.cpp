@@ -0,0 +1,357 @@
+/*
+ * ============================================================================
+ * BleUart.cpp
+ * HC-05 藍牙序列埠驅動實作（USART0 RX / UDRE 中斷）
+ *
+ * 注意：本驅動自行接管 USART0 的中斷向量，因此程式中不可再使用 Arduino
+ *       的 Serial 物件（兩者會同時定義 USART_RX_vect 而造成連結錯誤）。
+ * ============================================================================
+ */
+
+#include <BleUart.h>
+
+BleUart bleSerial;
+
+// ========== 初始化 ==========
+/**
+ * @brief 設定 USART0 鮑率並啟用 RX 中斷
+ * @param baud 鮑率（HC-05 預設 9600）
+ */
+void BleUart::begin(unsigned long baud) {
+  rxHead = rxTail = 0;
+  txHead = txTail = 0;
+  txMuted = false;
+  framesIn = framesOut = 0;
+  rxState = RX_IDLE;
+  frameLen = 0;
+  lastRxMs = 0;
+  resetCounters();
+
+  setBaud(baud);
+  UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);               // 8N1
+  UCSR0B = (1 << RXEN0) | (1 << TXEN0) | (1 << RXCIE0);  // 啟用收發與 RX 中斷
+}
+
+// 使用 U2X 倍速模式計算鮑率（與 Arduino HardwareSerial 相同的計算方式）
+static uint16_t baudDivisor(unsigned long baud) {
+  return (F_CPU / 4 / baud - 1) / 2;
+}
+
+/**
+ * @brief 變更鮑率（不清除緩衝區與統計；呼叫前傳送端應已送完）
+ */
+void BleUart::setBaud(unsigned long baud) {
+  uint16_t ubrr = baudDivisor(baud);
+  UCSR0A = (1 << U2X0);
+  UBRR0H = ubrr >> 8;
+  UBRR0L = ubrr;
+}
+
+/**
+ * @brief 指定鮑率在目前 F_CPU 下的誤差（千分比，取絕對值）
+ *
+ * 16MHz 時 57600 為 8‰、115200 為 21‰；8MHz 時 115200 為 35‰
+ */
+uint16_t BleUart::baudErrorPermille(unsigned long baud) {
+  unsigned long actual = F_CPU / 8 / (baudDivisor(baud) + 1UL);
+  unsigned long diff = actual > baud ? actual - baud : baud - actual;
+  return (uint16_t)(diff * 1000UL / baud);
+}
+
+// ========== 傳送 ==========
+/**
+ * @brief 送出一個位元組（寫入 TX 環形緩衝區，由 UDRE 中斷送出）
+ *
+ * 緩衝區已滿時會等待空間（與 HardwareSerial 行為相同）；若目前中斷被關閉，
+ * 則直接輪詢 UDRE0 旗標代替中斷送出，避免死結。
+ */
+size_t BleUart::write(uint8_t c) {
+  if (txMuted) {
+    return 1;
+  }
+
+  // 快速路徑：緩衝區為空且傳送暫存器可用，直接寫入硬體
+  if (txHead == txTail && (UCSR0A & (1 << UDRE0))) {
+    UDR0 = c;
+    return 1;
+  }
+
+  uint8_t next = (txHead + 1) & (BLE_TX_RING_SIZE - 1);
+  while (next == txTail) {
+    if (!(SREG & (1 << SREG_I)) && (UCSR0A & (1 << UDRE0))) {
+      uint8_t out;
+      if (onTxReady(&out)) {
+        UDR0 = out;
+      }
+    }
+  }
+
+  txBuf[txHead] = c;
+  txHead = next;
+  UCSR0B |= (1 << UDRIE0);  // 啟用資料暫存器空中斷
+  return 1;
+}
+
+/**
+ * @brief 取出下一個待送位元組（由 UDRE 中斷呼叫）
+ * @return false 表示緩衝區已空
+ */
+bool BleUart::onTxReady(uint8_t* c) {
+  if (txHead == txTail) {
+    return false;
+  }
+  *c = txBuf[txTail];
+  txTail = (txTail + 1) & (BLE_TX_RING_SIZE - 1);
+  return true;
+}
+
+// ========== 接收（中斷端）==========
+uint8_t BleUart::rxFree() const {
+  return (BLE_RX_RING_SIZE - 1) - ((rxHead - rxTail) & (BLE_RX_RING_SIZE - 1));
+}
+
+void BleUart::pushRx(uint8_t c) {
+  rxBuf[rxHead] = c;
+  rxHead = (rxHead + 1) & (BLE_RX_RING_SIZE - 1);
+}
+
+/**
+ * @brief 接收一個位元組並進行分框（由 USART_RX_vect 呼叫）
+ * @param c      接收到的資料
+ * @param status 讀取 UDR0 前的 UCSR0A 狀態（錯誤旗標）
+ *
+ * 分框規則：
+ * - 文字框：'\r' / '\n' 為命令結尾，空白行直接忽略（不佔用緩衝區）
+ * - 二進位框：以 0xA5 開頭，依標頭的長度欄位判斷結尾
+ * - 新框開始時預留整框空間，保證後續結尾一定寫得進去
+ */
+void BleUart::onRxByte(uint8_t c, uint8_t status) {
+  bool eol = (c == '\r' || c == '\n');
+  unsigned long now = millis();
+
+  // 二進位框中斷（PC 端送到一半停止）：補 0 結束此框，目前位元組當作新框開頭
+  if ((rxState == RX_BIN_HDR || rxState == RX_BIN_BODY || rxState == RX_BIN_SKIP) &&
+      now - lastRxMs > BLE_BIN_TIMEOUT_MS) {
+    counters.rxBinTimeout++;
+    if (rxState == RX_BIN_HDR) {
+      pushRx(0);     // 標頭 0 = 長度 0，再補一個 CRC 位元組
+      pushRx(0xFF);  // CRC-8(0x00) = 0x00，補 0xFF 確保 CRC 檢查失敗
+      framesIn++;
+    } else if (rxState == RX_BIN_BODY) {
+      while (frameLen > 1) {
+        pushRx(0);
+        frameLen--;
+      }
+      pushRx(0xFF);
+      rxBuf[binHeader] &= 0x0F;  // opcode 0（保留）：補 0 後 CRC 仍可能恰好相符，以 opcode 確保 NAK
+      framesIn++;
+    }
+    rxState = RX_IDLE;
+  }
+  lastRxMs = now;
+
+  // 硬體錯誤：框錯誤 / 同位錯誤代表此位元組不可信，資料溢位代表前面已遺失資料
+  // （二進位框不另外標記，錯誤資料會在 CRC 檢查時被發現）
+  if (status & ((1 << FE0) | (1 << UPE0))) {
+    counters.rxFrameError++;
+    if (rxState == RX_TEXT) {
+      rxState = RX_DISCARD;
+    }
+    if (rxState != RX_BIN_HDR && rxState != RX_BIN_BODY) {
+      return;
+    }
+  }
+  if (status & (1 << DOR0)) {
+    counters.rxHwOverrun++;
+    if (rxState == RX_TEXT) {
+      rxState = RX_DISCARD;
+    }
+  }
+
+  switch (rxState) {
+    case RX_IDLE:
+      if (c == BLE_BIN_SYNC) {
+        if (rxFree() < BLE_BIN_FRAME_MAX) {
+          counters.rxRingFull++;
+          rxState = RX_BIN_SKIP;
+          frameLen = 0;  // 0 表示尚未收到標頭
+          return;
+        }
+        pushRx(c);
+        rxState = RX_BIN_HDR;
+        return;
+      }
+      if (eol) {
+        return;  // 忽略空白行（例如 "\r\n" 的第二個字元）
+      }
+      if (rxFree() < BLE_FRAME_MAX) {
+        counters.rxRingFull++;  // 空間不足，整框丟棄
+        rxState = RX_SKIP;
+        return;
+      }
+      if (c == BLE_FRAME_CANCEL) {
+        rxState = RX_DISCARD;  // 資料中的 CAN 會被主迴圈當成框尾：整框視為損壞
+        return;
+      }
+      pushRx(c);
+      frameLen = 1;
+      rxState = RX_TEXT;
+      break;
+
+    case RX_TEXT:
+      if (eol) {
+        pushRx(BLE_FRAME_END);
+        framesIn++;
+        rxState = RX_IDLE;
+      } else if (c == BLE_FRAME_CANCEL) {
+        rxState = RX_DISCARD;
+      } else if (frameLen >= BLE_FRAME_MAX - 1) {
+        counters.rxTooLong++;  // 命令過長，等待結尾後標記為損壞框
+        rxState = RX_DISCARD;
+      } else {
+        pushRx(c);
+        frameLen++;
+      }
+      break;
+
+    case RX_DISCARD:
+      if (eol) {
+        pushRx(BLE_FRAME_CANCEL);
+        framesIn++;
+        rxState = RX_IDLE;
+      }
+      break;
+
+    case RX_SKIP:
+      if (eol) {
+        rxState = RX_IDLE;
+      }
+      break;
+
+    case RX_BIN_HDR:
+      binHeader = rxHead;
+      pushRx(c);
+      frameLen = (c & 0x0F) + 1;  // 剩餘：payload + CRC
+      rxState = RX_BIN_BODY;
+      break;
+
+    case RX_BIN_BODY:
+      pushRx(c);
+      if (--frameLen == 0) {
+        framesIn++;
+        rxState = RX_IDLE;
+      }
+      break;
+
+    case RX_BIN_SKIP:
+      if (frameLen == 0) {
+        frameLen = (c & 0x0F) + 1;
+      } else if (--frameLen == 0) {
+        rxState = RX_IDLE;
+      }
+      break;
+  }
+}
+
+// ========== 接收（主迴圈端）==========
+uint8_t BleUart::framesReady() const {
+  return (uint8_t)(framesIn - framesOut);
+}
+
+/**
+ * @brief 從環形緩衝區取出一個完整命令框
+ * @param buf     目的緩衝區（至少 BLE_FRAME_MAX 位元組）
+ * @param bufSize 目的緩衝區大小
+ * @param len     輸出：命令長度（文字框不含結尾 '\0'；二進位框為標頭 + payload + CRC）
+ * @return 取框結果（NONE / TEXT / BINARY / DROPPED）
+ */
+BleFrameType BleUart::readFrame(char* buf, size_t bufSize, size_t* len) {
+  *len = 0;
+  if (framesReady() == 0) {
+    return BLE_FRAME_NONE;
+  }
+
+  uint8_t tail = rxTail;
+  size_t n = 0;
+  uint8_t c = rxBuf[tail];
+
+  // 二進位框：同步位元組後依標頭長度取出固定位元組數
+  if (c == BLE_BIN_SYNC) {
+    tail = (tail + 1) & (BLE_RX_RING_SIZE - 1);
+    uint8_t hdr = rxBuf[tail];
+    uint8_t total = 1 + (hdr & 0x0F) + 1;
+    for (uint8_t i = 0; i < total; i++) {
+      buf[n++] = (char)rxBuf[tail];
+      tail = (tail + 1) & (BLE_RX_RING_SIZE - 1);
+    }
+    rxTail = tail;
+    framesOut++;
+    counters.framesOk++;
+    *len = n;
+    return BLE_FRAME_BINARY;
+  }
+
+  for (;;) {
+    c = rxBuf[tail];
+    tail = (tail + 1) & (BLE_RX_RING_SIZE - 1);
+    if (c == BLE_FRAME_END || c == BLE_FRAME_CANCEL) {
+      break;
+    }
+    if (n < bufSize - 1) {
+      buf[n++] = (char)c;
+    }
+  }
+  buf[n] = '\0';
+
+  rxTail = tail;   // 釋放空間給 ISR
+  framesOut++;
+
+  if (c == BLE_FRAME_CANCEL) {
+    counters.framesDropped++;
+    return BLE_FRAME_DROPPED;
+  }
+  counters.framesOk++;
+  *len = n;
+  return BLE_FRAME_TEXT;
+}
+
+// ========== 統計計數器 ==========
+void BleUart::getCounters(BleRxCounters* out) {
+  cli();  // 計數器為 16 位元且由 ISR 修改，需在關閉中斷下複製
+  out->framesOk = counters.framesOk;
+  out->framesDropped = counters.framesDropped;
+  out->rxRingFull = counters.rxRingFull;
+  out->rxTooLong = counters.rxTooLong;
+  out->rxHwOverrun = counters.rxHwOverrun;
+  out->rxFrameError = counters.rxFrameError;
+  out->rxBinTimeout = counters.rxBinTimeout;
+  sei();
+}
+
+void BleUart::resetCounters() {
+  cli();
+  counters.framesOk = 0;
+  counters.framesDropped = 0;
+  counters.rxRingFull = 0;
+  counters.rxTooLong = 0;
+  counters.rxHwOverrun = 0;
+  counters.rxFrameError = 0;
+  counters.rxBinTimeout = 0;
+  sei();
+}
+
+// ========== USART0 中斷服務程式 ==========
+ISR(USART_RX_vect) {
+  uint8_t status = UCSR0A;  // 必須在讀取 UDR0 之前讀取錯誤旗標
+  uint8_t c = UDR0;
+  bleSerial.onRxByte(c, status);
+}
+
+ISR(USART_UDRE_vect) {
+  uint8_t c;
+  if (bleSerial.onTxReady(&c)) {
+    UDR0 = c;
+  } else {
+    UCSR0B &= ~(1 << UDRIE0);  // 緩衝區已空，關閉中斷
+  }
+}
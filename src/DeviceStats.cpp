@@ -0,0 +1,21 @@
+/*
+ * ============================================================================
+ * DeviceStats.cpp
+ * 裝置統計實作
+ * ============================================================================
+ */
+
+#include <DeviceStats.h>
+
+DeviceStats devStats;
+
+void DeviceStats::reset() {
+  since = millis();
+  loops = 0;
+  maxLoop = 0;
+  memset(hist, 0, sizeof(hist));
+  parseErrors = 0;
+  binFrames = 0;
+  binNaks = 0;
+  batches = 0;
+}
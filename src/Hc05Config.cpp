@@ -0,0 +1,262 @@
+/*
+ * ============================================================================
+ * Hc05Config.cpp
+ * HC-05 開機自動設定實作
+ * ============================================================================
+ */
+
+#include <Hc05Config.h>
+#include <BleUart.h>
+#include <avr/pgmspace.h>
+
+Hc05Config hc05;
+
+// 探測順序（由高到低）；前 HC05_TARGETS 個為 AT+UART 的目標鮑率
+static const uint32_t HC05_BAUDS[] PROGMEM = {115200, 57600, 38400, 9600};
+#define HC05_BAUD_COUNT (sizeof(HC05_BAUDS) / sizeof(HC05_BAUDS[0]))
+#define HC05_TARGETS 2
+
+static unsigned long baudAt(uint8_t i) {
+  return pgm_read_dword(&HC05_BAUDS[i]);
+}
+
+// AT+UART 參數："<鮑率>,0,0"（1 停止位元、無同位）
+static void formatUart(char* out, unsigned long baud) {
+  char digits[8];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + baud % 10;
+    baud /= 10;
+  } while (baud);
+  while (n) {
+    *out++ = digits[--n];
+  }
+  strcpy_P(out, PSTR(",0,0"));
+}
+
+// ========== 初始化 ==========
+/**
+ * @brief KEY 拉高並開始設定（bleSerial 已以 HC05_DEFAULT_BAUD 初始化）
+ * @param name      模組名稱（設定期間必須保持有效）
+ * @param savedBaud 上次 confirmed() 的鮑率（0 = 沒有記錄）：模組沒有任何回覆時使用
+ */
+void Hc05Config::begin(uint8_t pin, const char* moduleName, unsigned long savedBaud) {
+  keyPin = pin;
+  name = moduleName;
+  outcome = HC05_PENDING;
+  verifying = false;
+  linkConfirmed = false;
+  fallbackBaud = savedBaud ? savedBaud : HC05_DEFAULT_BAUD;
+  linkBaud = HC05_DEFAULT_BAUD;
+  pendingBaud = 0;
+  commands = 0;
+  writes = 0;
+
+  pinMode(keyPin, OUTPUT);
+  digitalWrite(keyPin, HIGH);
+  state = HC_SETTLE;
+  wait(HC05_KEY_SETTLE_MS);
+}
+
+void Hc05Config::wait(unsigned long ms) {
+  deadline = millis() + ms;
+}
+
+bool Hc05Config::ready() const {
+  return state != HC_DONE && (bleSerial.framesReady() > 0 || (long)(millis() - deadline) >= 0);
+}
+
+// ========== 命令 ==========
+/**
+ * @brief 送出 "AT<cmd><arg>\r\n" 並開始等待回覆
+ */
+void Hc05Config::command(PGM_P cmd, const char* arg) {
+  bleSerial.print(F("AT"));
+  bleSerial.print((const __FlashStringHelper*)cmd);
+  if (arg) {
+    bleSerial.print(arg);
+  }
+  bleSerial.print(F("\r\n"));
+  commands++;
+  valueMatched = false;
+  wait(HC05_REPLY_MS);
+}
+
+// 以 HC05_BAUDS[probeIndex] 送出 "AT"
+void Hc05Config::probe() {
+  linkBaud = baudAt(probeIndex);
+  bleSerial.setBaud(linkBaud);
+  state = HC_PROBE;
+  command(PSTR(""));
+}
+
+/**
+ * @brief 由高到低嘗試 AT+UART=<目標>（只嘗試 U2X 分頻誤差在 HC05_BAUD_ERROR_MAX 內的鮑率，
+ *        且不低於目前可用的鮑率）；沒有可嘗試的目標時維持目前鮑率
+ */
+void Hc05Config::setUart() {
+  for (; targetIndex < HC05_TARGETS; targetIndex++) {
+    unsigned long b = baudAt(targetIndex);
+    if (b < linkBaud) {
+      break;
+    }
+    if (BleUart::baudErrorPermille(b) <= HC05_BAUD_ERROR_MAX) {
+      char arg[12];
+      formatUart(arg, b);
+      pendingBaud = b;
+      state = HC_UART_SET;
+      command(PSTR("+UART="), arg);
+      return;
+    }
+  }
+  finish(HC05_FALLBACK, linkBaud);
+}
+
+void Hc05Config::nameQueried(bool ok) {
+  if (ok && valueMatched) {
+    state = HC_UART_QUERY;
+    command(PSTR("+UART?"));
+  } else {
+    state = HC_NAME_SET;
+    command(PSTR("+NAME="), name);
+  }
+}
+
+/**
+ * @brief KEY 拉低回到資料模式並以指定鮑率繼續（之後由一般命令處理接手）
+ */
+void Hc05Config::finish(Hc05Result r, unsigned long baud) {
+  digitalWrite(keyPin, LOW);
+  linkBaud = baud;
+  bleSerial.setBaud(baud);
+  outcome = r;
+  state = HC_DONE;
+}
+
+// ========== 回覆處理 ==========
+/**
+ * @brief 處理一行回覆；錯誤鮑率下的雜訊只要不含 OK / ERROR / +NAME: / +UART: 就會被忽略
+ */
+void Hc05Config::onReply(const char* line) {
+  const char* p;
+  if (state == HC_SETTLE || state == HC_REBOOT) {
+    return;  // 切換模式期間的資料（例如模組開機訊息）
+  }
+  if (strstr_P(line, PSTR("ERROR"))) {
+    onTimeout();
+  } else if ((p = strstr_P(line, PSTR("+NAME:"))) != NULL) {
+    valueMatched = strcmp(p + 6, name) == 0;
+  } else if ((p = strstr_P(line, PSTR("+UART:"))) != NULL) {
+    valueMatched = strtoul(p + 6, NULL, 10) == linkBaud;  // 儲存的設定與目前鮑率相同
+  } else if (strstr_P(line, PSTR("OK"))) {
+    switch (state) {
+      case HC_PROBE:
+        linkConfirmed = true;
+        if (verifying) {
+          finish(linkBaud == pendingBaud ? HC05_OK : HC05_FALLBACK, linkBaud);
+        } else {
+          state = HC_NAME_QUERY;
+          command(PSTR("+NAME?"));
+        }
+        break;
+      case HC_NAME_QUERY:
+        nameQueried(true);
+        break;
+      case HC_NAME_SET:
+        writes++;
+        state = HC_UART_QUERY;
+        command(PSTR("+UART?"));
+        break;
+      case HC_UART_QUERY:
+        targetIndex = 0;
+        while (targetIndex < HC05_TARGETS &&
+               BleUart::baudErrorPermille(baudAt(targetIndex)) > HC05_BAUD_ERROR_MAX) {
+          targetIndex++;
+        }
+        if (valueMatched && (targetIndex == HC05_TARGETS || linkBaud >= baudAt(targetIndex))) {
+          finish(HC05_OK, linkBaud);  // 已是可用的最高鮑率
+        } else {
+          setUart();
+        }
+        break;
+      case HC_UART_SET:
+        writes++;
+        state = HC_RESET;
+        command(PSTR("+RESET"));
+        break;
+      case HC_RESET:
+        onTimeout();  // 不等逾時：KEY 拉低並等待重新開機
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/**
+ * @brief 目前步驟到時間：等待狀態結束，或命令沒有回覆（ERROR 視為沒有回覆）
+ */
+void Hc05Config::onTimeout() {
+  switch (state) {
+    case HC_SETTLE:
+      probeIndex = 0;
+      probe();
+      break;
+    case HC_PROBE:
+      if (++probeIndex < HC05_BAUD_COUNT) {
+        probe();
+      } else if (verifying) {
+        finish(HC05_FALLBACK, pendingBaud);  // 模組已接受 AT+UART：重新開機後沒有回應仍以新鮑率為準
+      } else {
+        finish(HC05_NO_MODULE, fallbackBaud);  // 可能是已連線的模組：沿用記錄的鮑率
+      }
+      break;
+    case HC_NAME_QUERY:
+      nameQueried(false);  // 部分韌體在 mini AT 模式不支援查詢：直接寫入
+      break;
+    case HC_NAME_SET:
+      state = HC_UART_QUERY;  // 名稱不影響通訊，繼續設定鮑率
+      command(PSTR("+UART?"));
+      break;
+    case HC_UART_QUERY:
+      finish(HC05_FALLBACK, linkBaud);
+      break;
+    case HC_UART_SET:
+      targetIndex++;
+      setUart();
+      break;
+    case HC_RESET:
+      // 新鮑率在模組重新開機後生效：KEY 先拉低，讓模組以資料模式開機
+      digitalWrite(keyPin, LOW);
+      state = HC_REBOOT;
+      wait(HC05_RESET_MS);
+      break;
+    case HC_REBOOT:
+      // 重新進入 AT 模式確認新鮑率
+      digitalWrite(keyPin, HIGH);
+      verifying = true;
+      linkConfirmed = false;
+      state = HC_SETTLE;
+      wait(HC05_KEY_SETTLE_MS);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief 處理已收到的回覆行與逾時（HC05 工作在 ready() 時呼叫）
+ */
+void Hc05Config::run() {
+  char line[HC05_LINE_MAX];  // 也須容納最長 17 位元組的二進位框（丟棄）
+  size_t len;
+  BleFrameType type;
+  while (state != HC_DONE && (type = bleSerial.readFrame(line, sizeof(line), &len)) != BLE_FRAME_NONE) {
+    if (type == BLE_FRAME_TEXT) {
+      onReply(line);  // 二進位 / 損壞框為錯誤鮑率下的雜訊
+    }
+  }
+  if (state != HC_DONE && (long)(millis() - deadline) >= 0) {
+    onTimeout();
+  }
+}
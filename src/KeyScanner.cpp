@@ -0,0 +1,190 @@
+/*
+ * ============================================================================
+ * KeyScanner.cpp
+ * 按鍵掃描實作
+ * ============================================================================
+ */
+
+#include <KeyScanner.h>
+
+KeyScanner keys;
+
+#define KEY_SCAN_MASK ((1 << KEY_SCAN_KEYS) - 1)
+
+// ========== 初始化 ==========
+/**
+ * @brief 以目前腳位電位為初始狀態，開啟 PCINT1（PC0 ~ PC3）並清空佇列
+ * @note 腳位需先設定為 INPUT_PULLUP
+ */
+void KeyScanner::begin() {
+  uint8_t pins = ~PINC;
+  cli();
+  for (uint8_t i = 0; i < KEY_SCAN_KEYS; i++) {
+    keys[i].flags = (pins & (1 << i)) ? (K_DOWN | K_LONG) : 0;  // 開機前已按住的鍵不產生長按
+    keys[i].edgeAt = 0;
+    keys[i].repeatAt = 0;
+  }
+  head = tail = 0;
+  dueValid = false;
+  dropped = 0;
+  PCMSK1 |= KEY_SCAN_MASK;
+  PCIFR = (1 << PCIF1);   // 清除開啟前累積的變化
+  PCICR |= (1 << PCIE1);
+  sei();
+}
+
+void KeyScanner::setRepeat(uint8_t mask, uint16_t delayMs, uint16_t rateMs) {
+  cli();
+  repeatMask = mask;
+  repeatDelay = delayMs;
+  repeatRate = rateMs;
+  sei();
+}
+
+// ========== 事件佇列 ==========
+void KeyScanner::push(uint8_t key, KeyEventType type, unsigned long time) {
+  uint8_t n = (head + 1) & (KEY_QUEUE_SIZE - 1);
+  if (n == tail) {
+    dropped++;
+    return;
+  }
+  queue[head].key = key;
+  queue[head].type = type;
+  queue[head].time = time;
+  head = n;
+}
+
+bool KeyScanner::next(KeyEvent* ev) {
+  if (head == tail) {
+    return false;
+  }
+  cli();
+  *ev = queue[tail];
+  tail = (tail + 1) & (KEY_QUEUE_SIZE - 1);
+  sei();
+  return true;
+}
+
+uint16_t KeyScanner::droppedEvents() const {
+  cli();  // 計數器為 16 位元且由 PCINT1 中斷修改
+  uint16_t n = dropped;
+  sei();
+  return n;
+}
+
+void KeyScanner::resetStats() {
+  cli();
+  dropped = 0;
+  sei();
+}
+
+// ========== 狀態機 ==========
+// 接受一個邊緣：更新狀態、開始彈跳忽略期並排入事件（呼叫時中斷已關閉）
+void KeyScanner::edge(uint8_t key, bool down, unsigned long now) {
+  KeyState& k = keys[key];
+  k.flags = (down ? K_DOWN : 0) | K_LOCKED;
+  k.edgeAt = now;
+  k.repeatAt = now + repeatDelay;
+  push(key, down ? KEY_EV_PRESS : KEY_EV_RELEASE, now);
+}
+
+// 重新計算最早到期的計時（呼叫時中斷已關閉）
+void KeyScanner::schedule() {
+  bool any = false;
+  unsigned long best = 0;
+  for (uint8_t i = 0; i < KEY_SCAN_KEYS; i++) {
+    const KeyState& k = keys[i];
+    unsigned long t[3];
+    uint8_t n = 0;
+    if (k.flags & K_LOCKED) {
+      t[n++] = k.edgeAt + KEY_DEBOUNCE_MS;
+    }
+    if ((k.flags & (K_DOWN | K_LONG)) == K_DOWN) {
+      t[n++] = k.edgeAt + KEY_LONG_MS;
+    }
+    if ((k.flags & K_DOWN) && (repeatMask & (1 << i))) {
+      t[n++] = k.repeatAt;
+    }
+    for (uint8_t j = 0; j < n; j++) {
+      if (!any || (long)(t[j] - best) < 0) {
+        best = t[j];
+        any = true;
+      }
+    }
+  }
+  dueAt = best;
+  dueValid = any;
+}
+
+bool KeyScanner::ready() const {
+  if (head != tail) {
+    return true;
+  }
+  uint8_t sreg = SREG;  // 可在中斷關閉時呼叫（睡眠前的檢查），結束時恢復原本狀態
+  cli();
+  bool due = dueValid && (long)(millis() - dueAt) >= 0;
+  SREG = sreg;
+  return due;
+}
+
+/**
+ * @brief 處理到期的計時：彈跳忽略期結束後重新取樣、長按、自動重複
+ */
+void KeyScanner::poll() {
+  unsigned long now = millis();
+  cli();
+  uint8_t pins = ~PINC;
+  for (uint8_t i = 0; i < KEY_SCAN_KEYS; i++) {
+    KeyState& k = keys[i];
+    bool raw = (pins & (1 << i)) != 0;
+
+    if (k.flags & K_LOCKED) {
+      if (now - k.edgeAt < KEY_DEBOUNCE_MS) {
+        continue;
+      }
+      k.flags &= ~K_LOCKED;
+      if (raw != (bool)(k.flags & K_DOWN)) {
+        edge(i, raw, now);  // 忽略期間的最後一個邊緣改變了狀態
+        continue;
+      }
+    }
+
+    if (!(k.flags & K_DOWN)) {
+      continue;
+    }
+    if (!(k.flags & K_LONG) && now - k.edgeAt >= KEY_LONG_MS) {
+      k.flags |= K_LONG;
+      push(i, KEY_EV_LONG, k.edgeAt + KEY_LONG_MS);
+    }
+    if ((repeatMask & (1 << i)) && (long)(now - k.repeatAt) >= 0) {
+      push(i, KEY_EV_REPEAT, k.repeatAt);
+      k.repeatAt += repeatRate;
+      if ((long)(now - k.repeatAt) >= 0) {
+        k.repeatAt = now + repeatRate;  // 主迴圈延誤太久：不補送錯過的重複
+      }
+    }
+  }
+  schedule();
+  sei();
+}
+
+// ========== 中斷 ==========
+/**
+ * @brief PCINT1：只處理不在彈跳忽略期的按鍵，第一個邊緣即產生事件
+ */
+void KeyScanner::onChange() {
+  uint8_t pins = ~PINC;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < KEY_SCAN_KEYS; i++) {
+    KeyState& k = keys[i];
+    bool raw = (pins & (1 << i)) != 0;
+    if (!(k.flags & K_LOCKED) && raw != (bool)(k.flags & K_DOWN)) {
+      edge(i, raw, now);
+    }
+  }
+  schedule();
+}
+
+ISR(PCINT1_vect) {
+  keys.onChange();
+}
@@ -0,0 +1,203 @@
+/*
+ * ============================================================================
+ * LedFx.cpp
+ * WS2812 動畫引擎實作
+ * ============================================================================
+ */
+
+#include <LedFx.h>
+#include <avr/pgmspace.h>
+
+LedFx ledFx;
+
+// ========== 查表 ==========
+// Gamma 2.6：round(pow(i / 255, 2.6) * 255)
+static const uint8_t fxGamma[256] PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,
+    3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,   6,   6,   6,   7,
+    7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  10,  11,  11,  11,  12,  12,
+   13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,
+   20,  21,  21,  22,  22,  23,  24,  24,  25,  25,  26,  27,  27,  28,  29,  29,
+   30,  31,  31,  32,  33,  34,  34,  35,  36,  37,  38,  38,  39,  40,  41,  42,
+   42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,
+   58,  59,  60,  61,  62,  63,  64,  65,  66,  68,  69,  70,  71,  72,  73,  75,
+   76,  77,  78,  80,  81,  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,
+   97,  99, 100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120,
+  122, 124, 125, 127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148,
+  150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180,
+  182, 184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+  218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255,
+};
+
+// 色相斜波（色相 0 ~ 255 對應一圈）：0~42 全亮、43~85 遞減、86~170 全暗、
+// 171~213 遞增、214~255 全亮，已套用 Gamma 2.6；紅 = fxHue[h]、綠 = fxHue[h-85]、藍 = fxHue[h-171]
+static const uint8_t fxHue[256] PROGMEM = {
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 250, 235, 220, 206, 193,
+  180, 168, 156, 145, 134, 124, 114, 105,  96,  88,  80,  72,  65,  59,  53,  47,
+   42,  37,  32,  28,  24,  21,  18,  15,  12,  10,   8,   6,   5,   3,   2,   2,
+    1,   1,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+    1,   2,   3,   4,   5,   6,   8,  10,  13,  15,  18,  21,  25,  29,  33,  38,
+   42,  48,  54,  60,  66,  73,  81,  89,  97, 106, 115, 125, 136, 146, 158, 170,
+  182, 195, 209, 223, 237, 252, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+// ========== 選擇效果 ==========
+void LedFx::begin() {
+  fxMode = FX_OFF;
+  rgb[0] = rgb[1] = rgb[2] = 0;
+  count = leds.size();
+  spread = 0;
+  step = 0;
+  flashes = 0;
+  drawn = false;
+  startMs = millis();
+}
+
+/**
+ * @brief 切換效果；與目前效果完全相同時保持原本的相位
+ */
+void LedFx::start(FxMode m, uint32_t color, uint8_t n, uint16_t periodMs, uint8_t flashCount) {
+  uint8_t r = (uint8_t)(color >> 16);
+  uint8_t g = (uint8_t)(color >> 8);
+  uint8_t b = (uint8_t)color;
+  uint16_t s = periodMs ? FX_STEP(periodMs) : 0;
+  if (n > leds.size()) {
+    n = leds.size();
+  }
+  if (m == fxMode && r == rgb[0] && g == rgb[1] && b == rgb[2] &&
+      n == count && s == step && flashCount == flashes) {
+    return;
+  }
+  fxMode = m;
+  rgb[0] = r;
+  rgb[1] = g;
+  rgb[2] = b;
+  count = n;
+  spread = n ? 256 / n : 0;
+  step = s;
+  flashes = flashCount;
+  drawn = false;
+  startMs = millis();
+}
+
+void LedFx::off() {
+  start(FX_OFF, 0, FX_ALL, 0, 0);
+}
+
+void LedFx::solid(uint32_t color, uint8_t n) {
+  start(FX_SOLID, color, n, 0, 0);
+}
+
+/**
+ * @param periodMs 一次亮滅的週期（毫秒），前半週期亮
+ * @param flashes  閃爍次數，完成後保持恆亮（0 = 持續閃爍）
+ */
+void LedFx::blink(uint32_t color, uint8_t n, uint16_t periodMs, uint8_t flashCount) {
+  start(FX_BLINK, color, n, periodMs, flashCount);
+}
+
+void LedFx::gradient(uint16_t periodMs) {
+  start(FX_GRADIENT, 0, FX_ALL, periodMs, 0);
+}
+
+void LedFx::breathe(uint32_t color, uint16_t periodMs) {
+  start(FX_BREATHE, color, FX_ALL, periodMs, 0);
+}
+
+void LedFx::chase(uint32_t color, uint16_t periodMs) {
+  start(FX_CHASE, color, FX_ALL, periodMs, 0);
+}
+
+/**
+ * @brief 停止動畫並保留 LedStage 暫存幀，由呼叫端 setPixel() + present() 繪製
+ */
+void LedFx::hold() {
+  fxMode = FX_HOLD;
+  drawn = true;
+}
+
+// ========== 繪製 ==========
+void LedFx::drawLevel(uint8_t i, uint8_t level) {
+  leds.setPixel(i, ((uint32_t)(((uint16_t)rgb[0] * level) >> 8) << 16) |
+                   ((uint32_t)(((uint16_t)rgb[1] * level) >> 8) << 8) |
+                   (((uint16_t)rgb[2] * level) >> 8));
+}
+
+/**
+ * @brief 依經過時間繪製一幀（每顆 LED 成本固定，與經過時間長短無關）
+ */
+void LedFx::render() {
+  if (drawn) {
+    return;  // 靜態效果已在暫存幀中
+  }
+
+  // 相位（8.8）：高 8 位元以上為完成的週期數，位元 8~15 為週期內相位 0 ~ 255
+  uint32_t pos = (uint32_t)(millis() - startMs) * step;
+  uint8_t phase = (uint8_t)(pos >> 8);
+  uint32_t color = ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
+  uint8_t total = leds.size();
+
+  if (fxMode == FX_BLINK && flashes && (pos >> 16) >= flashes) {
+    fxMode = FX_SOLID;  // 閃爍完成：保持恆亮
+  }
+
+  switch (fxMode) {
+    case FX_BLINK:
+      for (uint8_t i = 0; i < total; i++) {
+        leds.setPixel(i, (i < count && phase < 128) ? color : 0);
+      }
+      break;
+
+    case FX_GRADIENT:
+      for (uint8_t i = 0; i < total; i++) {
+        uint8_t h = phase + i * spread;
+        leds.setPixel(i, ((uint32_t)pgm_read_byte(&fxHue[h]) << 16) |
+                         ((uint32_t)pgm_read_byte(&fxHue[(uint8_t)(h - 85)]) << 8) |
+                         pgm_read_byte(&fxHue[(uint8_t)(h - 171)]));
+      }
+      break;
+
+    case FX_BREATHE: {
+      // 三角波 0 → 254 → 0，經 Gamma 校正後人眼感受為線性漸變
+      uint8_t level = pgm_read_byte(&fxGamma[(phase < 128) ? phase * 2 : (255 - phase) * 2]);
+      for (uint8_t i = 0; i < total; i++) {
+        drawLevel(i, level);
+      }
+      break;
+    }
+
+    case FX_CHASE: {
+      uint8_t head = ((uint16_t)phase * count) >> 8;
+      uint8_t tail = head ? head - 1 : count - 1;
+      for (uint8_t i = 0; i < total; i++) {
+        if (i == head) {
+          leds.setPixel(i, color);
+        } else if (i == tail) {
+          drawLevel(i, 64);
+        } else {
+          leds.setPixel(i, 0);
+        }
+      }
+      break;
+    }
+
+    default:  // FX_OFF / FX_SOLID：只繪製一次
+      for (uint8_t i = 0; i < total; i++) {
+        leds.setPixel(i, (i < count) ? color : 0);
+      }
+      drawn = true;
+      break;
+  }
+  leds.present();
+}
@@ -0,0 +1,75 @@
+/*
+ * ============================================================================
+ * LedStage.cpp
+ * WS2812 輸出級實作
+ * ============================================================================
+ */
+
+#include <LedStage.h>
+
+LedStage leds;
+
+// ========== 初始化 ==========
+/**
+ * @brief 設定輸出的燈條，並送出一次全暗的幀
+ */
+void LedStage::begin(Adafruit_NeoPixel* neoStrip) {
+  strip = neoStrip;
+  count = (strip->numPixels() > LED_STAGE_MAX) ? LED_STAGE_MAX : strip->numPixels();
+  memset(frame, 0, sizeof(frame));
+  resetStats();
+  dirty = true;   // 上電後的 LED 內容未知，先送出全暗
+  show();
+}
+
+// ========== 繪製 ==========
+void LedStage::setPixel(uint8_t n, uint32_t color) {
+  if (n >= count) {
+    return;
+  }
+  uint8_t* p = &frame[n * 3];
+  p[0] = (uint8_t)(color >> 16);
+  p[1] = (uint8_t)(color >> 8);
+  p[2] = (uint8_t)color;
+}
+
+void LedStage::fill(uint32_t color) {
+  for (uint8_t i = 0; i < count; i++) {
+    setPixel(i, color);
+  }
+}
+
+/**
+ * @brief 一幀繪製完成：與上次送出的幀相同則略過，否則等待 show() 送出
+ */
+void LedStage::present() {
+  ledStats.frames++;
+  if (memcmp(frame, sent, count * 3) == 0) {
+    if (dirty) {
+      ledStats.merged++;  // 待送出的幀被改回已送出的內容
+    }
+    dirty = false;
+    ledStats.skipped++;
+    return;
+  }
+  if (dirty) {
+    ledStats.merged++;
+  }
+  dirty = true;
+}
+
+// ========== 輸出 ==========
+/**
+ * @brief 將暫存幀套用亮度後送到燈條（中斷關閉約 count × 30µs）
+ */
+void LedStage::show() {
+  for (uint8_t i = 0; i < count; i++) {
+    const uint8_t* p = &frame[i * 3];
+    strip->setPixelColor(i, p[0], p[1], p[2]);
+  }
+  strip->show();
+  memcpy(sent, frame, count * 3);
+  dirty = false;
+  ledStats.shows++;
+  ledStats.irqOffUs += LED_IRQ_OFF_US(count);
+}
@@ -0,0 +1,131 @@
+/*
+ * ============================================================================
+ * PowerManager.cpp
+ * 閒置睡眠與背光淡出實作
+ * ============================================================================
+ */
+
+#include <PowerManager.h>
+#include <Scheduler.h>
+#include <TimerWheel.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+
+PowerManager power;
+
+static void dimExpired() {
+  power.onDim();
+}
+
+static void fadeStep() {
+  power.onFadeStep();
+}
+
+static SoftTimer dimTimer(dimExpired);   // 無活動計時
+static SoftTimer fadeTimer(fadeStep);    // 淡出中：每 BACKLIGHT_FADE_STEP_MS 降低一步
+
+// 每一步降低的 PWM 值（BACKLIGHT_FADE_MS 內由全亮降到 BACKLIGHT_DIM）
+#define FADE_DELTA ((BACKLIGHT_FULL - BACKLIGHT_DIM) / (BACKLIGHT_FADE_MS / BACKLIGHT_FADE_STEP_MS) + 1)
+
+// ========== 初始化 ==========
+void PowerManager::begin(uint8_t backlightPin, uint8_t seconds) {
+  pin = backlightPin;
+  pinMode(pin, OUTPUT);
+  setBacklight(BACKLIGHT_FULL);
+
+  // 未使用的周邊不供應時鐘（按鍵為數位輸入，不需要 ADC）
+  power_adc_disable();
+  power_twi_disable();
+  power_timer2_disable();
+
+  setDimTimeout(seconds);
+  resetStats();
+}
+
+void PowerManager::setDimTimeout(uint8_t seconds) {
+  dimSeconds = seconds;
+  activity();
+  if (!seconds) {
+    timers.stop(&dimTimer);
+  }
+}
+
+// ========== 背光 ==========
+void PowerManager::setBacklight(uint8_t value) {
+  level = value;
+  analogWrite(pin, value);
+}
+
+void PowerManager::activity() {
+  if (level != BACKLIGHT_FULL) {
+    timers.stop(&fadeTimer);
+    setBacklight(BACKLIGHT_FULL);
+  }
+  if (dimSeconds) {
+    timers.start(&dimTimer, dimSeconds * 1000UL);  // O(1) 重新計時
+  }
+}
+
+void PowerManager::onDim() {
+  timers.start(&fadeTimer, BACKLIGHT_FADE_STEP_MS, BACKLIGHT_FADE_STEP_MS);
+}
+
+void PowerManager::onFadeStep() {
+  if (level <= BACKLIGHT_DIM + FADE_DELTA) {
+    setBacklight(BACKLIGHT_DIM);
+    timers.stop(&fadeTimer);
+  } else {
+    setBacklight(level - FADE_DELTA);
+  }
+}
+
+// ========== 閒置睡眠 ==========
+/**
+ * @brief 沒有工作可執行時進入 SLEEP_MODE_IDLE，直到任何中斷喚醒
+ * @param state 目前狀態編號（0 ~ POWER_STATES - 1），上一次呼叫後的時間都計入此狀態
+ * @return 睡眠的微秒數（再確認時已有工作則為 0）
+ */
+uint32_t PowerManager::idle(uint8_t state) {
+  unsigned long start = micros();
+  bool slept = false;
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  cli();
+  if (!sched.pending()) {
+    sleep_enable();
+    sei();        // sei 之後的 sleep_cpu 一定先執行：這之間發生的中斷會立即喚醒
+    sleep_cpu();
+    sleep_disable();
+    slept = true;
+  }
+  sei();
+
+  unsigned long end = micros();
+  uint32_t sleptUs = slept ? end - start : 0;
+  PowerStats& s = states[state];
+  s.totalUs += end - mark;
+  s.sleepUs += sleptUs;
+  if (slept) {
+    sched.wake();
+  }
+  mark = end;
+  if (s.totalUs & 0x80000000UL) {
+    s.totalUs >>= 1;  // 約 36 分鐘後減半：比例不變，較舊的時間權重逐漸降低
+    s.sleepUs >>= 1;
+  }
+  return sleptUs;
+}
+
+// ========== 統計 ==========
+uint16_t PowerManager::activePermille(uint8_t state) const {
+  const PowerStats& s = states[state];
+  if (s.totalUs == 0) {
+    return 0;
+  }
+  return (uint16_t)(1000 - (uint64_t)s.sleepUs * 1000 / s.totalUs);
+}
+
+void PowerManager::resetStats() {
+  memset(states, 0, sizeof(states));
+  mark = micros();
+}
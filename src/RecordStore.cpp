@@ -0,0 +1,188 @@
+/*
+ * ============================================================================
+ * RecordStore.cpp
+ * EEPROM 耗損平均記錄區實作
+ * ============================================================================
+ */
+
+#include <RecordStore.h>
+#include <EEPROM.h>
+#include <util/crc16.h>  // _crc16_update
+
+RecordStore eepromStore;
+
+// ========== 初始化 ==========
+/**
+ * @brief 設定記錄區範圍並掃描最新的有效記錄（開機時同步讀取 EEPROM）
+ * @param base       記錄區起始位址
+ * @param length     記錄區大小（位元組），尾端不足一槽的部分不使用
+ * @param recordSize 記錄大小（位元組，不超過 STORE_RECORD_MAX）
+ */
+bool RecordStore::begin(uint16_t regionBase, uint16_t length, uint8_t size) {
+  base = regionBase;
+  recordSize = (size > STORE_RECORD_MAX) ? STORE_RECORD_MAX : size;
+  slotCount = length / (recordSize + STORE_SLOT_OVERHEAD);
+  hasRecord = false;
+  pending = false;
+  writing = false;
+  memset(&storeStats, 0, sizeof(storeStats));
+  storeStats.slot = STORE_NONE;
+
+  for (uint16_t slot = 0; slot < slotCount; slot++) {
+    uint16_t addr = slotAddr(slot);
+    uint16_t s = readWord(addr);
+    if (s == STORE_SEQ_EMPTY || slotCrc(slot, s) != readWord(addr + 2 + recordSize)) {
+      continue;
+    }
+    if (!hasRecord || (int16_t)(s - storeStats.seq) > 0) {
+      hasRecord = true;
+      storeStats.slot = slot;
+      storeStats.seq = s;
+    }
+  }
+
+  if (hasRecord) {
+    uint16_t addr = slotAddr(storeStats.slot) + 2;
+    for (uint8_t i = 0; i < recordSize; i++) {
+      shadow[i] = EEPROM.read(addr + i);
+    }
+  }
+  return hasRecord;
+}
+
+bool RecordStore::load(void* record) const {
+  if (!hasRecord) {
+    return false;
+  }
+  memcpy(record, shadow, recordSize);
+  return true;
+}
+
+// ========== 寫入 ==========
+/**
+ * @brief 排入新記錄，由 EE_READY 中斷在背景寫入下一個槽位
+ * @return true = 已排入；false = 與最新記錄相同，不寫入
+ */
+bool RecordStore::commit(const void* record) {
+  // 內容未改變：不消耗寫入次數
+  if (hasRecord && memcmp(shadow, record, recordSize) == 0) {
+    storeStats.skipped++;
+    return false;
+  }
+
+  cli();  // 中斷開始新的一槽時會讀取 shadow
+  memcpy(shadow, record, recordSize);
+  if (pending) {
+    storeStats.merged++;  // 前一筆尚未開始燒寫，直接以新內容取代
+  }
+  pending = true;
+  hasRecord = true;
+  EECR |= (1 << EERIE);   // 開啟 EE_READY 中斷（未在燒寫時立即觸發）
+  sei();
+  return true;
+}
+
+void RecordStore::getStats(StoreStats* out) {
+  cli();  // 槽位、序號與計數器由中斷修改，需在關閉中斷下複製
+  *out = storeStats;
+  sei();
+}
+
+void RecordStore::resetStats() {
+  cli();
+  storeStats.commits = 0;
+  storeStats.skipped = 0;
+  storeStats.merged = 0;
+  storeStats.bytesWritten = 0;
+  sei();
+}
+
+// ========== 中斷燒寫 ==========
+// 準備下一槽的內容（在中斷中呼叫）
+void RecordStore::startSlot() {
+  bool first = (storeStats.slot == STORE_NONE);
+  uint16_t seqNo = first ? 0 : storeStats.seq + 1;
+  if (seqNo == STORE_SEQ_EMPTY) {
+    seqNo = 0;
+  }
+  wrSlot = (first || storeStats.slot + 1 >= slotCount) ? 0 : storeStats.slot + 1;
+  wrPos = 0;
+
+  image[0] = seqNo & 0xFF;
+  image[1] = seqNo >> 8;
+  uint16_t crc = crcStart(seqNo);
+  for (uint8_t i = 0; i < recordSize; i++) {
+    image[2 + i] = shadow[i];
+    crc = _crc16_update(crc, shadow[i]);
+  }
+  image[2 + recordSize] = crc & 0xFF;
+  image[3 + recordSize] = crc >> 8;
+
+  pending = false;
+  writing = true;
+}
+
+/**
+ * @brief EE_READY 中斷：燒寫下一個內容不同的位元組
+ *
+ * 燒寫順序為記錄內容、CRC，最後才是序號（中途斷電時此槽 CRC 不符）；
+ * 整槽完成後若有暫存記錄則接著寫下一槽，否則關閉中斷
+ */
+void RecordStore::onReady() {
+  uint8_t size = recordSize + STORE_SLOT_OVERHEAD;
+  for (;;) {
+    if (!writing) {
+      if (!pending) {
+        EECR &= ~(1 << EERIE);
+        return;
+      }
+      startSlot();
+    }
+
+    while (wrPos < size) {
+      uint8_t offset = (wrPos < size - 2) ? wrPos + 2 : wrPos - (size - 2);
+      wrPos++;
+      EEAR = slotAddr(wrSlot) + offset;
+      EECR |= (1 << EERE);
+      if (EEDR != image[offset]) {
+        EEDR = image[offset];
+        EECR |= (1 << EEMPE);
+        EECR |= (1 << EEPE);  // 開始燒寫，完成後再次觸發中斷
+        storeStats.bytesWritten++;
+        return;
+      }
+    }
+
+    // 整槽完成（最後一個位元組已燒寫完畢）
+    storeStats.slot = wrSlot;
+    storeStats.seq = image[0] | ((uint16_t)image[1] << 8);
+    storeStats.commits++;
+    writing = false;
+  }
+}
+
+ISR(EE_READY_vect) {
+  eepromStore.onReady();
+}
+
+// ========== CRC ==========
+uint16_t RecordStore::readWord(uint16_t addr) const {
+  return EEPROM.read(addr) | ((uint16_t)EEPROM.read(addr + 1) << 8);
+}
+
+// 記錄大小也納入計算：設定結構改變後，舊格式的記錄不會被誤認為有效
+uint16_t RecordStore::crcStart(uint16_t seqNo) const {
+  uint16_t crc = 0xFFFF;
+  crc = _crc16_update(crc, recordSize);
+  crc = _crc16_update(crc, seqNo & 0xFF);
+  return _crc16_update(crc, seqNo >> 8);
+}
+
+uint16_t RecordStore::slotCrc(uint16_t slot, uint16_t seqNo) const {
+  uint16_t addr = slotAddr(slot) + 2;
+  uint16_t crc = crcStart(seqNo);
+  for (uint8_t i = 0; i < recordSize; i++) {
+    crc = _crc16_update(crc, EEPROM.read(addr + i));
+  }
+  return crc;
+}
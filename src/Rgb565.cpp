@@ -0,0 +1,30 @@
+/*
+ * ============================================================================
+ * Rgb565.cpp
+ * RGB888 → RGB565 批次轉換
+ * ============================================================================
+ */
+
+#include <Rgb565.h>
+#include <avr/pgmspace.h>
+
+/**
+ * @brief 轉換 RAM 中的 24 位元顏色陣列（0xRRGGBB）
+ * @param src   來源陣列
+ * @param dst   輸出陣列（RGB565，可供 writePixels() 直接傳送）
+ * @param count 顏色數
+ */
+void rgb565Convert(const uint32_t* src, uint16_t* dst, uint16_t count) {
+  while (count--) {
+    *dst++ = rgb565(*src++);
+  }
+}
+
+/**
+ * @brief 轉換 PROGMEM 中的 24 位元顏色陣列（調色盤常數不佔用 RAM）
+ */
+void rgb565Convert_P(const uint32_t* srcProgmem, uint16_t* dst, uint16_t count) {
+  while (count--) {
+    *dst++ = rgb565(pgm_read_dword(srcProgmem++));
+  }
+}
@@ -0,0 +1,211 @@
+/*
+ * ============================================================================
+ * Scheduler.cpp
+ * 協同式工作排程器實作
+ * ============================================================================
+ */
+
+#include <Scheduler.h>
+
+Scheduler sched;
+
+// 執行期狀態旗標（TaskState::flags）
+#define ST_ACTIVE   0x01  // 已啟用
+#define ST_RELEASED 0x02  // 事件工作：已釋放，等待執行
+
+// ========== 初始化 ==========
+void Scheduler::begin(const TaskDef* taskTable, TaskState* taskState, uint8_t count) {
+  table = taskTable;
+  state = taskState;
+  taskCount = count;
+  running = SCHED_NONE;
+  inYield = false;
+  stolenUs = 0;
+
+  unsigned long now = micros();
+  for (uint8_t id = 0; id < count; id++) {
+    uint8_t flags = pgm_read_byte(&table[id].flags);
+    state[id].release = now;  // 週期工作立即第一次釋放
+    state[id].flags = (flags & SCHED_STOPPED) ? 0 : ST_ACTIVE;
+  }
+  resetStats();
+}
+
+void Scheduler::start(uint8_t id, uint16_t delayMs) {
+  state[id].release = micros() + delayMs * 1000UL;
+  state[id].flags = ST_ACTIVE;
+}
+
+void Scheduler::stop(uint8_t id) {
+  state[id].flags = 0;
+}
+
+bool Scheduler::active(uint8_t id) const {
+  return state[id].flags & ST_ACTIVE;
+}
+
+PGM_P Scheduler::name(uint8_t id) const {
+  return (PGM_P)pgm_read_ptr(&table[id].name);
+}
+
+void Scheduler::resetStats() {
+  for (uint8_t id = 0; id < taskCount; id++) {
+    memset(&state[id].stats, 0, sizeof(TaskStats));
+  }
+  sliceMaxUs = 0;
+  lastBoundary = micros();
+}
+
+// ========== 排程 ==========
+/**
+ * @brief 判斷工作是否已釋放（事件工作在此檢查觸發條件並記錄釋放時間）
+ */
+bool Scheduler::isDue(uint8_t id, unsigned long now) {
+  TaskState& st = state[id];
+  if (!(st.flags & ST_ACTIVE)) {
+    return false;
+  }
+  TaskReady ready = (TaskReady)pgm_read_ptr(&table[id].ready);
+  if (ready) {
+    if (!(st.flags & ST_RELEASED) && ready()) {
+      st.flags |= ST_RELEASED;
+      st.release = now;
+    }
+    return st.flags & ST_RELEASED;
+  }
+  return (long)(now - st.release) >= 0;
+}
+
+/**
+ * @brief 切片邊界：記錄與上一個邊界的間隔
+ * @note 不內聯，avrbench（尚未驗證）以進入此函式的間隔量測序列資料最久的等待時間
+ */
+__attribute__((noinline)) void Scheduler::boundary(unsigned long now) {
+  uint32_t gap = now - lastBoundary;
+  if (gap > sliceMaxUs) {
+    sliceMaxUs = gap;
+  }
+  lastBoundary = now;
+}
+
+/**
+ * @brief 執行一個工作並更新統計
+ *
+ * 執行時間不含期間插入執行的其他工作（stolenUs）
+ */
+void Scheduler::runTask(uint8_t id) {
+  TaskState& st = state[id];
+  TaskFunction fn = (TaskFunction)pgm_read_ptr(&table[id].run);
+  uint8_t prevRunning = running;
+  uint32_t prevStolen = stolenUs;
+
+  running = id;
+  stolenUs = 0;
+  unsigned long start = micros();
+  fn();
+  unsigned long end = micros();
+  uint32_t elapsed = end - start;
+  uint32_t runUs = elapsed - stolenUs;
+  running = prevRunning;
+  stolenUs = prevStolen + elapsed;
+
+  // 執行時間統計
+  TaskStats& s = st.stats;
+  s.runs++;
+  s.totalRunUs += runUs;
+  if (runUs > s.maxRunUs) {
+    s.maxRunUs = runUs;
+  }
+  if (runUs > pgm_read_word(&table[id].budgetUs)) {
+    s.overruns++;
+  }
+
+  // 截止時間檢查
+  uint32_t periodUs = pgm_read_word(&table[id].periodMs) * 1000UL;
+  if (pgm_read_ptr(&table[id].ready)) {
+    st.flags &= ~ST_RELEASED;
+    if (periodUs != 0 && end - st.release > periodUs) {
+      s.misses++;
+    }
+  } else if (periodUs == 0) {
+    st.release = end;
+  } else {
+    // 下一次釋放即為本次截止時間；已經過了就跳到下一個未來的週期，
+    // 每個被跳過的釋放都算一次錯過
+    st.release += periodUs;
+    if ((long)(end - st.release) >= 0) {
+      uint32_t skipped = (end - st.release) / periodUs + 1;
+      st.release += skipped * periodUs;
+      s.misses = (s.misses + skipped > 0xFFFF) ? 0xFFFF : s.misses + skipped;
+    }
+  }
+}
+
+/**
+ * @brief 執行一個切片：已釋放的工作中優先權最高者
+ * @return 是否執行了工作（false = 目前沒有工作可執行）
+ */
+bool Scheduler::runSlice() {
+  unsigned long now = micros();
+  boundary(now);
+
+  uint8_t best = SCHED_NONE;
+  uint8_t bestPriority = 0xFF;
+  for (uint8_t id = 0; id < taskCount; id++) {
+    uint8_t priority = pgm_read_byte(&table[id].priority);
+    if (priority < bestPriority && isDue(id, now)) {
+      best = id;
+      bestPriority = priority;
+    }
+  }
+  if (best == SCHED_NONE) {
+    return false;
+  }
+  runTask(best);
+  return true;
+}
+
+/**
+ * @brief 是否有已釋放的工作（睡眠前在關閉中斷的狀態下確認）
+ */
+bool Scheduler::pending() {
+  unsigned long now = micros();
+  for (uint8_t id = 0; id < taskCount; id++) {
+    if (isDue(id, now)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Scheduler::wake() {
+  lastBoundary = micros();
+}
+
+/**
+ * @brief 切片邊界：執行已釋放、可插入且優先權較目前工作高的工作
+ */
+void Scheduler::yield() {
+  if (inYield || taskCount == 0) {
+    return;
+  }
+  unsigned long now = micros();
+  boundary(now);
+
+  uint8_t current = (running == SCHED_NONE) ? 0xFF : pgm_read_byte(&table[running].priority);
+  bool ran = false;
+  inYield = true;
+  for (uint8_t id = 0; id < taskCount; id++) {
+    if ((pgm_read_byte(&table[id].flags) & SCHED_PREEMPT) &&
+        pgm_read_byte(&table[id].priority) < current && isDue(id, now)) {
+      runTask(id);
+      ran = true;
+    }
+  }
+  inYield = false;
+
+  // 插入的工作本身不算在切片間隔內
+  if (ran) {
+    lastBoundary = micros();
+  }
+}
@@ -0,0 +1,180 @@
+/*
+ * ============================================================================
+ * TimerWheel.cpp
+ * 階層式軟體計時器輪實作
+ * ============================================================================
+ */
+
+#include <TimerWheel.h>
+
+TimerWheel timers;
+
+#define TW_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TW_RANGE (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))  // 直接涵蓋的 tick 數
+
+// ========== 初始化 ==========
+/**
+ * @brief 清空所有槽並將 tick 歸零（在 timer_ini_ctc() 開啟中斷之前呼叫）
+ */
+void TimerWheel::begin() {
+  memset(slots, 0, sizeof(slots));
+  memset(occupied, 0, sizeof(occupied));
+  ticks = 0;
+  wheelTime = 0;
+  dueAt = 0;
+  dueValid = false;
+}
+
+uint32_t TimerWheel::now() const {
+  uint8_t sreg = SREG;  // 可在中斷關閉時呼叫（睡眠前的檢查），結束時恢復原本狀態
+  cli();
+  uint32_t t = ticks;
+  SREG = sreg;
+  return t;
+}
+
+// ========== 登記與取消 ==========
+/**
+ * @brief 登記計時器（已登記時重新計時）
+ * @param delay  距離第一次到期的 tick 數（0 視為 1）
+ * @param period 之後每隔幾 tick 到期一次；0 = 單次
+ */
+void TimerWheel::start(SoftTimer* t, uint32_t delay, uint16_t period) {
+  if (active(t)) {
+    unlink(t);
+  }
+  if (!dueValid) {
+    wheelTime = now();  // 沒有任何計時器時計時器輪不前進，先對齊目前時間
+  }
+  t->expires = now() + (delay ? delay : 1);
+  t->period = period;
+  insert(t);
+  schedule();
+}
+
+void TimerWheel::stop(SoftTimer* t) {
+  if (active(t)) {
+    unlink(t);
+    schedule();
+  }
+}
+
+// 依距離到期的 tick 數放入對應層的槽
+void TimerWheel::insert(SoftTimer* t) {
+  uint32_t at = t->expires;
+  uint32_t delta = at - wheelTime;
+  if (delta >= TW_RANGE) {
+    at = wheelTime + TW_RANGE - 1;  // 超過範圍：先放在最上層最後一槽，下移時重新計算
+    delta = TW_RANGE - 1;
+  }
+  uint8_t level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1UL << (TIMER_WHEEL_BITS * (level + 1)))) {
+    level++;
+  }
+  uint8_t idx = (at >> (TIMER_WHEEL_BITS * level)) & TW_MASK;
+
+  SoftTimer*& head = slots[level][idx];
+  t->prev = NULL;
+  t->next = head;
+  if (head) {
+    head->prev = t;
+  }
+  head = t;
+  occupied[level] |= (1 << idx);
+  t->slot = level * TIMER_WHEEL_SLOTS + idx + 1;
+}
+
+void TimerWheel::unlink(SoftTimer* t) {
+  uint8_t level = (t->slot - 1) >> TIMER_WHEEL_BITS;
+  uint8_t idx = (t->slot - 1) & TW_MASK;
+  if (t->prev) {
+    t->prev->next = t->next;
+  } else {
+    slots[level][idx] = t->next;
+  }
+  if (t->next) {
+    t->next->prev = t->prev;
+  }
+  if (!slots[level][idx]) {
+    occupied[level] &= ~(1 << idx);
+  }
+  t->slot = TIMER_IDLE;
+}
+
+// ========== 事件處理 ==========
+// 上層目前的槽整槽下移（依剩餘 tick 數重新放入）
+void TimerWheel::cascade(uint8_t level) {
+  uint8_t idx = (wheelTime >> (TIMER_WHEEL_BITS * level)) & TW_MASK;
+  SoftTimer* t;
+  while ((t = slots[level][idx]) != NULL) {
+    unlink(t);
+    insert(t);
+  }
+}
+
+// 執行第 0 層目前槽內的所有計時器（expires 都等於 wheelTime）
+void TimerWheel::expire() {
+  uint8_t idx = wheelTime & TW_MASK;
+  SoftTimer* t;
+  while ((t = slots[0][idx]) != NULL) {
+    unlink(t);
+    if (t->period) {
+      t->expires += t->period;  // 以到期時間為基準，不以回呼執行時間為基準
+      insert(t);                // period ≥ 1，不會回到目前的槽
+    }
+    t->fn();  // 回呼可以 start() / stop() 任何計時器（包含自己）
+  }
+}
+
+/**
+ * @brief 計算下一個事件：各層下一個非空槽的處理時間；
+ *        只有目前位置之前的槽有計時器時，事件為本層轉完一圈
+ */
+void TimerWheel::schedule() {
+  bool any = false;
+  uint32_t best = 0;
+  for (uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    uint16_t occ = occupied[level];
+    if (!occ) {
+      continue;
+    }
+    uint8_t shift = TIMER_WHEEL_BITS * level;
+    uint8_t idx = (wheelTime >> shift) & TW_MASK;
+    uint32_t rotation = (wheelTime >> (shift + TIMER_WHEEL_BITS)) << (shift + TIMER_WHEEL_BITS);
+    uint16_t ahead = occ & (uint16_t)(0xFFFEu << idx);
+    uint32_t at = ahead ? rotation + ((uint32_t)__builtin_ctz(ahead) << shift)
+                        : rotation + (1UL << (shift + TIMER_WHEEL_BITS));
+    if (!any || at - wheelTime < best - wheelTime) {
+      best = at;
+      any = true;
+    }
+  }
+  dueAt = best;
+  dueValid = any;
+}
+
+bool TimerWheel::ready() const {
+  return dueValid && (int32_t)(now() - dueAt) >= 0;
+}
+
+/**
+ * @brief 依序處理到目前 tick 為止的事件：下層轉完一圈時上層下移，再執行第 0 層到期的計時器
+ *
+ * 只停在有事件的 tick；主迴圈延誤時一次補完，每個回呼仍依到期順序執行一次
+ */
+void TimerWheel::run() {
+  uint32_t target = now();
+  while (dueValid && (int32_t)(target - dueAt) >= 0) {
+    wheelTime = dueAt;
+    for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+      if (wheelTime & ((1UL << (TIMER_WHEEL_BITS * level)) - 1)) {
+        break;
+      }
+      cascade(level);
+    }
+    expire();
+    schedule();
+  }
+  wheelTime = target;  // 下一個事件之前沒有需要處理的槽
+  schedule();
+}
@@ -0,0 +1,301 @@
+/*
+ * ============================================================================
+ * UiCompositor.cpp
+ * TFT 保留式畫面合成器實作
+ * ============================================================================
+ */
+
+#include <UiCompositor.h>
+
+UiCompositor ui;
+
+// ========== 字形擷取 ==========
+/**
+ * 以 Adafruit_GFX::drawChar() 將字元畫到 5x8 的位元遮罩中，
+ * 直接沿用函式庫內建字型（不需要在 Flash 中另存一份字型表）
+ */
+class UiGlyph : public Adafruit_GFX {
+public:
+  UiGlyph() : Adafruit_GFX(6, 8) {}
+
+  void capture(char c) {
+    memset(columns, 0, sizeof(columns));
+    drawChar(0, 0, (unsigned char)c, 1, 1, 1);  // 前景 = 背景：只畫亮點
+  }
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (color && x >= 0 && x < 5 && y >= 0 && y < 8) {
+      columns[x] |= (1 << y);
+    }
+  }
+
+  uint8_t columns[5];  // 每欄 8 點，LSB 在上（第 6 欄固定為空白）
+};
+
+static UiGlyph glyph;
+
+// ========== 初始化 ==========
+void UiCompositor::begin(Adafruit_SPITFT* display) {
+  tft = display;
+  memset(texts, 0, sizeof(texts));
+  memset(bars, 0, sizeof(bars));
+  screenOpen = false;
+  yieldFn = NULL;
+  uiStats.cells = 0;
+  uiStats.pixels = 0;
+}
+
+void UiCompositor::invalidate() {
+  for (uint8_t i = 0; i < UI_MAX_TEXTS; i++) {
+    texts[i].flags &= ~F_VISIBLE;
+  }
+  for (uint8_t i = 0; i < UI_MAX_BARS; i++) {
+    bars[i].flags &= ~F_VISIBLE;
+  }
+}
+
+void UiCompositor::clear() {
+  Rect all = {0, 0, (uint8_t)tft->width(), (uint8_t)tft->height()};
+  fillBands(all, UI_BG);
+  invalidate();
+}
+
+void UiCompositor::beginScreen() {
+  for (uint8_t i = 0; i < UI_MAX_TEXTS; i++) {
+    texts[i].flags &= ~F_DECLARED;
+  }
+  for (uint8_t i = 0; i < UI_MAX_BARS; i++) {
+    bars[i].flags &= ~F_DECLARED;
+  }
+  screenOpen = true;
+}
+
+// ========== 範圍運算 ==========
+bool UiCompositor::overlaps(const Rect& a, const Rect& b) {
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// 以 UI_ERASE_BAND 列為一段填滿範圍，每段之後為切片邊界
+void UiCompositor::fillBands(const Rect& r, uint16_t color) {
+  for (uint8_t y = 0; y < r.h; y += UI_ERASE_BAND) {
+    uint8_t h = (r.h - y < UI_ERASE_BAND) ? r.h - y : UI_ERASE_BAND;
+    tft->fillRect(r.x, r.y + y, r.w, h, color);
+    yieldSlice();
+  }
+  uiStats.pixels += (uint16_t)r.w * r.h;
+}
+
+// 清除一塊範圍，並讓與其重疊、仍在畫面上的元素完整重繪
+void UiCompositor::erase(const Rect& r) {
+  fillBands(r, UI_BG);
+  markOverlaps(r);
+}
+
+void UiCompositor::markOverlaps(const Rect& r) {
+  for (uint8_t i = 0; i < UI_MAX_BARS; i++) {
+    if ((bars[i].flags & F_VISIBLE) && overlaps(bars[i].r, r)) {
+      bars[i].flags |= F_FULL;
+    }
+  }
+  for (uint8_t i = 0; i < UI_MAX_TEXTS; i++) {
+    if ((texts[i].flags & F_VISIBLE) && overlaps(texts[i].r, r)) {
+      texts[i].flags |= F_FULL;
+    }
+  }
+}
+
+// ========== 元素宣告 ==========
+/**
+ * @brief 設定文字欄位內容
+ * @param slot 欄位編號（0 ~ UI_MAX_TEXTS-1）
+ * @param x, y 左上角座標
+ * @param size 字體大小（與 setTextSize 相同）
+ * @param cols 欄寬（字元數），內容不足以空白補齊，超出部分截斷
+ * @param str  顯示內容（SRAM 字串，或以 F("...") 傳入的 PROGMEM 字串）
+ * @param fg   文字顏色
+ * @param bg   背景顏色（放在色塊上時應與色塊相同）
+ */
+void UiCompositor::text(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+                        const char* str, uint16_t fg, uint16_t bg) {
+  setText(slot, x, y, size, cols, str, false, fg, bg);
+}
+
+void UiCompositor::text(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+                        const __FlashStringHelper* str, uint16_t fg, uint16_t bg) {
+  setText(slot, x, y, size, cols, (const char*)str, true, fg, bg);
+}
+
+void UiCompositor::setText(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+                           const char* str, bool progmem, uint16_t fg, uint16_t bg) {
+  if (slot >= UI_MAX_TEXTS) {
+    return;
+  }
+  TextItem& t = texts[slot];
+  if (cols > UI_TEXT_MAX) {
+    cols = UI_TEXT_MAX;
+  }
+  t.flags |= F_DECLARED;
+
+  // 位置或大小改變：清除舊範圍，完整重繪
+  if ((t.flags & F_VISIBLE) &&
+      (t.r.x != x || t.r.y != y || t.size != size || t.cols != cols)) {
+    t.flags &= ~F_VISIBLE;
+    erase(t.r);
+  }
+  if (!(t.flags & F_VISIBLE)) {
+    t.flags |= F_FULL;
+  }
+  t.r.x = x;
+  t.r.y = y;
+  t.r.w = cols * 6 * size;
+  t.r.h = 8 * size;
+  t.size = size;
+  t.cols = cols;
+
+  if (t.fg != fg || t.bg != bg) {
+    t.fg = fg;
+    t.bg = bg;
+    t.flags |= F_FULL;
+  }
+
+  // 逐格比對內容
+  for (uint8_t i = 0; i < cols; i++) {
+    char c = progmem ? pgm_read_byte(str) : *str;
+    if (c) {
+      str++;
+    } else {
+      c = ' ';
+    }
+    if (t.shown[i] != c) {
+      t.shown[i] = c;
+      t.dirty |= (1UL << i);
+    }
+  }
+}
+
+/**
+ * @brief 以十進位顯示整數（靠左對齊）
+ */
+void UiCompositor::number(uint8_t slot, uint8_t x, uint8_t y, uint8_t size, uint8_t cols,
+                          long value, uint16_t fg, uint16_t bg) {
+  char buf[12];
+  char* p = buf + sizeof(buf) - 1;
+  bool negative = value < 0;
+  unsigned long v = negative ? -(unsigned long)value : (unsigned long)value;
+  *p = '\0';
+  do {
+    *--p = '0' + (v % 10);
+    v /= 10;
+  } while (v);
+  if (negative) {
+    *--p = '-';
+  }
+  text(slot, x, y, size, cols, p, fg, bg);
+}
+
+/**
+ * @brief 設定色塊（選單反白列、分隔線等）
+ */
+void UiCompositor::bar(uint8_t slot, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color) {
+  if (slot >= UI_MAX_BARS) {
+    return;
+  }
+  BarItem& b = bars[slot];
+  b.flags |= F_DECLARED;
+  if ((b.flags & F_VISIBLE) && (b.r.x != x || b.r.y != y || b.r.w != w || b.r.h != h)) {
+    b.flags &= ~F_VISIBLE;
+    erase(b.r);
+  }
+  if (!(b.flags & F_VISIBLE) || b.color != color) {
+    b.flags |= F_FULL;
+  }
+  b.r.x = x;
+  b.r.y = y;
+  b.r.w = w;
+  b.r.h = h;
+  b.color = color;
+}
+
+// ========== 傳送到面板 ==========
+/**
+ * @brief 傳送一個字元格（單一位址視窗，同色像素合併傳送）
+ */
+void UiCompositor::drawCell(const TextItem& t, uint8_t col) {
+  uint8_t s = t.size;
+  uint8_t x = t.r.x + col * 6 * s;
+  glyph.capture(t.shown[col]);
+
+  tft->startWrite();
+  tft->setAddrWindow(x, t.r.y, 6 * s, 8 * s);
+  for (uint8_t row = 0; row < 8; row++) {
+    for (uint8_t rep = 0; rep < s; rep++) {
+      // 一列 6 點，依顏色切成連續區段
+      uint8_t run = 0;
+      bool runOn = false;
+      for (uint8_t c = 0; c < 6; c++) {
+        bool on = c < 5 && (glyph.columns[c] & (1 << row));
+        if (run != 0 && on != runOn) {
+          tft->writeColor(runOn ? t.fg : t.bg, (uint32_t)run * s);
+          run = 0;
+        }
+        runOn = on;
+        run++;
+      }
+      tft->writeColor(runOn ? t.fg : t.bg, (uint32_t)run * s);
+    }
+  }
+  tft->endWrite();
+
+  uiStats.cells++;
+  uiStats.pixels += 48U * s * s;
+}
+
+void UiCompositor::flush() {
+  // 1. 結束畫面宣告：清除新畫面沒有使用的舊元素
+  if (screenOpen) {
+    screenOpen = false;
+    for (uint8_t i = 0; i < UI_MAX_BARS; i++) {
+      if ((bars[i].flags & (F_VISIBLE | F_DECLARED)) == F_VISIBLE) {
+        bars[i].flags &= ~F_VISIBLE;
+        erase(bars[i].r);
+      }
+    }
+    for (uint8_t i = 0; i < UI_MAX_TEXTS; i++) {
+      if ((texts[i].flags & (F_VISIBLE | F_DECLARED)) == F_VISIBLE) {
+        texts[i].flags &= ~F_VISIBLE;
+        erase(texts[i].r);
+      }
+    }
+  }
+
+  // 2. 色塊（在下層）：重繪後其上的文字需要完整重繪
+  for (uint8_t i = 0; i < UI_MAX_BARS; i++) {
+    BarItem& b = bars[i];
+    if ((b.flags & F_DECLARED) && (b.flags & F_FULL)) {
+      fillBands(b.r, b.color);
+      b.flags = (b.flags & ~F_FULL) | F_VISIBLE;
+      for (uint8_t j = 0; j < UI_MAX_TEXTS; j++) {
+        if (overlaps(texts[j].r, b.r)) {
+          texts[j].flags |= F_FULL;
+        }
+      }
+    }
+  }
+
+  // 3. 文字：完整重繪或只重繪變化的字元格
+  for (uint8_t i = 0; i < UI_MAX_TEXTS; i++) {
+    TextItem& t = texts[i];
+    if (!(t.flags & F_DECLARED)) {
+      continue;
+    }
+    uint32_t cells = (t.flags & F_FULL) ? 0xFFFFFFFFUL : t.dirty;
+    for (uint8_t c = 0; c < t.cols && cells; c++) {
+      if (cells & (1UL << c)) {
+        drawCell(t, c);
+        yieldSlice();
+      }
+    }
+    t.dirty = 0;
+    t.flags = (t.flags & ~F_FULL) | F_VISIBLE;
+  }
+}
@@ -12,7 +12,7 @@
  * 藍牙名稱: ODD-01-0001
  * 
  * 功能列表:
- * F1 - CPU 運行指示燈閃爍 (D13)
+ * F1 - CPU 運行指示燈閃爍 (D13；硬體 SPI 版本為 D4)
  * F2 - TFT 顯示初始化畫面 (TCIVS/C201)
  * F3 - RGB Offline 選單 (Red/Green/Blue/Gradient)
  * F4 - CountDown 倒數計時 (00:00:10 -> 00:00:00)
@@ -28,38 +28,71 @@
 #include <Arduino.h>
 #include <Engnin_comp_2025.h>
 #include <EEPROM.h>
+#include <RecordStore.h>  // EEPROM 耗損平均記錄區
+#include <BleUart.h>   // 中斷驅動藍牙序列埠（取代 Arduino Serial）
+#include <CommandTable.h>  // 文字命令查表分派
+#include <UiCompositor.h>  // TFT 畫面合成器（只重繪變化的字元格）
+#include <Scheduler.h>     // 協同式工作排程器（取代固定順序的 loop()）
+#include <LedStage.h>      // WS2812 輸出級（變化偵測 + 幀率上限）
+#include <LedFx.h>         // WS2812 動畫引擎（依經過時間繪製效果）
+#include <KeyScanner.h>    // 按鍵掃描（PCINT1 中斷 + 每鍵防彈跳 + 事件佇列）
+#include <TimerWheel.h>    // 系統 tick（Timer1 CTC 1kHz）與軟體計時器輪
+#include <PowerManager.h>  // 閒置睡眠與背光淡出
+#include <DeviceStats.h>   // STATS 命令：loop() 執行時間直方圖與命令計數
+#include <Hc05Config.h>    // HC-05 開機自動設定（名稱與鮑率）
+#include <util/crc16.h>  // _crc8_ccitt_update（二進位命令 CRC-8）
 #include <string.h>  // 用於 strcmp, strncmp, strlen 等 C 字符函式
 
 // ========== 腳位定義 ==========
+// 建置旗標 TFT_HW_SPI（[env:uno_hwspi]）：TFT 改用硬體 SPI（D11 / D13），
+// D13 被 SCK 佔用，CPU 運行指示燈移到 D4
+#ifdef TFT_HW_SPI
+#define LED_RED 4         // CPU 運行指示燈（D4，硬體 SPI 配置）
+#else
 #define LED_RED 13        // CPU 運行指示燈（D13）
+#endif
 #define WS2812_PIN 5      // WS2812 RGB LED（D5）- 修改為 D5
 #define WS2812_COUNT 8    // WS2812 LED 數量
+#define LED_MAX_FPS 25    // WS2812 幀率（LEDOUT 工作每幀繪製動畫並送出，每秒最多 show() 次數）
+#define LED_FRAME_MS (1000 / LED_MAX_FPS)
 
-// TFT LCD 腳位定義（實際硬體配置 - 軟體 SPI）
-// 注意：使用軟體 SPI 模式，可自訂 MOSI 和 SCK 腳位
+// TFT LCD 腳位定義
+// 預設為軟體 SPI（實際硬體配置），可自訂 MOSI 和 SCK 腳位：
 // SDA (MOSI) 接於 A4
 // SCL (SCK) 接於 A5
 #define TFT_CS   10       // Chip Select（D10）
 #define TFT_DC   8        // Data/Command（D8）
-#define TFT_RST  9        // Reset（D9）
+#define TFT_RST  9        // Reset（D9）- 由開機狀態機控制，不交給函式庫
 #define TFT_MOSI A4       // SDA / MOSI（A4）- 軟體 SPI
 #define TFT_SCLK A5       // SCL / SCK（A5）- 軟體 SPI
 #define TFT_BL   6        // 背光控制（D6）
-// SPI 標準腳位（硬體 SPI）：
+// SPI 標準腳位（硬體 SPI，TFT_HW_SPI）：
 // MOSI (SDA) = D11（規格中的 D18）
 // SCK (CLK) = D13（規格中的 D19）
 // VCC = 5V
 // GND = GND
+#define TFT_SPI_FREQ 8000000UL  // 硬體 SPI 時脈（F_CPU / 2，AVR 上限）
+
+// HC-05 KEY（EN）腳位：開機時拉高進入 AT 模式設定名稱與鮑率（模組為 3.3V 邏輯，經分壓電阻連接）
+#define HC05_KEY 7        // D7
 
 // 按鍵腳位定義（根據 FirmwareSpec.md 硬體架構表）
 #define KEY_UP     A0     // Up 按鍵（A0）
 #define KEY_DOWN   A1     // Down 按鍵（A1）
 #define KEY_ENTER  A2     // Enter 按鍵（A2）
 #define KEY_RETURN A3     // Return 按鍵（A3）
+#define KEY_ID(pin) ((pin) - A0)  // 按鍵編號（KeyScanner 的 PORTC 位元）
 
 // ========== 全域物件 ==========
-// 使用軟體 SPI：Adafruit_ST7735(CS, DC, MOSI, SCLK, RST)
-Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCLK, TFT_RST);
+#ifdef TFT_HW_SPI
+// 使用硬體 SPI：Adafruit_ST7735(CS, DC)，MOSI / SCK 固定為 D11 / D13
+// （不傳入 RST：函式庫的重置會以 delay() 阻塞 400ms，改由開機狀態機產生重置脈衝）
+Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC);
+#else
+// 使用軟體 SPI：Adafruit_ST7735(CS, DC, MOSI, SCLK)
+// （不傳入 RST：函式庫的重置會以 delay() 阻塞 400ms，改由開機狀態機產生重置脈衝）
+Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCLK);
+#endif
 Adafruit_NeoPixel strip(WS2812_COUNT, WS2812_PIN, NEO_GRB + NEO_KHZ800);
 
 // ========== 全域變數定義 ==========
@@ -86,241 +119,501 @@ MenuState currentMenu = MENU_MAIN;  // 目前選單狀態
 int menuIndex = 0;                  // 主選單索引（0-3）
 int rgbModeIndex = 0;               // RGB 模式索引（0-3）
 bool inSubMenu = false;             // 是否在子選單中
+static_assert(MENU_EEPROM < POWER_STATES, "POWER 統計以 MenuState 為狀態編號");
 const MenuState MENU_ORDER[4] = {
   MENU_CONNECT_BLE,
   MENU_RGB_OFFLINE,
   MENU_COUNTDOWN,
   MENU_EEPROM
 };
+// 主選單項目文字（對應四個功能；字串與指標表都在 PROGMEM）
+const char MENU_ITEM_BLE[] PROGMEM = "1.Connect to BLE";  // F6, F7: 藍牙連線與 CPU Loading 顯示
+const char MENU_ITEM_RGB[] PROGMEM = "2.RGB Offline";     // F3: RGB LED 離線控制
+const char MENU_ITEM_COUNTDOWN[] PROGMEM = "3.CountDown"; // F4: 倒數計時功能
+const char MENU_ITEM_EEPROM[] PROGMEM = "4.EEPROM";       // F8: EEPROM 讀取功能
+const char* const MAIN_MENU_ITEMS[4] PROGMEM = {
+  MENU_ITEM_BLE,
+  MENU_ITEM_RGB,
+  MENU_ITEM_COUNTDOWN,
+  MENU_ITEM_EEPROM
+};
+
+// ===== TFT 畫面元素編號（UiCompositor）=====
+// 相同位置的元素在各畫面共用同一編號，切換畫面時只重繪內容不同的字元格
+enum UiTextSlot {
+  UI_TITLE,    // 標題（y=5）
+  UI_MAIN,     // 主要內容（連線狀態、RGB 模式、倒數時間、EEPROM 數值）
+  UI_DETAIL,   // 主要內容下方的說明 / 狀態
+  UI_LINE0,    // 一般文字行（主選單項目、說明文字）
+  UI_LINE1,
+  UI_LINE2,
+  UI_LINE3,
+  UI_HINT1,    // 倒數第二行操作提示（y=100）
+  UI_HINT2     // 最後一行操作提示（y=112）
+};
+enum UiBarSlot {
+  UI_RULE,       // 標題下方分隔線
+  UI_HIGHLIGHT   // 主選單反白列
+};
+
+// ===== 開機流程相關 =====
+// 開機狀態機：每個狀態在 bootWakeAt 之後由 BOOT 工作執行一次，
+// 原本的 delay() 都改為設定下一次執行時間（期間序列命令照常處理）
+enum BootState {
+  BOOT_RESET_ASSERT,   // 拉低 TFT RST（硬體重置脈衝開始）
+  BOOT_RESET_RELEASE,  // 放開 RST，等待面板完成重置
+  BOOT_PANEL_INIT,     // 逐一送出面板初始化命令（命令附帶的延遲改為等待）
+  BOOT_SPLASH,         // 清除畫面並顯示開機畫面（F2）
+  BOOT_MENU,           // 開機畫面停留 2 秒後進入主選單
+  BOOT_DONE            // 開機完成
+};
+BootState bootState = BOOT_RESET_ASSERT;
+unsigned long bootWakeAt = 0;         // 目前狀態可執行的時間（millis）
+const uint8_t* bootInitCmd = NULL;    // 下一個面板初始化命令（PROGMEM）
+uint8_t bootInitLeft = 0;             // 剩餘面板初始化命令數
+const unsigned long BOOT_SPLASH_MS = 2000;  // 開機畫面停留時間（FirmwareSpec.md F2）
 
 // ===== 倒數計時功能相關 =====
-volatile int countdownSeconds = 10;          // 倒數秒數（起始值 10）- ISR 中會修改
-volatile bool countdownRunning = false;      // 倒數計時是否運行中
-volatile bool countdownPaused = false;       // 倒數計時是否暫停
-unsigned long lastCountdownTime = 0; // 上次更新時間
-bool countdownFinishAnimation = false; // 倒數完成後的閃爍動畫狀態
-unsigned long countdownFinishLastToggle = 0; // 上次閃爍切換時間
-uint8_t countdownFinishBlinkStep = 0;  // 閃爍步驟計數（6 步 = 3 次閃爍）
-const unsigned long COUNTDOWN_FINISH_INTERVAL = 300; // 閃爍間隔（毫秒）
+int countdownSeconds = 10;          // 倒數秒數（起始值 10）- countdownTimer 每秒遞減
+bool countdownRunning = false;      // 倒數計時是否運行中
+bool countdownPaused = false;       // 倒數計時是否暫停
+const uint16_t COUNTDOWN_FINISH_PERIOD = 600;  // 完成動畫閃爍週期（亮 300ms + 暗 300ms）
+const uint8_t COUNTDOWN_FINISH_FLASHES = 3;    // 閃爍次數，之後保持恆亮
 bool countdownFirstDisplay = true;    // 倒數計時首次顯示標誌
 
 // ===== 藍牙通訊相關 =====
-const size_t BLE_BUFFER_MAX = 64;   // 藍牙命令最大長度（必須在陣列定義前）
+const size_t BLE_BUFFER_MAX = BLE_FRAME_MAX;  // 藍牙命令最大長度（與中斷分框上限相同）
 bool bleConnected = false;          // 藍牙連線狀態
 char receivedData[BLE_BUFFER_MAX] = {0};  // 接收的資料緩衝區（使用 C 字符陣列替代 String）
 size_t receivedDataLen = 0;         // 接收資料的長度
-unsigned long lastBleDataTime = 0;  // 最後一次收到藍牙資料的時間
-const unsigned long BLE_TIMEOUT = 5000; // 藍牙逾時時間（5 秒）
+const unsigned long BLE_TIMEOUT = 5000; // 藍牙逾時時間（5 秒，每次收到資料重新計時）
+char btName[13];                    // 藍牙模組名稱（最長 "EVEN-99-1111" + '\0'，由 setupBluetooth() 產生）
 
 // ===== CPU 指示燈相關 =====
-unsigned long lastLedTime = 0;      // 上次 LED 切換時間
 bool ledState = false;              // LED 當前狀態（ON/OFF）
+const uint16_t CPU_LED_PERIOD = 500;  // 指示燈切換間隔（FirmwareSpec.md F1）
 
 // ===== RGB LED 相關 =====
-uint16_t hueValue = 0;              // 漸層色相值（0-65535）
+const uint16_t RGB_BLINK_PERIOD = 1000;     // RGB Offline 閃爍週期（亮 500ms + 暗 500ms，與 F1 相同）
+const uint16_t RGB_GRADIENT_PERIOD = 5000;  // 漸層色相環旋轉一圈的時間
 
 // ===== EEPROM 資料儲存相關 =====
 int eepromValue = 0;                // EEPROM 儲存的數值
 bool eepromValid = false;           // EEPROM 資料是否有效
-#define EEPROM_SIGNATURE 0xAA       // EEPROM 簽名（驗證初始化）
-#define EEPROM_ADDR_SIGNATURE 1     // 簽名儲存位址
-#define EEPROM_ADDR_VALUE 0         // 數值儲存位址
+bool eepromFirstDisplay = true;     // EEPROM 畫面首次顯示標誌
 
-// ===== 按鍵防彈跳相關 =====
-unsigned long lastKeyTime = 0;      // 上次按鍵觸發時間
-const int KEY_DEBOUNCE = 200;       // 防彈跳時間（毫秒）
+// 設定區塊：以耗損平均記錄區保存在整個 1KB EEPROM（include/RecordStore.h）
+// settings 是 RAM 中的鏡像，讀取一律使用鏡像；修改後以 eepromStore.commit() 在背景寫入
+// 增減欄位後舊記錄的 CRC 不符，開機時回到預設值
+struct AppSettings {
+  uint8_t storedValue;     // F8 WRITE 數值（0-255）
+  uint8_t ledBrightness;   // WS2812 亮度（0-255）
+  uint8_t countdownStart;  // 倒數起始秒數
+  uint8_t dimSeconds;      // 無操作多久後背光淡出（秒，0 = 不淡出）
+  uint8_t valueSet;        // storedValue 已由 WRITE 或舊版記錄設定（DIM 與鮑率也會產生記錄）
+  uint8_t linkBaudCode;    // HC-05 最後確認的資料鮑率 / LINK_BAUD_UNIT（0 = 未知）
+};
+AppSettings settings = {0, 50, 10, 30, 0, 0};  // 預設值（沒有有效記錄時使用）
+static_assert(sizeof(AppSettings) <= STORE_RECORD_MAX, "AppSettings 超過 STORE_RECORD_MAX");
+#define LINK_BAUD_UNIT 1200  // linkBaudCode 的單位（HC-05 的鮑率都是 1200 的倍數，115200 = 96）
+bool flushRequested = false;         // FLUSH 命令等待回覆（寫入完成後由 FLUSH 工作回覆）
+bool batchActive = false;            // dispatchBatch() 執行中（FLUSH 不接受批次執行）
+
+// 舊版韌體的單一位元組格式（開機時若找不到記錄則匯入一次）
+#define EEPROM_LEGACY_SIGNATURE 0xAA  // 簽名
+#define EEPROM_LEGACY_ADDR_SIGNATURE 1
+#define EEPROM_LEGACY_ADDR_VALUE 0
+
+// ===== 按鍵自動重複（UP / DOWN 按住時連續移動選項）=====
+const uint16_t KEY_REPEAT_DELAY = 400;  // 按住多久開始重複（毫秒）
+const uint16_t KEY_REPEAT_RATE = 150;   // 重複間隔（毫秒）
 
 // ========== 函式宣告 ==========
 void setupBluetooth();
+bool bootReady();
+void updateBoot();
 void displayBootScreen();
 void displayMainMenu();
-void updateMainMenuItem(int itemIndex, const char* itemText);  // 優化選單刷新
-void displaySubMenu();
+void updateMainMenuItems();  // 只更新反白列與選單項目
+void displayBleScreen();
+void displayRGBOfflineScreen();
+void displayCountdownScreen();
+void drawCountdownValues(int totalSeconds);
 void handleKeys();
 void updateCPULed();
 void updateRGBOffline();
 void updateCountdown();
+void countdownTick();
+void bleTimeout();
 void handleBluetoothData();
+bool dispatchCommand(char* line);
 void writeEEPROM(int value);
 int readEEPROM();
+void printStoreStats();
+void printLedStats();
+void printPowerStats();
+void printHc05Config();
+void printDeviceStats();
+void resetAllStats();
+void updateLedOutput();
+bool flushReady();
+void reportFlushed();
 void displayEEPROMValue();
-void setWS2812Color(uint32_t color, int numLeds);
-void setWS2812Gradient();
-void setAllWs2812(uint32_t color);
-void updateBleStatusText(const char* text, uint16_t color);
-String getBinaryString(int number);
+void drawBleStatus();
+void updateScreen();
+void printRxStats();
+void printTaskStats();
+void handleBinaryFrame(const uint8_t* frame, size_t len);
+char* trimCommand(char* start, char* end);
+void dispatchBatch(char* line);
+uint32_t cpuLoadColor(int cpuLoad);
+uint8_t parseLoadList(const char* args, uint8_t* loads);
+void showCpuLoads(const uint8_t* loads, uint8_t n);
+void applyEepromWrite(int value);
+void getBinaryString(int number, char* out);
 
-// ========== Timer1 中斷服務程式（用於倒數計時）==========
+// ===== 軟體計時器（include/TimerWheel.h，回呼在 TIMERS 工作中執行）=====
+SoftTimer cpuLedTimer(updateCPULed);      // CPU 運行指示燈，每 CPU_LED_PERIOD 切換
+SoftTimer countdownTimer(countdownTick);  // 倒數計時，進入 CountDown 後每秒一次
+SoftTimer bleTimeoutTimer(bleTimeout);    // 藍牙逾時，每次收到資料重新計時 BLE_TIMEOUT
+
+// ========== 工作排程表 ==========
 /**
- * @brief Timer1 溢位中斷服務常式 (ISR)
- * @note 此中斷每秒觸發一次，用於倒數計時功能
- * 
- * 功能說明：
- * 1. 重新載入 Timer1 計數器，維持 1Hz 中斷頻率
- * 2. 當倒數計時執行中且未暫停時，每秒遞減秒數
- * 3. 符合 FirmwareSpec.md F4 需求：從 10 秒倒數至 0 秒
+ * 每個子系統是一個工作（排程規則見 Scheduler.h）：
+ * - SERIAL：有完整命令框時釋放；可在畫面重繪的每個字元格之間插入執行，
+ *   因此序列命令的等待時間上限約為一個字元格，與目前畫面多複雜無關
+ * - TIMERS：系統 tick 到達下一個計時器事件時釋放，執行到期的軟體計時器回呼
+ *   （倒數、CPU 指示燈、藍牙逾時）；可插入畫面重繪，回呼只改變狀態、不繪圖
+ * - BOOT：開機狀態機（面板重置、初始化、開機畫面），完成後啟動 KEYS / SCREEN 並停止
+ * - KEYS：按鍵佇列有事件（或按鍵計時到期）時處理一個事件；
+ *   切換畫面的完整重繪在此工作中執行（超過預算屬預期）
+ * - SCREEN：目前選單的週期更新（RGB LED、倒數時間、藍牙狀態、EEPROM 數值）
+ * - LEDOUT：每 LED_FRAME_MS 依經過時間繪製目前的 WS2812 效果，內容改變時送出
+ *   （其他工作只選擇效果，見 include/LedFx.h）
+ * - FLUSH：FLUSH 命令等待的 EEPROM 記錄全部寫入後回覆（EEPROM 由 EE_READY 中斷在背景寫入）
+ * - BTCFG：開機時的 HC-05 AT 設定，收到回覆行或等待到時間時前進一步；完成後不再釋放，
+ *   期間 SERIAL 工作暫停（序列資料交給設定流程）
+ * 各工作的執行次數、錯過截止時間與超過預算次數可用 TASKS 命令查詢
  */
-ISR(TIMER1_OVF_vect) {
-  // 重新載入計數器，確保下次中斷在 1 秒後觸發
-  TCNT1 = timer1_counter;
-  
-  // 倒數計時邏輯處理
-  if (countdownRunning && !countdownPaused) {
-    if (countdownSeconds > 0) {
-      countdownSeconds--;  // 每秒遞減 1
-    }
+bool serialReady() {
+  return bleSerial.framesReady() > 0 && !hc05.active();  // 設定期間的資料是 AT 回覆
+}
+
+bool hc05Ready() {
+  return hc05.ready();
+}
+
+void runHc05() {
+  hc05.run();
+  if (!hc05.active() && hc05.confirmed()) {
+    // 記錄模組確認過的鮑率：之後在模組已連線時重新開機（AT 命令沒有回覆）仍以此鮑率通訊
+    settings.linkBaudCode = hc05.baud() / LINK_BAUD_UNIT;
+    eepromStore.commit(&settings);  // 與目前記錄相同時不寫入
   }
 }
 
+bool keysReady() {
+  return keys.ready();
+}
+
+bool timersReady() {
+  return timers.ready();
+}
+
+void runTimers() {
+  timers.run();
+}
+
+//     名稱    函式                 觸發條件     週期ms        預算us 優先權 旗標
+#define APP_TASKS(X)                                                                     \
+  X(SERIAL, handleBluetoothData, serialReady, 10,           2000,  0,     SCHED_PREEMPT) \
+  X(TIMERS, runTimers,           timersReady, 5,            500,   0,     SCHED_PREEMPT) \
+  X(BTCFG,  runHc05,             hc05Ready,   10,           500,   0,     SCHED_PREEMPT) \
+  X(BOOT,   updateBoot,          bootReady,   0,            2000,  1,     0)             \
+  X(KEYS,   handleKeys,          keysReady,   10,           500,   1,     SCHED_STOPPED) \
+  X(SCREEN, updateScreen,        NULL,        20,           8000,  2,     SCHED_STOPPED) \
+  X(LEDOUT, updateLedOutput,     NULL,        LED_FRAME_MS, 500,   3,     0)             \
+  X(FLUSH,  reportFlushed,       flushReady,  0,            500,   4,     0)
+
+DEFINE_TASK_TABLE(APP_TASKS)
+
+// 合成器切片邊界：讓序列工作插入執行
+void uiYield() {
+  sched.yield();
+}
+
+// ========== Timer1 中斷服務程式（系統 tick）==========
+/**
+ * @brief Timer1 比較匹配中斷服務常式 (ISR)，每 1ms 觸發一次
+ *
+ * CTC 模式由硬體歸零計數器，這裡不重新載入 TCNT1，只累加 tick；
+ * 倒數計時等工作由 TIMERS 工作依 tick 執行軟體計時器（include/TimerWheel.h）
+ */
+ISR(TIMER1_COMPA_vect) {
+  timers.tick();
+}
+
 // ========== Setup 函式（系統初始化）==========
 /**
  * @brief 系統初始化函式，只在開機時執行一次
  * 
- * 初始化項目：
+ * 初始化項目（不含任何 delay()，約數毫秒內即可回應序列命令）：
  * 1. 序列埠通訊（藍牙 HC-05）
- * 2. GPIO 腳位（LED、按鍵、TFT 背光）
- * 3. WS2812 RGB LED 燈條
- * 4. ST7735 TFT 顯示器
- * 5. 藍牙模組命名
- * 6. Timer1 中斷（倒數計時用）
- * 7. EEPROM 資料讀取
+ * 2. EEPROM 資料讀取
+ * 3. Timer1 中斷（1kHz 系統 tick）與軟體計時器
+ * 4. GPIO 腳位（LED、按鍵、TFT 背光）
+ * 5. WS2812 RGB LED 燈條
+ * 6. 藍牙模組命名與 HC-05 自動設定（AT 命令由 BTCFG 工作逐步送出）
+ * 7. ST7735 TFT 顯示器 SPI 腳位（面板重置與初始化由 BOOT 工作完成）
+ * 8. 工作排程
  */
 void setup() {
   // ===== 1. 初始化序列埠通訊 =====
-  // HC-05 藍牙模組使用 SPP 模式，鮑率 9600bps
-  Serial.begin(9600);
+  // HC-05 藍牙模組使用 SPP 模式，先以出廠鮑率 9600bps 開始；
+  // 開機自動設定（第 6 步）確認模組目前的鮑率，並在雙方都支援時提高到 57600 / 115200
+  // 使用中斷驅動的 bleSerial：即使 TFT 重繪時間較長，命令也會完整保存在環形緩衝區
+  bleSerial.begin(HC05_DEFAULT_BAUD);
+  
+  // ===== 2. 讀取 EEPROM 資料 =====
+  // 讀取上次儲存的設定區塊（F8 數值、LED 亮度、倒數秒數）；開機期間收到的 WRITE 也能正確處理
+  eepromValue = readEEPROM();
+  
+  // ===== 3. 初始化 Timer1 中斷與軟體計時器 =====
+  // CTC 模式 1kHz 系統 tick（倒數、CPU 指示燈、藍牙逾時都是 tick 上的軟體計時器）
+  // 計算公式：OCR1A = CPU頻率 / 預分頻 / 目標頻率 - 1
+  //          = 16,000,000 / 64 / 1000 - 1 = 249
+  timers.begin();
+  timer_ini_ctc(TIMER_TICK_OCR);
+  timers.start(&cpuLedTimer, CPU_LED_PERIOD, CPU_LED_PERIOD);
   
-  // ===== 2. 初始化 GPIO 腳位 =====
+  // ===== 4. 初始化 GPIO 腳位 =====
   // CPU 運行指示燈（紅色 LED）
   pinMode(LED_RED, OUTPUT);
   
-  // TFT 背光控制腳位
-  pinMode(TFT_BL, OUTPUT);
-  digitalWrite(TFT_BL, HIGH);   // 開啟背光（HIGH = 亮）
+  // TFT 背光：PWM 全亮，無操作 settings.dimSeconds 秒後淡出；同時關閉未使用的周邊
+  power.begin(TFT_BL, settings.dimSeconds);
   
   // 按鍵初始化（使用內建上拉電阻，按下時為 LOW）
   pinMode(KEY_UP, INPUT_PULLUP);     // 向上按鍵
   pinMode(KEY_DOWN, INPUT_PULLUP);   // 向下按鍵
   pinMode(KEY_ENTER, INPUT_PULLUP);  // 確認按鍵
   pinMode(KEY_RETURN, INPUT_PULLUP); // 返回按鍵
+  keys.setRepeat((1 << KEY_ID(KEY_UP)) | (1 << KEY_ID(KEY_DOWN)), KEY_REPEAT_DELAY, KEY_REPEAT_RATE);
   
-  // ===== 3. 初始化 WS2812 RGB LED 燈條 =====
+  // ===== 5. 初始化 WS2812 RGB LED 燈條 =====
   strip.begin();                // 啟動 WS2812 控制
-  strip.setBrightness(50);      // 設定亮度（範圍 0-255，50 約為 20%）
-  strip.show();                 // 更新顯示（初始化為全部熄滅）
-  
-  // ===== 4. 初始化 ST7735 TFT 顯示器 =====
-  delay(100);                   // 等待 TFT 電源穩定
-  
-  // 根據 TFT 模組背面的標籤顏色選擇初始化方式
-  // 如果顯示異常（白屏、顏色錯誤），請嘗試其他選項
-  tft.initR(INITR_BLACKTAB);    // 黑色標籤版本（1.8 吋 128×160 解析度）
-  // tft.initR(INITR_GREENTAB);  // 綠色標籤版本（較常見，建議優先嘗試）
-  // tft.initR(INITR_REDTAB);    // 紅色標籤版本
-  // tft.initR(INITR_144GREENTAB); // 1.44 吋版本（144×128 解析度）
+  strip.setBrightness(settings.ledBrightness);  // 設定亮度（範圍 0-255，預設 50 約為 20%）
+  leds.begin(&strip);           // 輸出級：初始化為全部熄滅，之後由 LEDOUT 工作每秒最多送出 LED_MAX_FPS 幀
+  ledFx.begin();                // 動畫引擎：全暗
   
-  delay(100);                   // 等待初始化完成
-  
-  // 設定螢幕方向（0-3 對應不同旋轉角度）
-  tft.setRotation(1);           // 1 = 橫向顯示（最常用）
-  
-  // 清除螢幕為黑色背景
-  tft.fillScreen(ST77XX_BLACK);
-  delay(100);                   // 確保畫面清除完成
-  
-  // ===== 5. 設定藍牙模組名稱 =====
-  // 根據崗位號碼的奇偶性命名（ODD 或 EVEN）
+  // ===== 6. 設定藍牙模組名稱 =====
+  // 根據崗位號碼的奇偶性命名（ODD 或 EVEN），由 BTCFG 工作以 AT 命令寫入模組並提高鮑率
   setupBluetooth();
+  hc05.begin(HC05_KEY, btName, (unsigned long)settings.linkBaudCode * LINK_BAUD_UNIT);
   
-  // ===== 6. 顯示開機畫面 =====
-  // 顯示「HHIVS」和「C201」文字
-  displayBootScreen();
-  
-  // 符合 FirmwareSpec.md F2 需求：延遲 2 秒後進入選單
-  delay(2000);
-  displayMainMenu();
+  // ===== 7. 準備 ST7735 TFT 顯示器 =====
+  // 只設定 SPI 腳位；重置、初始化命令與開機畫面由 BOOT 工作依時間逐步完成
+  tft.initSPI();
+#ifdef TFT_HW_SPI
+  tft.setSPISpeed(TFT_SPI_FREQ);  // 硬體 SPI 以最高時脈傳輸
+#endif
+  pinMode(TFT_RST, OUTPUT);
+  digitalWrite(TFT_RST, HIGH);
+  bootWakeAt = millis() + 100;  // 等待 TFT 電源穩定後開始重置
   
-  // ===== 7. 初始化 Timer1 中斷 =====
-  // 設定為 1Hz（每秒觸發一次），用於倒數計時功能
-  // 計算公式：Timer1 計數值 = 65536 - (CPU頻率 / 預分頻 / 目標頻率)
-  //          = 65536 - (16,000,000 / 256 / 1) = 65536 - 62,500 = 3,036
-  timer_ini(3036);
+  // 之後的畫面都交由合成器管理（開機畫面前會先清除整個面板）
+  ui.begin(&tft);
+  ui.setYield(uiYield);
   
-  // ===== 8. 讀取 EEPROM 資料 =====
-  // 讀取上次儲存的數值（用於 F8 功能）
-  eepromValue = readEEPROM();
+  // ===== 8. 啟動工作排程 =====
+  // 之後所有子系統（含開機流程）都由 loop() 中的排程器依週期與優先權執行
+  sched.begin(taskTable, taskState, TASK_COUNT);
+  devStats.reset();
+}
+
+// ========== 開機狀態機 ==========
+// ST7735 初始化命令（與 Adafruit 函式庫 Rcmd1 + Rcmd2red + Rcmd3 相同）
+// 格式：命令數，之後每筆為 命令、參數數（ST_CMD_DELAY 表示帶延遲）、參數、[延遲 ms，255 = 500ms]
+static const uint8_t PROGMEM bootInitList[] = {
+  21,
+  ST77XX_SWRESET, ST_CMD_DELAY, 150,                 // 軟體重置
+  ST77XX_SLPOUT, ST_CMD_DELAY, 255,                  // 離開睡眠模式
+  ST7735_FRMCTR1, 3, 0x01, 0x2C, 0x2D,               // 畫面更新率
+  ST7735_FRMCTR2, 3, 0x01, 0x2C, 0x2D,
+  ST7735_FRMCTR3, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D,
+  ST7735_INVCTR, 1, 0x07,
+  ST7735_PWCTR1, 3, 0xA2, 0x02, 0x84,                // 電源設定
+  ST7735_PWCTR2, 1, 0xC5,
+  ST7735_PWCTR3, 2, 0x0A, 0x00,
+  ST7735_PWCTR4, 2, 0x8A, 0x2A,
+  ST7735_PWCTR5, 2, 0x8A, 0xEE,
+  ST7735_VMCTR1, 1, 0x0E,
+  ST77XX_INVOFF, 0,
+  ST77XX_MADCTL, 1, 0xC8,
+  ST77XX_COLMOD, 1, 0x05,                            // 16 位元色彩
+  ST77XX_CASET, 4, 0x00, 0x00, 0x00, 0x7F,           // 128 欄
+  ST77XX_RASET, 4, 0x00, 0x00, 0x00, 0x9F,           // 160 列
+  ST7735_GMCTRP1, 16, 0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d,
+                      0x29, 0x25, 0x2B, 0x39, 0x00, 0x01, 0x03, 0x10,
+  ST7735_GMCTRN1, 16, 0x03, 0x1d, 0x07, 0x06, 0x2E, 0x2C, 0x29, 0x2D,
+                      0x2E, 0x2E, 0x37, 0x3F, 0x00, 0x00, 0x02, 0x10,
+  ST77XX_NORON, ST_CMD_DELAY, 10,                    // 一般顯示模式
+  ST77XX_DISPON, ST_CMD_DELAY, 100,                  // 開啟顯示
+};
+
+/**
+ * @brief BOOT 工作的觸發條件：開機尚未完成且已到達目前狀態的執行時間
+ */
+bool bootReady() {
+  return bootState != BOOT_DONE && (long)(millis() - bootWakeAt) >= 0;
+}
+
+// 目前狀態完成，ms 毫秒後執行下一個狀態
+static void bootWait(unsigned long ms) {
+  bootWakeAt = millis() + ms;
+}
+
+/**
+ * @brief BOOT 工作：每次執行開機流程的一個步驟
+ * 
+ * 取代原本 setup() 中約 2.5 秒的 delay() 與 initR() 內部約 1.2 秒的延遲：
+ * 面板重置脈衝、每個初始化命令後的等待、開機畫面停留 2 秒都改為 bootWait()，
+ * 等待期間排程器照常處理序列命令（開機後數毫秒即可回應 PING）
+ * 
+ * 面板初始化等同 tft.initR(INITR_BLACKTAB) + tft.setRotation(1)；
+ * 更換其他版本的面板時需改回呼叫 tft.initR()（會阻塞）
+ */
+void updateBoot() {
+  switch (bootState) {
+    case BOOT_RESET_ASSERT:
+      digitalWrite(TFT_RST, LOW);   // 硬體重置
+      bootState = BOOT_RESET_RELEASE;
+      bootWait(100);
+      break;
+      
+    case BOOT_RESET_RELEASE:
+      digitalWrite(TFT_RST, HIGH);
+      bootInitCmd = bootInitList + 1;
+      bootInitLeft = pgm_read_byte(bootInitList);
+      bootState = BOOT_PANEL_INIT;
+      bootWait(200);                // 等待面板完成重置
+      break;
+      
+    case BOOT_PANEL_INIT:
+      if (bootInitLeft > 0) {
+        // 送出一個命令，命令附帶的延遲改為等待
+        uint8_t cmd = pgm_read_byte(bootInitCmd++);
+        uint8_t numArgs = pgm_read_byte(bootInitCmd++);
+        uint8_t hasDelay = numArgs & ST_CMD_DELAY;
+        numArgs &= ~ST_CMD_DELAY;
+        tft.sendCommand(cmd, bootInitCmd, numArgs);
+        bootInitCmd += numArgs;
+        unsigned long ms = 0;
+        if (hasDelay) {
+          ms = pgm_read_byte(bootInitCmd++);
+          if (ms == 255) {
+            ms = 500;
+          }
+        }
+        bootInitLeft--;
+        bootWait(ms);
+      } else {
+        // 與 initR(INITR_BLACKTAB) 結尾相同：BLACKTAB 為 RGB 色彩順序
+        uint8_t madctl = 0xC0;
+        tft.sendCommand(ST77XX_MADCTL, &madctl, 1);
+        tft.setRotation(1);  // 橫向顯示
+        // setRotation() 依函式庫內部的面板版本選擇色彩順序（未呼叫 initR() 時為 BGR），
+        // 在此改回 BLACKTAB 的 MY | MV | RGB
+        madctl = ST77XX_MADCTL_MY | ST77XX_MADCTL_MV | ST77XX_MADCTL_RGB;
+        tft.sendCommand(ST77XX_MADCTL, &madctl, 1);
+        bootState = BOOT_SPLASH;
+      }
+      break;
+      
+    case BOOT_SPLASH:
+      ui.clear();            // 面板記憶體內容未定，先清除整個畫面
+      displayBootScreen();   // F2: 顯示 HHIVS / C201
+      bootState = BOOT_MENU;
+      bootWait(BOOT_SPLASH_MS);
+      break;
+      
+    case BOOT_MENU:
+      displayMainMenu();
+      bootState = BOOT_DONE;
+      sched.stop(TASK_BOOT);
+      keys.begin();  // 開機畫面期間的按鍵不處理：進入主選單才開啟按鍵中斷
+      sched.start(TASK_KEYS);
+      sched.start(TASK_SCREEN);
+      break;
+      
+    default:
+      break;
+  }
 }
 
 // ========== Loop 函式（主迴圈）==========
 /**
  * @brief 主程式迴圈，不斷重複執行
  * 
- * 執行順序：
- * 1. 更新 CPU 指示燈閃爍（F1 功能）
- * 2. 處理按鍵輸入（選單切換、模式選擇）
- * 3. 處理藍牙資料（接收 PC 端命令）
- * 4. 根據目前選單狀態更新顯示
+ * 每次執行一個排程切片：已到期的工作中優先權最高者（見「工作排程表」）
+ * 1. SERIAL：處理藍牙資料（接收 PC 端命令）
+ * 2. TIMERS：到期的軟體計時器（倒數、CPU 指示燈閃爍 F1、藍牙逾時）
+ * 3. KEYS：處理按鍵輸入（選單切換、模式選擇）
+ * 4. SCREEN：根據目前選單狀態更新顯示
+ * 5. LEDOUT：繪製並送出 WS2812 動畫
+ *
+ * 沒有工作可執行時進入 SLEEP_MODE_IDLE，由 USART RX、系統 tick 或按鍵中斷喚醒；
+ * 主選單與各子選單分別統計活動比例（POWER 命令）
+ * 每次的執行時間（不含睡眠）計入 STATS 直方圖
  */
 void loop() {
-  // ===== 1. 更新 CPU 運行指示燈 =====
-  // F1: 紅色 LED 以 500ms 間隔閃爍
-  updateCPULed();
-  
-  // ===== 2. 處理按鍵輸入 =====
-  // 讀取四個按鍵狀態並執行對應動作（UP/DOWN/ENTER/RETURN）
-  handleKeys();
-  
-  // ===== 3. 處理藍牙通訊 =====
-  // 接收並解析來自 PC 端的命令（PING/CONNECT/DISCONNECT/WRITE/LOAD）
-  handleBluetoothData();
+  unsigned long start = micros();
+  uint32_t sleptUs = 0;
+  if (!sched.runSlice()) {
+    sleptUs = power.idle(inSubMenu ? currentMenu : MENU_MAIN);
+  }
+  devStats.loopDone(micros() - start - sleptUs);
+}
+
+// ========== 目前選單的週期更新 ==========
+/**
+ * @brief SCREEN 工作：根據目前選單狀態更新 LED 與顯示（每 20ms）
+ * 
+ * 序列命令只改變狀態（bleConnected、eepromValue），畫面一律在此依狀態宣告；
+ * 合成器會略過沒有變化的字元格，因此序列工作插入執行時不會碰到繪圖
+ */
+void updateScreen() {
+  if (!inSubMenu) {
+    return;  // 主選單狀態：不需額外處理
+  }
   
-  // ===== 4. 根據目前選單狀態更新顯示 =====
   switch (currentMenu) {
-    case MENU_MAIN:
-      // 主選單狀態：不需在 loop 中額外處理
-      break;
-
     case MENU_RGB_OFFLINE:
       // RGB Offline 模式：更新 WS2812 LED 顯示
-      if (inSubMenu) {
-        updateRGBOffline();  // F3: 切換 Red/Green/Blue/Gradient 模式
-      }
+      updateRGBOffline();  // F3: 切換 Red/Green/Blue/Gradient 模式
       break;
       
     case MENU_COUNTDOWN:
       // 倒數計時模式：更新倒數顯示
-      if (inSubMenu) {
-        updateCountdown();   // F4: 顯示 00:00:10 → 00:00:00
-      }
+      updateCountdown();   // F4: 顯示 00:00:10 → 00:00:00
       break;
       
     case MENU_CONNECT_BLE:
-      // 藍牙連線模式：顯示連線狀態
-      if (inSubMenu) {
-        // F7: 根據 CPU Loading 顯示對應顏色
-        // 檢查藍牙連線逾時（如果已連線但超過 5 秒沒收到資料）
-        if (bleConnected && (millis() - lastBleDataTime > BLE_TIMEOUT)) {
-          bleConnected = false;  // 設定為中斷連線
-          
-          updateBleStatusText("Disconnect", ST77XX_RED);
-          setAllWs2812(0);
-        }
-      }
+      // 藍牙連線模式：顯示連線狀態（逾時由 bleTimeoutTimer 處理）
+      // F7: 根據 CPU Loading 顯示對應顏色
+      drawBleStatus();
+      ui.flush();
       break;
       
     case MENU_EEPROM:
       // EEPROM 讀取模式：顯示儲存的數值
-      if (inSubMenu) {
-        displayEEPROMValue();  // F8: 顯示 EEPROM 內容（內建防重繪機制）
-      }
+      displayEEPROMValue();  // F8: 顯示 EEPROM 內容（內建防重繪機制）
       break;
 
     default:
       // 預設狀態：不做任何處理
       break;
   }
-  
-  // 移除阻塞式延遲，確保藍牙接收保持即時
 }
 
 // ========== 藍牙設定函式 ==========
@@ -341,22 +634,19 @@ void setupBluetooth() {
   // 崗位號碼（實際使用時需根據比賽崗位修改）
   int stationNumber = 1;
   
-  // 判斷奇偶數（使用模運算）
-  String oddEven = (stationNumber % 2 == 1) ? "ODD" : "EVEN";
-  
-  // 將崗位號碼轉換為 4 位元二進位字串
-  String binary = getBinaryString(stationNumber);
+  // 判斷奇偶數（使用模運算），前綴字串放在 PROGMEM
+  strcpy_P(btName, (stationNumber % 2 == 1) ? PSTR("ODD-") : PSTR("EVEN-"));
+  char* p = btName + strlen(btName);
   
-  // 組合完整藍牙名稱
-  String btName = oddEven + "-0" + String(stationNumber) + "-" + binary;
+  // 崗位號碼（兩位十進位）
+  *p++ = '0' + (stationNumber / 10) % 10;
+  *p++ = '0' + stationNumber % 10;
+  *p++ = '-';
   
-  // 設定 HC-05 藍牙模組名稱
-  // 注意：HC-05 需要先進入 AT 模式才能設定名稱
-  // 進入方式：按住 HC-05 上的按鈕，然後上電
-  // 以下為簡化處理，實際應用時需要完整的 AT 命令設定
-  // Serial.println("AT+NAME=" + btName);
+  // 將崗位號碼轉換為 4 位元二進位字串（直接寫入名稱緩衝區，不使用 String / heap）
+  getBinaryString(stationNumber, p);
   
-  delay(100);  // 等待設定完成
+  // 名稱由 hc05（include/Hc05Config.h）在 AT 模式中查詢，與模組目前名稱不同時才以 AT+NAME 寫入
 }
 
 // ========== 顯示開機畫面 ==========
@@ -370,23 +660,15 @@ void setupBluetooth() {
  * - 延遲 2 秒後進入主選單
  */
 void displayBootScreen() {
-  // 清除整個螢幕為黑色
-  tft.fillScreen(ST77XX_BLACK);
-  delay(200);  // 等待清除完成
+  ui.beginScreen();
   
-  // 設定文字屬性
-  tft.setTextColor(ST77XX_WHITE);  // 白色文字
-  tft.setTextWrap(false);          // 關閉自動換行
-  tft.setTextSize(3);              // 大字體（3 倍大小）
+  // 第一行：顯示「HHIVS」（大字體，3 倍大小）
+  ui.text(UI_MAIN, 25, 35, 3, 5, F("HHIVS"), ST77XX_WHITE);
   
-  // 第一行：顯示「HHIVS」
-  tft.setCursor(25, 35);  // 設定游標位置（置中對齊）
-  tft.print("HHIVS");
+  // 第二行：顯示「C201」（中等字體，2 倍大小）
+  ui.text(UI_DETAIL, 40, 70, 2, 4, F("C201"), ST77XX_WHITE);
   
-  // 第二行：顯示「C201」
-  tft.setTextSize(2);      // 中等字體（2 倍大小）
-  tft.setCursor(40, 70);   // 設定游標位置
-  tft.print("C201");
+  ui.flush();
 }
 
 // ========== 顯示主選單 ==========
@@ -405,262 +687,211 @@ void displayBootScreen() {
  * - 青色標題，白色選項文字
  */
 void displayMainMenu() {
-  // 清除螢幕
-  tft.fillScreen(ST77XX_BLACK);
-  tft.setTextSize(1);  // 小字體
+  ui.beginScreen();
   
-  // 顯示選單標題「MENU」
-  tft.setTextColor(ST77XX_CYAN);  // 青色標題
-  tft.setCursor(55, 5);           // 置中位置
-  tft.println("MENU");
+  // 顯示選單標題「MENU」（青色，置中）
+  ui.text(UI_TITLE, 55, 5, 1, 4, F("MENU"), ST77XX_CYAN);
   
-  // 繪製標題下方的分隔線
-  tft.drawFastHLine(0, 17, 160, ST77XX_WHITE);
-  
-  // 定義選單項目文字（對應四個功能）
-  const char* menuItems[] = {
-    "1.Connect to BLE",  // F6, F7: 藍牙連線與 CPU Loading 顯示
-    "2.RGB Offline",     // F3: RGB LED 離線控制
-    "3.CountDown",       // F4: 倒數計時功能
-    "4.EEPROM"           // F8: EEPROM 讀取功能
-  };
+  // 標題下方的分隔線
+  ui.bar(UI_RULE, 0, 17, 160, 1, ST77XX_WHITE);
   
-  // 逐一繪製選單項目
-  for (int i = 0; i < 4; i++) {
-    updateMainMenuItem(i, menuItems[i]);
-  }
+  // 反白列與四個選單項目（flush 時一併傳送）
+  updateMainMenuItems();
 }
 
-// ========== 更新主選單單個項目（優化：只刷新該項目） ==========
+// ========== 更新主選單項目（優化：只刷新有變化的字元格） ==========
 /**
- * @brief 更新主選單的單個項目顯示
+ * @brief 依 menuIndex 更新反白列與四個選單項目
  * 
- * 此函式只重繪特定項目，而非整個選單
+ * 反白列移動時，合成器只會重繪新舊兩列；其他項目內容不變不會重新傳送
  * 用於優化 UP/DOWN 按鍵的回應速度
  */
-void updateMainMenuItem(int itemIndex, const char* itemText) {
-  const int itemY = 22 + itemIndex * 20;
+void updateMainMenuItems() {
   const int itemHeight = 18;
   
-  if (itemIndex == menuIndex) {
-    // 選中的項目：藍色背景反白顯示
-    tft.fillRect(0, itemY, 160, itemHeight, ST77XX_BLUE);
-    tft.setTextColor(ST77XX_WHITE);
-    tft.setCursor(5, itemY + 3);
-    tft.print(">");  // 顯示箭頭指示符號
-  } else {
-    // 未選中的項目：黑色背景、白色文字
-    tft.fillRect(0, itemY, 160, itemHeight, ST77XX_BLACK);
-    tft.setTextColor(ST77XX_WHITE);
-  }
+  // 選中的項目：藍色背景反白顯示
+  ui.bar(UI_HIGHLIGHT, 0, 22 + menuIndex * 20, 160, itemHeight, ST77XX_BLUE);
   
-  // 顯示選單項目文字
-  tft.setCursor(15, itemY + 3);
-  tft.println(itemText);
+  for (int i = 0; i < 4; i++) {
+    const int itemY = 22 + i * 20;
+    bool selected = (i == menuIndex);
+    
+    // 選中項目前方顯示「>」箭頭指示符號
+    char line[UI_TEXT_MAX + 1];  // 最多 UI_TEXT_MAX 字元 + '\0'
+    line[0] = selected ? '>' : ' ';
+    line[1] = ' ';
+    strncpy_P(line + 2, (PGM_P)pgm_read_ptr(&MAIN_MENU_ITEMS[i]), sizeof(line) - 3);
+    line[sizeof(line) - 1] = '\0';
+    
+    ui.text(UI_LINE0 + i, 5, itemY + 3, 1, 18, line, ST77XX_WHITE,
+            selected ? ST77XX_BLUE : ST77XX_BLACK);
+  }
+  ui.flush();
 }
 
 // ========== 處理按鍵輸入 ==========
 /**
- * @brief 讀取並處理四個按鍵的輸入
+ * @brief KEYS 工作：處理按鍵佇列中的一個事件
  * 
  * 按鍵配置：
- * - KEY_UP (A0)：向上移動選項
- * - KEY_DOWN (A1)：向下移動選項
+ * - KEY_UP (A0)：向上移動選項（按住自動重複）
+ * - KEY_DOWN (A1)：向下移動選項（按住自動重複）
  * - KEY_ENTER (A2)：確認進入/暫停繼續
  * - KEY_RETURN (A3)：返回上層選單
  * 
- * 防彈跳機制：
- * - 使用時間差判斷，避免重複觸發
- * - KEY_DEBOUNCE = 200ms
+ * 按下與放開由 PCINT1 中斷記錄（include/KeyScanner.h），每個按鍵獨立防彈跳，
+ * 重繪畫面期間的按鍵會留在佇列中依序處理；每次只處理一個事件，
+ * 讓序列命令可以在兩次畫面切換之間插入
  */
 void handleKeys() {
-  unsigned long currentTime = millis();
-  
-  // 防彈跳處理：兩次按鍵間隔必須大於 200ms
-  if (currentTime - lastKeyTime < KEY_DEBOUNCE) {
-    return;  // 時間間隔太短，忽略此次按鍵
-  }
-  
-  // ===== UP 鍵處理 =====
-  if (digitalRead(KEY_UP) == LOW) {  // 按下時為 LOW（使用 INPUT_PULLUP）
-    lastKeyTime = currentTime;        // 更新最後按鍵時間
-    
-    if (!inSubMenu) {
-      // 主選單：向上移動選項（循環選擇）
-      int oldIndex = menuIndex;
-      menuIndex = (menuIndex - 1 + 4) % 4;  // 避免負數，確保範圍 0-3
-      
-      // 只刷新改變的兩個項目（舊位置和新位置）
-      const char* menuItems[] = {
-        "1.Connect to BLE",
-        "2.RGB Offline",
-        "3.CountDown",
-        "4.EEPROM"
-      };
-      updateMainMenuItem(oldIndex, menuItems[oldIndex]);
-      updateMainMenuItem(menuIndex, menuItems[menuIndex]);
-    } else if (currentMenu == MENU_RGB_OFFLINE) {
-      // RGB Offline 子選單：切換上一個顏色模式
-      rgbModeIndex = (rgbModeIndex - 1 + 4) % 4;  // 循環選擇 0-3
-    }
+  KeyEvent ev;
+  keys.poll();
+  if (!keys.next(&ev)) {
+    return;
   }
-  
-  // ===== DOWN 鍵處理 =====
-  if (digitalRead(KEY_DOWN) == LOW) {
-    lastKeyTime = currentTime;
-    
-    if (!inSubMenu) {
-      // 主選單：向下移動選項（循環選擇）
-      int oldIndex = menuIndex;
-      menuIndex = (menuIndex + 1) % 4;  // 範圍 0-3
-      
-      // 只刷新改變的兩個項目（舊位置和新位置）
-      const char* menuItems[] = {
-        "1.Connect to BLE",
-        "2.RGB Offline",
-        "3.CountDown",
-        "4.EEPROM"
-      };
-      updateMainMenuItem(oldIndex, menuItems[oldIndex]);
-      updateMainMenuItem(menuIndex, menuItems[menuIndex]);
-    } else if (currentMenu == MENU_RGB_OFFLINE) {
-      // RGB Offline 子選單：切換下一個顏色模式
-      rgbModeIndex = (rgbModeIndex + 1) % 4;
-    }
+  power.activity();  // 任何按鍵事件都讓背光恢復全亮
+  if (ev.type != KEY_EV_PRESS && ev.type != KEY_EV_REPEAT) {
+    return;  // 放開與長按目前沒有對應的操作
   }
   
-  // ===== ENTER 鍵處理 =====
-  if (digitalRead(KEY_ENTER) == LOW) {
-    lastKeyTime = currentTime;
-    
-    if (!inSubMenu) {
-      // 主選單狀態：進入選中的子選單
-      inSubMenu = true;
-      
-      // 透過對應陣列將索引轉換為選單狀態
-      currentMenu = MENU_ORDER[menuIndex];
+  switch (ev.key) {
+    // ===== UP 鍵處理 =====
+    case KEY_ID(KEY_UP):
+      if (!inSubMenu) {
+        // 主選單：向上移動選項（循環選擇）
+        menuIndex = (menuIndex - 1 + 4) % 4;  // 避免負數，確保範圍 0-3
+        
+        // 只刷新改變的兩個項目（舊位置和新位置）
+        updateMainMenuItems();
+      } else if (currentMenu == MENU_RGB_OFFLINE) {
+        // RGB Offline 子選單：切換上一個顏色模式
+        rgbModeIndex = (rgbModeIndex - 1 + 4) % 4;  // 循環選擇 0-3
+      }
+      break;
       
-      // 根據選擇的選單顯示對應畫面
-      switch (currentMenu) {
-        case MENU_MAIN:
-          // 主選單狀態：不應該在此處出現，但為了避免編譯警告仍需處理
-          break;
-          
-        case MENU_CONNECT_BLE:
-          // F6, F7: 顯示藍牙連線畫面
-          tft.fillScreen(ST77XX_BLACK);
-          tft.setTextColor(ST77XX_CYAN);
-          tft.setTextSize(1);
-          tft.setCursor(25, 5);
-          tft.print("Connect to BLE");
-          tft.drawFastHLine(0, 17, 160, ST77XX_WHITE);
-          
-          // 顯示連線狀態
-          tft.setTextSize(2);
-          tft.setCursor(20, 40);
-          if (bleConnected) {
-            tft.setTextColor(ST77XX_GREEN);
-            tft.print("Connected");
-          } else {
-            tft.setTextColor(ST77XX_RED);
-            tft.print("Disconnect");
-          }
-          
-          // 顯示說明文字
-          tft.setTextColor(ST77XX_WHITE);
-          tft.setTextSize(1);
-          tft.setCursor(5, 70);
-          tft.print("PC send command:");
-          tft.setCursor(5, 82);
-          tft.print("CONNECT or PING");
-          tft.setCursor(5, 94);
-          tft.print("or any data...");
-          
-          tft.setCursor(5, 112);
-          tft.print("Return:Exit");
-          break;
-          
-        case MENU_RGB_OFFLINE:
-          // F3: RGB Offline 模式初始化
-          rgbModeIndex = 0;  // 重置為第一個模式（Red）
-          tft.fillScreen(ST77XX_BLACK);
-          break;
-          
-        case MENU_COUNTDOWN:
-          // F4: 倒數計時模式初始化
-          cli();  // 禁用中斷以安全設定倒數變數
-          countdownSeconds = 10;      // 起始時間 10 秒
-          countdownRunning = true;     // 開始倒數
-          countdownPaused = false;     // 非暫停狀態
-          sei();  // 恢復中斷
-          
-          // 繪製完整背景和固定文字（只需繪製一次）
-          tft.fillScreen(ST77XX_BLACK);
-          tft.setTextColor(ST77XX_WHITE);
-          tft.setTextSize(1);
-          tft.setCursor(40, 5);
-          tft.print("CountDown");
-          
-          // 操作提示
-          tft.setTextColor(ST77XX_CYAN);
-          tft.setCursor(5, 100);
-          tft.print("Enter:Pause/Resume");
-          tft.setCursor(5, 112);
-          tft.print("Return:Exit");
-          
-          countdownFirstDisplay = true; // 設定首次顯示標誌
-          break;
-          
-        case MENU_EEPROM:
-          // F8: 顯示 EEPROM 內容
-          displayEEPROMValue();
-          break;
+    // ===== DOWN 鍵處理 =====
+    case KEY_ID(KEY_DOWN):
+      if (!inSubMenu) {
+        // 主選單：向下移動選項（循環選擇）
+        menuIndex = (menuIndex + 1) % 4;  // 範圍 0-3
+        
+        // 只刷新改變的兩個項目（舊位置和新位置）
+        updateMainMenuItems();
+      } else if (currentMenu == MENU_RGB_OFFLINE) {
+        // RGB Offline 子選單：切換下一個顏色模式
+        rgbModeIndex = (rgbModeIndex + 1) % 4;
       }
-    } else if (currentMenu == MENU_COUNTDOWN) {
-      // 倒數計時子選單：ENTER 鍵切換暫停/繼續
-      countdownPaused = !countdownPaused;  // 反轉暫停狀態
-    }
-  }
-  
-  // ===== RETURN 鍵處理 =====
-  if (digitalRead(KEY_RETURN) == LOW) {
-    lastKeyTime = currentTime;
-    
-    if (inSubMenu) {
-      // 子選單狀態：返回主選單
-      inSubMenu = false;
-      cli();  // 禁用中斷以安全停止倒數
-      countdownRunning = false;  // 停止倒數計時
-      sei();  // 恢復中斷
+      break;
       
-      // 如果退出倒數計時模式，重置首次顯示標誌以便下次進入時完整初始化
-      if (currentMenu == MENU_COUNTDOWN) {
-        countdownFirstDisplay = true;
+    // ===== ENTER 鍵處理 =====
+    case KEY_ID(KEY_ENTER):
+      if (!inSubMenu) {
+        // 主選單狀態：進入選中的子選單
+        inSubMenu = true;
+        
+        // 透過對應陣列將索引轉換為選單狀態
+        currentMenu = MENU_ORDER[menuIndex];
+        
+        // 根據選擇的選單顯示對應畫面
+        switch (currentMenu) {
+          case MENU_MAIN:
+            // 主選單狀態：不應該在此處出現，但為了避免編譯警告仍需處理
+            break;
+            
+          case MENU_CONNECT_BLE:
+            // F6, F7: 顯示藍牙連線畫面
+            displayBleScreen();
+            break;
+            
+          case MENU_RGB_OFFLINE:
+            // F3: RGB Offline 模式初始化
+            rgbModeIndex = 0;  // 重置為第一個模式（Red）
+            displayRGBOfflineScreen();
+            break;
+            
+          case MENU_COUNTDOWN:
+            // F4: 倒數計時模式初始化
+            countdownSeconds = settings.countdownStart;  // 起始時間（預設 10 秒）
+            countdownRunning = true;     // 開始倒數
+            countdownPaused = false;     // 非暫停狀態
+            timers.start(&countdownTimer, 1000, 1000);  // 第一秒從按下 ENTER 起算
+            
+            // 繪製完整畫面（之後只更新時間與狀態）
+            displayCountdownScreen();
+            
+            countdownFirstDisplay = true; // 設定首次顯示標誌
+            break;
+            
+          case MENU_EEPROM:
+            // F8: 顯示 EEPROM 內容
+            eepromFirstDisplay = true;
+            displayEEPROMValue();
+            break;
+        }
+      } else if (currentMenu == MENU_COUNTDOWN) {
+        // 倒數計時子選單：ENTER 鍵切換暫停/繼續
+        countdownPaused = !countdownPaused;  // 反轉暫停狀態
       }
+      break;
       
-      setAllWs2812(0);           // 清除 WS2812 LED
-      displayMainMenu();         // 顯示主選單
-    }
+    // ===== RETURN 鍵處理 =====
+    case KEY_ID(KEY_RETURN):
+      if (inSubMenu) {
+        // 子選單狀態：返回主選單
+        inSubMenu = false;
+        countdownRunning = false;  // 停止倒數計時
+        timers.stop(&countdownTimer);
+        
+        // 如果退出倒數計時模式，重置首次顯示標誌以便下次進入時完整初始化
+        if (currentMenu == MENU_COUNTDOWN) {
+          countdownFirstDisplay = true;
+        }
+        
+        ledFx.off();               // 清除 WS2812 LED（含尚未播完的完成動畫）
+        displayMainMenu();         // 顯示主選單
+      }
+      break;
   }
 }
 
 // ========== 更新 CPU 運行指示燈 ==========
 /**
- * @brief 更新 CPU 運行指示燈閃爍狀態
+ * @brief cpuLedTimer 回呼：切換 CPU 運行指示燈
  * 
  * FirmwareSpec.md F1 需求：
- * - 紅色 LED (D13) 以 500ms 間隔閃爍
+ * - 紅色 LED (LED_RED) 以 500ms 間隔閃爍（CPU_LED_PERIOD，週期計時器不累積誤差）
  * - 持續運行，表示 MCU 正常工作
  */
 void updateCPULed() {
-  unsigned long currentTime = millis();
+  ledState = !ledState;         // 反轉 LED 狀態
+  digitalWrite(LED_RED, ledState ? HIGH : LOW);  // 輸出到 LED_RED
+}
+
+// ========== 顯示 RGB Offline 畫面 ==========
+/**
+ * @brief 依 rgbModeIndex 宣告 RGB Offline 畫面
+ * 
+ * 進入選單與切換模式都呼叫此函式；切換模式時只有模式名稱與說明的
+ * 字元格會被重新傳送
+ */
+void displayRGBOfflineScreen() {
+  // 模式名稱與說明（每個字串固定寬度，整張表放在 PROGMEM）
+  static const char modeNames[4][9] PROGMEM = {"Red", "Green", "Blue", "Gradient"};
+  static const char modeDetails[4][13] PROGMEM = {
+    "3 LEDs Blink", "6 LEDs Blink", "8 LEDs Blink", "RGB Cycle"
+  };
   
-  // 每 500ms 切換一次 LED 狀態
-  if (currentTime - lastLedTime > 500) {
-    lastLedTime = currentTime;    // 更新時間戳記
-    ledState = !ledState;         // 反轉 LED 狀態
-    digitalWrite(LED_RED, ledState ? HIGH : LOW);  // 輸出到 D13
-  }
+  ui.beginScreen();
+  ui.text(UI_TITLE, 35, 5, 1, 11, F("RGB Offline"), ST77XX_CYAN);
+  ui.bar(UI_RULE, 0, 17, 160, 1, ST77XX_WHITE);
+  
+  ui.text(UI_MAIN, 10, 40, 2, 8, (const __FlashStringHelper*)modeNames[rgbModeIndex], ST77XX_WHITE);
+  ui.text(UI_DETAIL, 10, 65, 1, 12, (const __FlashStringHelper*)modeDetails[rgbModeIndex], ST77XX_WHITE);
+  
+  // 操作提示
+  ui.text(UI_HINT1, 5, 100, 1, 17, F("Up/Dn:Change Mode"), ST77XX_YELLOW);
+  ui.text(UI_HINT2, 5, 112, 1, 11, F("Return:Exit"), ST77XX_YELLOW);
+  ui.flush();
 }
 
 // ========== 更新 RGB Offline 模式顯示 ==========
@@ -680,117 +911,38 @@ void updateRGBOffline() {
   // 只在模式改變時更新 TFT 顯示（避免重複繪製）
   if (lastRGBMode != rgbModeIndex) {
     lastRGBMode = rgbModeIndex;
-    
-    tft.fillScreen(ST77XX_BLACK);
-    tft.setTextColor(ST77XX_CYAN);
-    tft.setTextSize(1);
-    tft.setCursor(35, 5);
-    tft.print("RGB Offline");
-    
-    tft.drawFastHLine(0, 17, 160, ST77XX_WHITE);
-    
-    tft.setTextColor(ST77XX_WHITE);
-    tft.setTextSize(2);
-    
-    switch (rgbModeIndex) {
-      case RGB_RED:
-        tft.setCursor(10, 40);
-        tft.print("Red");
-        tft.setTextSize(1);
-        tft.setCursor(10, 65);
-        tft.print("3 LEDs Blink");
-        break;
-        
-      case RGB_GREEN:
-        tft.setCursor(10, 40);
-        tft.print("Green");
-        tft.setTextSize(1);
-        tft.setCursor(10, 65);
-        tft.print("6 LEDs Blink");
-        break;
-        
-      case RGB_BLUE:
-        tft.setCursor(10, 40);
-        tft.print("Blue");
-        tft.setTextSize(1);
-        tft.setCursor(10, 65);
-        tft.print("8 LEDs Blink");
-        break;
-        
-      case RGB_GRADIENT:
-        tft.setCursor(10, 40);
-        tft.print("Gradient");
-        tft.setTextSize(1);
-        tft.setCursor(10, 65);
-        tft.print("RGB Cycle");
-        break;
-    }
-    
-    // 操作提示
-    tft.setTextColor(ST77XX_YELLOW);
-    tft.setTextSize(1);
-    tft.setCursor(5, 100);
-    tft.print("Up/Down:Change Mode");
-    tft.setCursor(5, 112);
-    tft.print("Return:Exit");
+    displayRGBOfflineScreen();
   }
   
-  // 根據模式控制 WS2812
+  // 根據模式選擇 WS2812 效果（效果未改變時保持原本的相位，由 LEDOUT 工作繪製）
   switch (rgbModeIndex) {
     case RGB_RED:
-      setWS2812Color(strip.Color(255, 0, 0), 3);
+      ledFx.blink(strip.Color(255, 0, 0), 3, RGB_BLINK_PERIOD);
       break;
       
     case RGB_GREEN:
-      setWS2812Color(strip.Color(0, 255, 0), 6);
+      ledFx.blink(strip.Color(0, 255, 0), 6, RGB_BLINK_PERIOD);
       break;
       
     case RGB_BLUE:
-      setWS2812Color(strip.Color(0, 0, 255), 8);
+      ledFx.blink(strip.Color(0, 0, 255), 8, RGB_BLINK_PERIOD);
       break;
       
     case RGB_GRADIENT:
-      setWS2812Gradient();
+      ledFx.gradient(RGB_GRADIENT_PERIOD);
       break;
   }
 }
 
-// ========== 設定 WS2812 顏色 ==========
-void setWS2812Color(uint32_t color, int numLeds) {
-  static unsigned long lastBlink = 0;
-  static bool blinkState = false;
-  
-  if (millis() - lastBlink > 500) {
-    lastBlink = millis();
-    blinkState = !blinkState;
-  }
-  
-  for (int i = 0; i < WS2812_COUNT; i++) {
-    if (i < numLeds && blinkState) {
-      strip.setPixelColor(i, color);
-    } else {
-      strip.setPixelColor(i, 0);
-    }
-  }
-  strip.show();
-}
-
-// ========== 設定 WS2812 漸層色 ==========
-void setWS2812Gradient() {
-  for (int i = 0; i < WS2812_COUNT; i++) {
-    uint16_t hue = (hueValue + (i * 65536L / WS2812_COUNT)) % 65536;
-    strip.setPixelColor(i, strip.gamma32(strip.ColorHSV(hue)));
-  }
-  strip.show();
-  hueValue += 256;  // 緩慢變色
-}
-
-// ========== 設定所有 WS2812 為同一顏色 ==========
-void setAllWs2812(uint32_t color) {
-  for (int i = 0; i < WS2812_COUNT; i++) {
-    strip.setPixelColor(i, color);
+// ========== WS2812 輸出 ==========
+/**
+ * @brief LEDOUT 工作：依經過時間繪製目前效果，與上次送出的幀不同時送出
+ */
+void updateLedOutput() {
+  ledFx.render();
+  if (leds.pending()) {
+    leds.show();
   }
-  strip.show();
 }
 
 // ========== 檢驗字符串是否為純數字 ==========
@@ -812,127 +964,147 @@ bool isNumericString(const char* str) {
   return true;  // 所有字符都是數字
 }
 
-// ========== 更新 BLE 狀態文字 ========== 
-void updateBleStatusText(const char* text, uint16_t color) {
-  if (currentMenu == MENU_CONNECT_BLE && inSubMenu) {
-    tft.fillRect(20, 40, 120, 20, ST77XX_BLACK);
-    tft.setTextColor(color);
-    tft.setTextSize(2);
-    tft.setCursor(20, 40);
-    tft.print(text);
+// ========== 顯示藍牙連線畫面 ==========
+/**
+ * @brief 宣告 Connect to BLE 畫面（F6, F7）
+ */
+void displayBleScreen() {
+  ui.beginScreen();
+  ui.text(UI_TITLE, 25, 5, 1, 14, F("Connect to BLE"), ST77XX_CYAN);
+  ui.bar(UI_RULE, 0, 17, 160, 1, ST77XX_WHITE);
+  
+  // 顯示連線狀態
+  drawBleStatus();
+  
+  // 顯示說明文字
+  ui.text(UI_LINE0, 5, 70, 1, 16, F("PC send command:"), ST77XX_WHITE);
+  ui.text(UI_LINE1, 5, 82, 1, 16, F("CONNECT or PING"), ST77XX_WHITE);
+  ui.text(UI_LINE2, 5, 94, 1, 16, F("or any data..."), ST77XX_WHITE);
+  ui.text(UI_HINT2, 5, 112, 1, 11, F("Return:Exit"), ST77XX_WHITE);
+  ui.flush();
+}
+
+// ========== 宣告 BLE 狀態文字 ==========
+/**
+ * @brief 依 bleConnected 宣告連線狀態（由 SCREEN 工作每週期呼叫，內容不變時不重繪）
+ */
+void drawBleStatus() {
+  if (bleConnected) {
+    ui.text(UI_MAIN, 20, 40, 2, 10, F("Connected"), ST77XX_GREEN);
+  } else {
+    ui.text(UI_MAIN, 20, 40, 2, 10, F("Disconnect"), ST77XX_RED);
+  }
+}
+
+// ========== 顯示倒數計時畫面 ==========
+/**
+ * @brief 宣告 CountDown 畫面（固定文字 + 目前時間與狀態）
+ */
+void displayCountdownScreen() {
+  ui.beginScreen();
+  ui.text(UI_TITLE, 40, 5, 1, 9, F("CountDown"), ST77XX_WHITE);
+  drawCountdownValues(countdownSeconds);
+  
+  // 操作提示
+  ui.text(UI_HINT1, 5, 100, 1, 18, F("Enter:Pause/Resume"), ST77XX_CYAN);
+  ui.text(UI_HINT2, 5, 112, 1, 11, F("Return:Exit"), ST77XX_CYAN);
+  ui.flush();
+}
+
+/**
+ * @brief 宣告倒數時間（HH:MM:SS）與狀態文字
+ * 
+ * 時間固定 8 格、textSize=3（每格 18x24 像素）；秒數改變時合成器只會
+ * 重新傳送最後一兩格，不需要手動計算清除範圍
+ */
+void drawCountdownValues(int totalSeconds) {
+  int hours = totalSeconds / 3600;
+  int minutes = (totalSeconds / 60) % 60;
+  int seconds = totalSeconds % 60;
+  
+  char time[9];
+  time[0] = '0' + (hours / 10) % 10;
+  time[1] = '0' + hours % 10;
+  time[2] = ':';
+  time[3] = '0' + minutes / 10;
+  time[4] = '0' + minutes % 10;
+  time[5] = ':';
+  time[6] = '0' + seconds / 10;
+  time[7] = '0' + seconds % 10;
+  time[8] = '\0';
+  ui.text(UI_MAIN, 10, 35, 3, 8, time, ST77XX_WHITE);
+  
+  // 狀態：倒數結束顯示 FINISH!，否則顯示執行 / 暫停
+  if (!countdownRunning && totalSeconds == 0) {
+    ui.text(UI_DETAIL, 30, 75, 2, 7, F("FINISH!"), ST77XX_MAGENTA);
+  } else if (countdownPaused) {
+    ui.text(UI_DETAIL, 50, 75, 1, 7, F("PAUSED"), ST77XX_YELLOW);
+  } else {
+    ui.text(UI_DETAIL, 50, 75, 1, 7, F("RUNNING"), ST77XX_GREEN);
   }
 }
 
 // ========== 更新倒數計時 ==========
+/**
+ * @brief countdownTimer 回呼：倒數執行中且未暫停時遞減一秒，到 0 後停止計時器
+ * @note 符合 FirmwareSpec.md F4 需求：從 10 秒倒數至 0 秒
+ */
+void countdownTick() {
+  if (countdownRunning && !countdownPaused && countdownSeconds > 0) {
+    countdownSeconds--;
+    if (countdownSeconds == 0) {
+      timers.stop(&countdownTimer);
+    }
+  }
+}
+
 void updateCountdown() {
   static int lastDisplaySeconds = -1;
-  static int lastDisplayMinutes = -1;
+  static bool lastDisplayPaused = false;
+  static bool lastDisplayRunning = false;
   
-  // 安全地讀取 countdownSeconds（禁用中斷以避免 ISR 執行中修改）
-  int safeCountdownSeconds;
-  cli();  // 禁用全域中斷
-  safeCountdownSeconds = countdownSeconds;
-  sei();  // 恢復中斷
+  // countdownSeconds 只在 TIMERS 工作中改變；畫面宣告期間插入執行也只影響下一次更新
+  int safeCountdownSeconds = countdownSeconds;
   
   // 首次進入時強制更新（重置所有靜態變數）
   if (countdownFirstDisplay) {
     countdownFirstDisplay = false;
     lastDisplaySeconds = -1;  // 強制觸發更新
-    lastDisplayMinutes = -1;  // 重置分鐘追蹤
-  }
-  
-  // 只在秒數改變時更新顯示
-  if (lastDisplaySeconds != safeCountdownSeconds) {
-    lastDisplaySeconds = safeCountdownSeconds;
-    
-    int minutes = safeCountdownSeconds / 60;
-    int seconds = safeCountdownSeconds % 60;
-    
-    int hours = minutes / 60;
-    minutes = minutes % 60;
-    
-    // 首次顯示或分鐘改變時，繪製完整時間
-    if (lastDisplayMinutes != (hours * 60 + minutes) || lastDisplayMinutes == -1) {
-      lastDisplayMinutes = hours * 60 + minutes;
-      
-      // 清除整個時間顯示區域
-      tft.fillRect(0, 25, 160, 45, ST77XX_BLACK);
-      
-      // 顯示完整時間（格式：HH:MM:SS）
-      tft.setTextColor(ST77XX_WHITE);
-      tft.setTextSize(3);
-      tft.setCursor(10, 35);
-      // 小時
-      if (hours < 10) tft.print("0");
-      tft.print(hours);
-      tft.print(":");
-      // 分鐘
-      if (minutes < 10) tft.print("0");
-      tft.print(minutes);
-      tft.print(":");
-      // 秒數
-      if (seconds < 10) tft.print("0");
-      tft.print(seconds);
-    } else {
-      // ⚡ 只更新秒數部分（最後兩位數字）
-      // textSize=3 時每個字符寬約 18px，高約 24px
-      // 完整時間 "HH:MM:SS" 的顯示位置從 X=10 開始
-      // 秒數位置 = 10 + 2*18(時) + 18(冒號) + 2*18(分) + 18(冒號) = 118
-      tft.fillRect(118, 35, 36, 24, ST77XX_BLACK);  // 清除兩位數字的區域
-      
-      tft.setTextColor(ST77XX_WHITE);
-      tft.setTextSize(3);
-      tft.setCursor(118, 35);
-      if (seconds < 10) tft.print("0");
-      tft.print(seconds);
-    }
-    
-    // 顯示狀態（清除舊狀態並重繪）
-    tft.fillRect(0, 75, 160, 15, ST77XX_BLACK);
-    tft.setTextSize(1);
-    tft.setCursor(50, 75);
-    if (countdownPaused) {
-      tft.setTextColor(ST77XX_YELLOW);
-      tft.print("PAUSED");
-    } else {
-      tft.setTextColor(ST77XX_GREEN);
-      tft.print("RUNNING");
-    }
   }
   
-  // 倒數結束時啟動非阻塞閃爍動畫（根據 FirmwareSpec.md）
+  // 倒數結束時播放完成動畫：粉紅色閃爍三次後保持恆亮（根據 FirmwareSpec.md）
   if (safeCountdownSeconds == 0 && countdownRunning) {
     countdownRunning = false;
-    countdownFinishAnimation = true;
-    countdownFinishBlinkStep = 0;
-    countdownFinishLastToggle = millis();
-    
-    // 更新 TFT 顯示完成訊息
-    tft.fillRect(0, 75, 160, 20, ST77XX_BLACK);
-    tft.setTextColor(ST77XX_MAGENTA);
-    tft.setTextSize(2);
-    tft.setCursor(30, 75);
-    tft.print("FINISH!");
+    ledFx.blink(strip.Color(255, 105, 180), FX_ALL, COUNTDOWN_FINISH_PERIOD, COUNTDOWN_FINISH_FLASHES);
   }
   
-  if (countdownFinishAnimation) {
-    unsigned long now = millis();
-    if (now - countdownFinishLastToggle >= COUNTDOWN_FINISH_INTERVAL) {
-      countdownFinishLastToggle = now;
-      bool ledOn = (countdownFinishBlinkStep % 2 == 0);
-      for (int j = 0; j < WS2812_COUNT; j++) {
-        strip.setPixelColor(j, ledOn ? strip.Color(255, 105, 180) : 0);
-      }
-      strip.show();
-      countdownFinishBlinkStep++;
-      if (countdownFinishBlinkStep >= 6) {
-        for (int j = 0; j < WS2812_COUNT; j++) {
-          strip.setPixelColor(j, strip.Color(255, 105, 180));
-        }
-        strip.show();
-        countdownFinishAnimation = false;
-      }
-    }
+  // 秒數、暫停或結束狀態改變時更新顯示（合成器只傳送變化的字元格）
+  if (lastDisplaySeconds != safeCountdownSeconds ||
+      lastDisplayPaused != countdownPaused ||
+      lastDisplayRunning != countdownRunning) {
+    lastDisplaySeconds = safeCountdownSeconds;
+    lastDisplayPaused = countdownPaused;
+    lastDisplayRunning = countdownRunning;
+    
+    drawCountdownValues(safeCountdownSeconds);
+    ui.flush();
+  }
+}
+
+// ========== 藍牙連線逾時 ==========
+/**
+ * @brief bleTimeoutTimer 回呼：BLE_TIMEOUT 內沒有收到任何命令時視為中斷連線
+ *
+ * 畫面由 SCREEN 工作依 bleConnected 更新；CPU Loading 顏色只在藍牙畫面熄滅，
+ * 不影響 RGB Offline 與倒數完成動畫
+ */
+void bleTimeout() {
+  if (!bleConnected) {
+    return;
+  }
+  bleConnected = false;
+  if (inSubMenu && currentMenu == MENU_CONNECT_BLE) {
+    ledFx.off();
   }
 }
 
@@ -945,167 +1117,813 @@ void updateCountdown() {
  * - CONNECT：建立連線
  * - DISCONNECT：中斷連線
  * - WRITE <DEC>：寫入 EEPROM
- * - LOAD <VAL>：更新 CPU Loading 顏色
+ * - LOAD <VAL>[,<VAL>...]：更新 CPU Loading 顏色（多個值時逐顆 / 逐組顯示）
+ * - RXSTAT：查詢接收統計計數器
+ * - 以 ';' 分隔的批次命令：見 dispatchBatch()
+ * - 二進位命令框（0xA5 開頭）：見 handleBinaryFrame()
  * 
  * 效能優化：使用 C 字符陣列而非 String 物件以減少記憶體碎片化
+ * 接收方式：USART RX 中斷寫入環形緩衝區並完成分框，此處只處理完整命令
  */
 void handleBluetoothData() {
-  // 只要收到任何資料，就視為藍牙已連線（自動偵測連線）
-  if (Serial.available() > 0) {
-    // 更新最後收到資料的時間（用於逾時檢測）
-    lastBleDataTime = millis();
+  // 只要收到完整命令，就視為藍牙已連線（自動偵測連線）
+  if (bleSerial.framesReady() > 0) {
+    // 重新開始逾時計時（O(1)：從目前的槽移出再放入新的槽）
+    timers.start(&bleTimeoutTimer, BLE_TIMEOUT);
+    power.activity();
     
-    if (!bleConnected) {
-      bleConnected = true;
-      updateBleStatusText("Connected", ST77XX_GREEN);
-    }
+    bleConnected = true;  // 畫面由 SCREEN 工作更新
   }
   
-  while (Serial.available() > 0) {
-    char c = Serial.read();
+  // 一次取出一個完整命令框（分框已在 USART RX 中斷中完成）
+  BleFrameType frameType;
+  while ((frameType = bleSerial.readFrame(receivedData, BLE_BUFFER_MAX, &receivedDataLen)) != BLE_FRAME_NONE) {
+    if (frameType == BLE_FRAME_DROPPED) {
+      // 命令過長或傳輸錯誤：整框丟棄並報告錯誤
+      bleSerial.println(F("ERR"));
+      continue;
+    }
+    if (frameType == BLE_FRAME_BINARY) {
+      // 二進位命令：不輸出除錯訊息，只回覆一個位元組
+      handleBinaryFrame((const uint8_t*)receivedData, receivedDataLen);
+      continue;
+    }
     
-    if (c == '\n' || c == '\r') {
-      if (receivedDataLen > 0) {
-        // 確保字符陣列以 null 結尾
-        receivedData[receivedDataLen] = '\0';
-        
-        // 去除前導空格
-        size_t start = 0;
-        while (start < receivedDataLen && (receivedData[start] == ' ' || receivedData[start] == '\t')) {
-          start++;
-        }
-        
-        // 去除末尾空格
-        while (receivedDataLen > start && (receivedData[receivedDataLen - 1] == ' ' || 
-                                           receivedData[receivedDataLen - 1] == '\t')) {
-          receivedDataLen--;
-        }
-        
-        // 如果有前導空格，移動字符串到開頭
-        if (start > 0 && receivedDataLen > start) {
-          memmove(receivedData, receivedData + start, receivedDataLen - start);
-          receivedDataLen -= start;
-        }
-        receivedData[receivedDataLen] = '\0';
-        
-        // 除錯輸出：顯示接收到的藍牙資料
-        Serial.print("BLE RX: ");
-        Serial.println(receivedData);
-        
-        // ********WRITE 命令：寫入 EEPROM（格式：WRITE <DEC>）
-        if (strstr(receivedData, "WRITE") != NULL) {
-          // 在整個字串中搜尋第一個數字
-          char* valuePtr = receivedData;
-          while (*valuePtr != '\0' && !isdigit((unsigned char)*valuePtr)) {
-            valuePtr++;
-          }
-          
-          // 如果找到數字，提取並驗證
-          if (*valuePtr != '\0') {
-            int value = atoi(valuePtr);  // 提取數值
-            
-            // 根據 FirmwareSpec.md：接受四位二進位數值（由 PC 端轉十進位後傳送）
-            if (value >= 0 && value <= 255) {
-              writeEEPROM(value);
-              Serial.println("ACK");
-              Serial.print("EEPROM Value Set To: ");
-              Serial.println(value);
-              
-              // 更新顯示（如果在 EEPROM 選單中）
-              if (currentMenu == MENU_EEPROM && inSubMenu) {
-                displayEEPROMValue();
-              }
-            } else {
-              Serial.println("ERR");
-            }
-          } else {
-            Serial.println("ERR");
-          }
-        }
-        // ********LOAD 命令：更新 WS2812 顏色（格式：LOAD <VAL>）
-        else if (strstr(receivedData, "LOAD") != NULL) {
-          // 在整個字串中搜尋第一個數字（跳過非數字字符）
-          char* valuePtr = receivedData;
-          while (*valuePtr != '\0' && !isdigit((unsigned char)*valuePtr)) {
-            valuePtr++;
-          }
-          
-          // 如果找到數字，提取並驗證
-          if (*valuePtr != '\0') {
-            // 提取數值（atoi 會自動停止在非數字字符處）
-            int cpuLoad = atoi(valuePtr);
-            
-            // 驗證範圍：必須在 0-100 之間
-            if (cpuLoad >= 0 && cpuLoad <= 100) {
-              Serial.print("CPU Load: ");
-              Serial.println(cpuLoad);
-              
-              // 根據 CPU Loading 百分比顯示不同顏色（依 Arduino_WS2812_Integration_Guide.md 規範）
-              uint32_t color;
-              if (cpuLoad <= 50) {
-                color = strip.Color(0, 255, 0);      // 綠色：0-50% (正常負載)
-              } else if (cpuLoad <= 84) {
-                color = strip.Color(255, 255, 0);    // 黃色：51-84% (中度負載)
-              } else {
-                color = strip.Color(255, 0, 0);      // 紅色：85-100% (高負載)
-              }
-              
-              setAllWs2812(color);
-              Serial.println("ACK");
-            } else {
-              Serial.println("ERR");
-            }
-          } else {
-            Serial.println("ERR");
-          }
-        }
-        // PING 命令：心跳確認（格式：PING -> ACK）
-        else if (strcmp(receivedData, "PING") == 0) {
-          bleConnected = true;
-          Serial.println("ACK");
-        }
-        // CONNECT 命令：建立連線
-        else if (strcmp(receivedData, "CONNECT") == 0) {
-          bleConnected = true;
-          Serial.println("ACK");
-          updateBleStatusText("Connected", ST77XX_GREEN);
-        }
-        // DISCONNECT 命令：中斷連線
-        else if (strcmp(receivedData, "DISCONNECT") == 0) {
-          bleConnected = false;
-          Serial.println("ACK");
-          updateBleStatusText("Disconnect", ST77XX_RED);
-          setAllWs2812(0);
+    // 去除前導與末尾空格（只移動指標，不搬移資料）
+    char* cmd = trimCommand(receivedData, receivedData + receivedDataLen);
+    
+    // 以 ';' 分隔的多個命令：依序執行，只回覆一行狀態（不輸出除錯訊息）
+    if (strchr(cmd, ';')) {
+      dispatchBatch(cmd);
+      continue;
+    }
+    
+    // 除錯輸出：顯示接收到的藍牙資料
+    bleSerial.print(F("BLE RX: "));
+    bleSerial.println(cmd);
+    
+    // 查表分派（未知命令回覆 ERR）
+    dispatchCommand(cmd);
+  }
+}
+
+// ========== 藍牙文字命令 ==========
+/**
+ * 命令動詞為行首連續的大寫字母，其後的參數去除前導空白後交給處理函式：
+ *   "LOAD 50" / "LOAD50" -> 動詞 "LOAD"，參數 "50"
+ * 動詞必須與命令表完全相同（不再以 strstr 寬鬆比對）。
+ * 新增命令只需在 BLE_COMMANDS 加一行並實作處理函式。
+ */
+
+/**
+ * @brief 解析十進位參數（只接受純數字，不含前導 0 最多 3 位）
+ * @param args     參數字串（已去除前後空白）
+ * @param maxValue 允許的最大值
+ * @param out      輸出：解析結果
+ * @return 格式錯誤或超出範圍時回傳 false
+ */
+bool parseCommandValue(const char* args, int maxValue, int* out) {
+  if (!isNumericString(args)) {
+    return false;
+  }
+  while (args[0] == '0' && args[1] != '\0') {
+    args++;  // 略過前導 0，避免 "0050" 被長度檢查擋下
+  }
+  if (strlen(args) > 3) {
+    return false;  // 超過 3 位一定超出範圍（同時避免 atoi 溢位）
+  }
+  int value = atoi(args);
+  if (value > maxValue) {
+    return false;
+  }
+  *out = value;
+  return true;
+}
+
+// WRITE 命令：寫入 EEPROM（格式：WRITE <DEC>）
+bool cmdWrite(char* args) {
+  int value;
+  // 根據 FirmwareSpec.md：接受四位二進位數值（由 PC 端轉十進位後傳送）
+  if (!parseCommandValue(args, 255, &value)) {
+    return false;
+  }
+  applyEepromWrite(value);
+  bleSerial.println(F("ACK"));
+  bleSerial.print(F("EEPROM Value Set To: "));
+  bleSerial.println(value);
+  return true;
+}
+
+// LOAD 命令：更新 WS2812 顏色（格式：LOAD <VAL>[,<VAL>...]，每個值 0-100）
+bool cmdLoad(char* args) {
+  uint8_t loads[LED_STAGE_MAX];
+  uint8_t n = parseLoadList(args, loads);
+  if (n == 0) {
+    return false;
+  }
+  bleSerial.print(F("CPU Load: "));
+  for (uint8_t i = 0; i < n; i++) {
+    if (i) {
+      bleSerial.print(',');
+    }
+    bleSerial.print(loads[i]);
+  }
+  bleSerial.println();
+  showCpuLoads(loads, n);
+  bleSerial.println(F("ACK"));
+  return true;
+}
+
+// PING 命令：心跳確認（格式：PING -> ACK）
+bool cmdPing(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  bleConnected = true;
+  bleSerial.println(F("ACK"));
+  return true;
+}
+
+// CONNECT 命令：建立連線
+bool cmdConnect(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  bleConnected = true;
+  bleSerial.println(F("ACK"));
+  return true;
+}
+
+// DISCONNECT 命令：中斷連線
+bool cmdDisconnect(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  bleConnected = false;
+  bleSerial.println(F("ACK"));
+  ledFx.off();
+  return true;
+}
+
+// RXSTAT 命令：查詢接收統計（溢位、丟棄框、硬體錯誤）
+bool cmdRxStat(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printRxStats();
+  return true;
+}
+
+// TASKS 命令：查詢工作排程統計（執行時間、錯過截止時間、超過預算）
+bool cmdTasks(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printTaskStats();
+  return true;
+}
+
+// LEDSTAT 命令：回報 WS2812 輸出統計
+bool cmdLedStat(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printLedStats();
+  return true;
+}
+
+// FLUSH 命令：等待先前的 WRITE 全部寫入 EEPROM 後回覆 FLUSHED（由 FLUSH 工作回覆）
+// 批次中不接受（狀態 '-'）：延後的 FLUSHED 會在 BATCH 之後另外送出，違反一個批次一行回覆
+bool cmdFlush(char* args) {
+  if (*args != '\0' || batchActive) {
+    return false;
+  }
+  flushRequested = true;
+  return true;
+}
+
+// EESTAT 命令：回報 EEPROM 記錄區寫入統計
+bool cmdEeStat(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printStoreStats();
+  return true;
+}
+
+// DIM 命令：設定背光淡出時間並保存（格式：DIM <秒>，0-255，0 = 不淡出）
+bool cmdDim(char* args) {
+  int seconds;
+  if (!parseCommandValue(args, 255, &seconds)) {
+    return false;
+  }
+  settings.dimSeconds = seconds;
+  eepromStore.commit(&settings);
+  power.setDimTimeout(seconds);
+  bleSerial.println(F("ACK"));
+  return true;
+}
+
+// POWER 命令：回報各狀態的活動比例與背光狀態
+bool cmdPower(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printPowerStats();
+  return true;
+}
+
+// BTCFG 命令：回報 HC-05 開機自動設定的結果
+bool cmdBtcfg(char* args) {
+  if (*args != '\0') {
+    return false;
+  }
+  printHc05Config();
+  return true;
+}
+
+// STATS 命令：回報裝置統計；STATS RESET 清除所有統計（供 PC 端做 A/B 比較）
+bool cmdStats(char* args) {
+  if (strcmp_P(args, PSTR("RESET")) == 0) {
+    resetAllStats();
+    bleSerial.println(F("ACK"));
+    return true;
+  }
+  if (*args != '\0') {
+    return false;
+  }
+  printDeviceStats();
+  return true;
+}
+
+// 命令表：名稱、處理函式（名稱雜湊碰撞會在編譯時報錯）
+#define BLE_COMMANDS(X)          \
+  X(PING,       cmdPing)        \
+  X(CONNECT,    cmdConnect)     \
+  X(DISCONNECT, cmdDisconnect)  \
+  X(WRITE,      cmdWrite)       \
+  X(LOAD,       cmdLoad)        \
+  X(RXSTAT,     cmdRxStat)      \
+  X(TASKS,      cmdTasks)       \
+  X(EESTAT,     cmdEeStat)      \
+  X(FLUSH,      cmdFlush)       \
+  X(LEDSTAT,    cmdLedStat)     \
+  X(DIM,        cmdDim)         \
+  X(POWER,      cmdPower)       \
+  X(BTCFG,      cmdBtcfg)       \
+  X(STATS,      cmdStats)
+
+DEFINE_COMMAND_TABLE(BLE_COMMANDS)
+
+/**
+ * @brief 分派一行文字命令
+ * @param line 已去除前後空白的命令字串
+ * @return 命令存在且執行成功時回傳 true；否則已回覆 ERR
+ */
+bool dispatchCommand(char* line) {
+  char* args = line;
+  while (*args >= 'A' && *args <= 'Z') {
+    args++;
+  }
+  int8_t id = findCommand(line, (uint8_t)(args - line));
+  while (*args == ' ' || *args == '\t') {
+    args++;
+  }
+
+  if (id >= 0) {
+    commandCount[id]++;
+    CommandHandler handler = (CommandHandler)pgm_read_ptr(&commandTable[id].handler);
+    if (handler(args)) {
+      return true;
+    }
+  }
+  devStats.parseError();
+  bleSerial.println(F("ERR"));
+  return false;
+}
+
+/**
+ * @brief 去除命令前後的空格與 Tab（只移動指標並在結尾寫入 '\0'，不搬移資料）
+ * @param start 命令開頭
+ * @param end   命令結尾（最後一個字元之後）
+ * @return 去除前導空白後的命令
+ */
+char* trimCommand(char* start, char* end) {
+  while (*start == ' ' || *start == '\t') {
+    start++;
+  }
+  while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
+    end--;
+  }
+  *end = '\0';
+  return start;
+}
+
+// ========== 批次命令 ==========
+/**
+ * @brief 執行以 ';' 分隔的多個命令，回覆一行 "BATCH <狀態>"
+ * @param line 已去除前後空白的命令列，例如 "CONNECT;WRITE 5;LOAD 50"
+ *
+ * - 在接收緩衝區中原地分割（';' 改寫為 '\0'），依序交給 dispatchCommand()
+ * - 每個命令一個狀態字元：'+' 成功、'-' 未知命令或參數錯誤（空命令也是 '-'）；
+ *   失敗的命令不影響後續命令
+ * - 執行期間序列輸出靜音：各命令的 ACK / ERR 與查詢結果都不送出，
+ *   上例只回覆 "BATCH +++"（10 位元組），單獨送出則為三次 ACK 與除錯輸出
+ * - FLUSH 的回覆是延後送出的，批次中一律為 '-'（見 cmdFlush）
+ */
+void dispatchBatch(char* line) {
+  // 每段一個失敗位元（堆疊 8 位元組，不為每段保留一個字元）；
+  // 空命令也算一段：只有 ';' 的 BLE_FRAME_MAX - 1 字元行有 BLE_FRAME_MAX 段
+  uint8_t failed[(BLE_FRAME_MAX + 7) / 8];
+  uint8_t n = 0;
+
+  memset(failed, 0, sizeof(failed));
+
+  devStats.batch();
+  batchActive = true;
+  bleSerial.mute(true);
+  for (;;) {
+    char* sep = strchr(line, ';');
+    char* end = sep ? sep : line + strlen(line);
+    if (!dispatchCommand(trimCommand(line, end))) {
+      failed[n >> 3] |= 1 << (n & 7);
+    }
+    n++;
+    if (!sep) {
+      break;
+    }
+    line = sep + 1;
+  }
+  bleSerial.mute(false);
+  batchActive = false;
+
+  bleSerial.print(F("BATCH "));
+  for (uint8_t i = 0; i < n; i++) {
+    bleSerial.write((failed[i >> 3] & (1 << (i & 7))) ? '-' : '+');
+  }
+  bleSerial.println();
+}
+
+// ========== 處理二進位命令 ==========
+/**
+ * @brief 處理一個二進位命令框（由 handleBluetoothData 自動辨識）
+ * @param frame 標頭 + payload + CRC（不含同步位元組 0xA5）
+ * @param len   frame 長度
+ *
+ * 框格式：[0xA5] [opcode<<4 | len] [payload × len] [CRC-8]
+ * 回覆：成功 0x06 (ACK)，CRC 錯誤 / 未知命令 / 參數錯誤 0x15 (NAK)
+ *
+ * | opcode | 命令       | payload          |
+ * |--------|------------|------------------|
+ * | 0x1    | PING       | 無               |
+ * | 0x2    | CONNECT    | 無               |
+ * | 0x3    | DISCONNECT | 無               |
+ * | 0x4    | LOAD       | 1 ~ LED 數位元組，每個 0-100（多核心見 showCpuLoads）|
+ * | 0x5    | WRITE      | 1 位元組 (0-255) |
+ *
+ * 範例：LOAD 50 → A5 41 32 <CRC>（4 位元組），回覆 06（1 位元組）
+ */
+void handleBinaryFrame(const uint8_t* frame, size_t len) {
+  // CRC-8 驗證（範圍：標頭 + payload）
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len - 1; i++) {
+    crc = _crc8_ccitt_update(crc, frame[i]);
+  }
+  if (crc != frame[len - 1]) {
+    devStats.binaryFrame(false);
+    bleSerial.write(BLE_BIN_NAK);
+    return;
+  }
+  
+  uint8_t opcode = frame[0] >> 4;
+  uint8_t payloadLen = frame[0] & 0x0F;
+  const uint8_t* payload = frame + 1;
+  bool ok = false;
+  
+  switch (opcode) {
+    case 0x1:  // PING
+      bleConnected = true;
+      ok = true;
+      break;
+      
+    case 0x2:  // CONNECT
+      bleConnected = true;
+      ok = true;
+      break;
+      
+    case 0x3:  // DISCONNECT
+      bleConnected = false;
+      ledFx.off();
+      ok = true;
+      break;
+      
+    case 0x4:  // LOAD
+      if (payloadLen >= 1 && payloadLen <= leds.size()) {
+        ok = true;
+        for (uint8_t i = 0; i < payloadLen; i++) {
+          ok &= payload[i] <= 100;
         }
-        // 未知命令：回傳錯誤
-        else {
-          Serial.println("ERR");
+        if (ok) {
+          showCpuLoads(payload, payloadLen);
         }
-        
-        receivedDataLen = 0;  // 重置接收長度
       }
-    } else {
-      // 將字符添加到緩衝區（保留空間給 null 結尾）
-      if (receivedDataLen >= BLE_BUFFER_MAX - 1) {
-        // 緩衝區滿，清空並報告錯誤
-        receivedDataLen = 0;
-        Serial.println("ERR");
-      } else {
-        receivedData[receivedDataLen++] = c;
+      break;
+      
+    case 0x5:  // WRITE
+      if (payloadLen == 1) {
+        applyEepromWrite(payload[0]);
+        ok = true;
       }
+      break;
+  }
+  
+  devStats.binaryFrame(ok);
+  bleSerial.write(ok ? BLE_BIN_ACK : BLE_BIN_NAK);
+}
+
+// ========== CPU Loading 顏色對應 ==========
+/**
+ * @brief 根據 CPU Loading 百分比取得對應顏色（依 Arduino_WS2812_Integration_Guide.md 規範）
+ */
+uint32_t cpuLoadColor(int cpuLoad) {
+  if (cpuLoad <= 50) {
+    return strip.Color(0, 255, 0);      // 綠色：0-50% (正常負載)
+  } else if (cpuLoad <= 84) {
+    return strip.Color(255, 255, 0);    // 黃色：51-84% (中度負載)
+  }
+  return strip.Color(255, 0, 0);        // 紅色：85-100% (高負載)
+}
+
+/**
+ * @brief 解析 LOAD 參數：以逗號分隔的 1 ~ LED 數個 0-100 數值（"50" 或 "12,55,90,100"）
+ * @param args  參數字串（已去除前後空白）
+ * @param loads 輸出：各數值（至少 LED_STAGE_MAX 個位元組）
+ * @return 數值個數；格式錯誤、空欄位、超出範圍或超過 LED 數時回傳 0
+ *
+ * 單次掃描：逐字元累加，每個欄位一超過 100 立即拒絕（不需 atoi，也不會溢位）
+ */
+uint8_t parseLoadList(const char* args, uint8_t* loads) {
+  uint8_t n = 0;
+  uint16_t value = 0;  // 每位數前 ≤ 100，乘 10 加一位後最多 1009
+  bool digits = false;
+  for (;; args++) {
+    char c = *args;
+    if (c >= '0' && c <= '9') {
+      value = value * 10 + (c - '0');
+      if (value > 100) {
+        return 0;
+      }
+      digits = true;
+    } else if ((c == ',' || c == '\0') && digits) {
+      if (n >= leds.size()) {
+        return 0;
+      }
+      loads[n++] = value;
+      if (c == '\0') {
+        return n;
+      }
+      value = 0;
+      digits = false;
+    } else {
+      return 0;
+    }
+  }
+}
+
+/**
+ * @brief 以多個 CPU Loading 數值繪製 WS2812（文字與二進位 LOAD 共用）
+ * @param loads 數值（0-100）
+ * @param n     1 ~ LED 數；LED i 顯示 loads[i × n / LED 數]，
+ *              因此 1 個值為全部同色、8 個值為每顆一個核心、4 個值為每兩顆一組
+ *
+ * 整幀寫入暫存幀後只 present() 一次，由 LEDOUT 工作送出一次 strip.show()
+ */
+void showCpuLoads(const uint8_t* loads, uint8_t n) {
+  uint8_t total = leds.size();
+  ledFx.hold();
+  for (uint8_t i = 0; i < total; i++) {
+    leds.setPixel(i, cpuLoadColor(loads[(uint16_t)i * n / total]));
+  }
+  leds.present();
+}
+
+// ========== 套用 EEPROM 寫入 ==========
+/**
+ * @brief 寫入 EEPROM（文字與二進位 WRITE 命令共用）
+ * @note EEPROM 畫面由 SCREEN 工作偵測數值改變後更新
+ */
+void applyEepromWrite(int value) {
+  writeEEPROM(value);
+}
+
+// ========== 回報接收統計 ==========
+/**
+ * @brief 回傳藍牙接收統計計數器（RXSTAT 命令）
+ * 
+ * 回應格式：RXSTAT OK=<n> DROP=<n> FULL=<n> LONG=<n> DOR=<n> FE=<n> BINTO=<n>
+ * - OK：成功處理的命令數
+ * - DROP：損壞而丟棄的命令數（已回覆 ERR）
+ * - FULL：環形緩衝區空間不足而整框丟棄的次數（未回覆）
+ * - LONG：超過 64 字元的命令數
+ * - DOR / FE：USART 硬體溢位 / 框錯誤次數
+ * - BINTO：二進位命令框傳送中斷（逾時）次數
+ */
+void printRxStats() {
+  BleRxCounters c;
+  bleSerial.getCounters(&c);
+  bleSerial.print(F("RXSTAT OK="));
+  bleSerial.print(c.framesOk);
+  bleSerial.print(F(" DROP="));
+  bleSerial.print(c.framesDropped);
+  bleSerial.print(F(" FULL="));
+  bleSerial.print(c.rxRingFull);
+  bleSerial.print(F(" LONG="));
+  bleSerial.print(c.rxTooLong);
+  bleSerial.print(F(" DOR="));
+  bleSerial.print(c.rxHwOverrun);
+  bleSerial.print(F(" FE="));
+  bleSerial.print(c.rxFrameError);
+  bleSerial.print(F(" BINTO="));
+  bleSerial.println(c.rxBinTimeout);
+}
+
+// ========== 回報工作排程統計 ==========
+/**
+ * @brief 回傳各工作的排程統計（TASKS 命令）
+ * 
+ * 回應格式（每個工作一行，最後一行為切片間隔）：
+ *   TASK <名稱> N=<n> MISS=<n> OVR=<n> MAX=<us> AVG=<us>
+ *   SLICE MAX=<us>
+ * - N：執行次數；MISS：錯過截止時間次數；OVR：超過時間預算次數
+ * - MAX / AVG：單次執行時間（不含插入執行的其他工作）
+ * - SLICE MAX：相鄰切片邊界的最大間隔，即序列命令最久的等待時間
+ */
+void printTaskStats() {
+  for (uint8_t id = 0; id < sched.count(); id++) {
+    const TaskStats& s = sched.stats(id);
+    bleSerial.print(F("TASK "));
+    bleSerial.print((const __FlashStringHelper*)sched.name(id));
+    bleSerial.print(F(" N="));
+    bleSerial.print(s.runs);
+    bleSerial.print(F(" MISS="));
+    bleSerial.print(s.misses);
+    bleSerial.print(F(" OVR="));
+    bleSerial.print(s.overruns);
+    bleSerial.print(F(" MAX="));
+    bleSerial.print(s.maxRunUs);
+    bleSerial.print(F(" AVG="));
+    bleSerial.println(s.runs ? s.totalRunUs / s.runs : 0);
+  }
+  bleSerial.print(F("SLICE MAX="));
+  bleSerial.println(sched.maxSliceUs());
+}
+
+// ========== 回報 EEPROM 寫入統計 ==========
+/**
+ * @brief 回傳 EEPROM 記錄區統計（EESTAT 命令）
+ * 
+ * 回應格式：EESTAT SLOTS=<n> SLOT=<n> SEQ=<n> COMMIT=<n> SKIP=<n> MERGE=<n> BYTES=<n> BUSY=<0|1>
+ * - SLOTS：記錄區槽位數（每個位元組約每 SLOTS 次寫入才燒寫一次）
+ * - SLOT / SEQ：最新已寫入記錄的槽位與序號
+ * - COMMIT / SKIP：開機後實際寫入 / 內容未改變而略過的次數
+ * - MERGE：尚未燒寫即被下一次 WRITE 取代的次數（回寫快取合併）
+ * - BYTES：開機後實際燒寫的位元組數（每次寫入的耗損 = BYTES / COMMIT）
+ * - BUSY：還有記錄等待寫入
+ */
+void printStoreStats() {
+  StoreStats s;
+  eepromStore.getStats(&s);
+  bleSerial.print(F("EESTAT SLOTS="));
+  bleSerial.print(eepromStore.slots());
+  bleSerial.print(F(" SLOT="));
+  bleSerial.print(s.slot);
+  bleSerial.print(F(" SEQ="));
+  bleSerial.print(s.seq);
+  bleSerial.print(F(" COMMIT="));
+  bleSerial.print(s.commits);
+  bleSerial.print(F(" SKIP="));
+  bleSerial.print(s.skipped);
+  bleSerial.print(F(" MERGE="));
+  bleSerial.print(s.merged);
+  bleSerial.print(F(" BYTES="));
+  bleSerial.print(s.bytesWritten);
+  bleSerial.print(F(" BUSY="));
+  bleSerial.println(eepromStore.busy() ? 1 : 0);
+}
+
+// ========== 回報 WS2812 輸出統計 ==========
+/**
+ * @brief 回傳 WS2812 輸出級統計（LEDSTAT 命令）
+ * 
+ * 回應格式：LEDSTAT FRAMES=<n> SKIP=<n> MERGE=<n> SHOW=<n> IRQOFF=<us>
+ * - FRAMES：繪製的幀數；SKIP：與上次送出相同而略過；MERGE：送出前被下一幀取代
+ * - SHOW：實際 strip.show() 次數
+ * - IRQOFF：show() 關閉中斷的累計時間（每次 8 顆 × 30µs = 240µs）
+ */
+void printLedStats() {
+  const LedStats& s = leds.stats();
+  bleSerial.print(F("LEDSTAT FRAMES="));
+  bleSerial.print(s.frames);
+  bleSerial.print(F(" SKIP="));
+  bleSerial.print(s.skipped);
+  bleSerial.print(F(" MERGE="));
+  bleSerial.print(s.merged);
+  bleSerial.print(F(" SHOW="));
+  bleSerial.print(s.shows);
+  bleSerial.print(F(" IRQOFF="));
+  bleSerial.println(s.irqOffUs);
+}
+
+// ========== 回報 HC-05 設定 ==========
+static const char HC05_RESULT_NAMES[4][9] PROGMEM = {
+  "PENDING", "OK", "FALLBACK", "NOMODULE"  // 與 Hc05Result 順序相同
+};
+
+/**
+ * @brief 回傳 HC-05 開機自動設定的結果（BTCFG 命令）
+ *
+ * 回應格式：BTCFG NAME=<名稱> BAUD=<鮑率> RESULT=<結果> AT=<命令數> WRITES=<寫入數>
+ * - RESULT：OK（已是目標設定或已更新）、FALLBACK（模組有回應但未能提高鮑率）、
+ *   NOMODULE（沒有 AT 回覆，使用上次確認並記錄的鮑率；沒有記錄時為 9600）
+ * - WRITES：本次開機改變模組設定的命令數（設定已正確時為 0）
+ */
+void printHc05Config() {
+  bleSerial.print(F("BTCFG NAME="));
+  bleSerial.print(btName);
+  bleSerial.print(F(" BAUD="));
+  bleSerial.print(hc05.baud());
+  bleSerial.print(F(" RESULT="));
+  bleSerial.print((const __FlashStringHelper*)HC05_RESULT_NAMES[hc05.result()]);
+  bleSerial.print(F(" AT="));
+  bleSerial.print(hc05.commandCount());
+  bleSerial.print(F(" WRITES="));
+  bleSerial.println(hc05.writeCount());
+}
+
+// ========== 回報電源統計 ==========
+static const char POWER_STATE_NAMES[POWER_STATES][10] PROGMEM = {
+  "MAIN", "BLE", "RGB", "COUNTDOWN", "EEPROM"  // 與 MenuState 順序相同
+};
+
+/**
+ * @brief 回傳各狀態的活動比例與背光狀態（POWER 命令）
+ *
+ * 回應格式（每個狀態一行，最後一行為背光）：
+ *   POWER <狀態> T=<ms> ACTIVE=<x.x>%
+ *   BACKLIGHT PWM=<0-255> DIM=<秒>
+ * - T：停留在此狀態的時間（約 36 分鐘後與睡眠時間一起減半）
+ * - ACTIVE：未睡眠（CPU 執行中）的時間比例
+ */
+void printPowerStats() {
+  for (uint8_t state = 0; state < POWER_STATES; state++) {
+    uint16_t active = power.activePermille(state);
+    bleSerial.print(F("POWER "));
+    bleSerial.print((const __FlashStringHelper*)POWER_STATE_NAMES[state]);
+    bleSerial.print(F(" T="));
+    bleSerial.print(power.stats(state).totalUs / 1000);
+    bleSerial.print(F(" ACTIVE="));
+    bleSerial.print(active / 10);
+    bleSerial.print('.');
+    bleSerial.print(active % 10);
+    bleSerial.println('%');
+  }
+  bleSerial.print(F("BACKLIGHT PWM="));
+  bleSerial.print(power.backlight());
+  bleSerial.print(F(" DIM="));
+  bleSerial.println(power.dimTimeout());
+}
+
+// ========== 回報裝置統計 ==========
+/**
+ * @brief 回傳裝置統計（STATS 命令）
+ *
+ * 回應格式（五行）：
+ *   STATS T=<ms> LOOPS=<n> RATE=<n/s> MAX=<us> POLL=<us>
+ *   LOOPHIST 8=<n> 16=<n> ... 8192=<n> INF=<n>
+ *   RX OK=<n> FULL=<n> DOR=<n> DROP=<n> PARSE=<n> BIN=<n> NAK=<n>
+ *   CMD <命令>=<n> ...
+ *   OUT SHOW=<n> PIXELS=<n> EEWRITE=<n> EEBYTES=<n> KEYDROP=<n>
+ * - T：距離上一次清除的時間；RATE：每秒 loop() 次數；MAX：最長一次 loop()（不含睡眠）
+ * - POLL：相鄰切片邊界的最大間隔（序列資料最久多少時間沒有被處理，同 TASKS 的 SLICE MAX）
+ * - LOOPHIST：loop() 執行時間分組，鍵為該組上限（微秒，不含），INF 為 8192µs 以上
+ * - FULL / DOR：環形緩衝區不足 / USART 硬體溢位；DROP：損壞框（回覆 ERR）；
+ *   PARSE：文字命令分派失敗（回覆 ERR）；BIN / NAK：二進位命令框數與其中失敗數
+ * - CMD：各文字命令的收到次數（名稱正確即計入，不論參數是否正確）
+ * - SHOW：strip.show() 次數；PIXELS：合成器傳送到 TFT 的像素數；
+ *   EEWRITE / EEBYTES：實際寫入的 EEPROM 槽數與燒寫位元組數；KEYDROP：按鍵事件佇列滿而丟棄的事件數
+ */
+void printDeviceStats() {
+  uint32_t elapsed = devStats.elapsedMs();
+  bleSerial.print(F("STATS T="));
+  bleSerial.print(elapsed);
+  bleSerial.print(F(" LOOPS="));
+  bleSerial.print(devStats.loopCount());
+  bleSerial.print(F(" RATE="));
+  bleSerial.print(elapsed ? (uint32_t)((uint64_t)devStats.loopCount() * 1000 / elapsed) : 0);
+  bleSerial.print(F(" MAX="));
+  bleSerial.print(devStats.loopMaxUs());
+  bleSerial.print(F(" POLL="));
+  bleSerial.println(sched.maxSliceUs());
+
+  bleSerial.print(F("LOOPHIST"));
+  for (uint8_t b = 0; b < STATS_LOOP_BUCKETS; b++) {
+    bleSerial.print(' ');
+    if (b < STATS_LOOP_BUCKETS - 1) {
+      bleSerial.print(1UL << (b + STATS_LOOP_MIN_SHIFT));
+    } else {
+      bleSerial.print(F("INF"));
     }
+    bleSerial.print('=');
+    bleSerial.print(devStats.bucket(b));
   }
+  bleSerial.println();
+
+  BleRxCounters c;
+  bleSerial.getCounters(&c);
+  bleSerial.print(F("RX OK="));
+  bleSerial.print(c.framesOk);
+  bleSerial.print(F(" FULL="));
+  bleSerial.print(c.rxRingFull);
+  bleSerial.print(F(" DOR="));
+  bleSerial.print(c.rxHwOverrun);
+  bleSerial.print(F(" DROP="));
+  bleSerial.print(c.framesDropped);
+  bleSerial.print(F(" PARSE="));
+  bleSerial.print(devStats.parseErrorCount());
+  bleSerial.print(F(" BIN="));
+  bleSerial.print(devStats.binaryFrameCount());
+  bleSerial.print(F(" NAK="));
+  bleSerial.print(devStats.binaryNakCount());
+  bleSerial.print(F(" BATCH="));
+  bleSerial.println(devStats.batchCount());
+
+  bleSerial.print(F("CMD"));
+  for (uint8_t id = 0; id < CMD_COUNT; id++) {
+    bleSerial.print(' ');
+    bleSerial.print((const __FlashStringHelper*)pgm_read_ptr(&commandTable[id].name));
+    bleSerial.print('=');
+    bleSerial.print(commandCount[id]);
+  }
+  bleSerial.println();
+
+  StoreStats s;
+  eepromStore.getStats(&s);
+  bleSerial.print(F("OUT SHOW="));
+  bleSerial.print(leds.stats().shows);
+  bleSerial.print(F(" PIXELS="));
+  bleSerial.print(ui.stats().pixels);
+  bleSerial.print(F(" EEWRITE="));
+  bleSerial.print(s.commits);
+  bleSerial.print(F(" EEBYTES="));
+  bleSerial.print(s.bytesWritten);
+  bleSerial.print(F(" KEYDROP="));
+  bleSerial.println(keys.droppedEvents());
+}
+
+/**
+ * @brief 清除所有統計（STATS RESET）：STATS 以及 RXSTAT / TASKS / LEDSTAT / EESTAT / POWER 的計數器
+ */
+void resetAllStats() {
+  devStats.reset();
+  memset(commandCount, 0, sizeof(commandCount));
+  sched.resetStats();
+  bleSerial.resetCounters();
+  keys.resetStats();
+  leds.resetStats();
+  ui.resetStats();
+  eepromStore.resetStats();
+  power.resetStats();
+}
+
+// ========== FLUSH 回覆 ==========
+/**
+ * @brief FLUSH 工作的觸發條件：有 FLUSH 命令等待且 EEPROM 已沒有待寫入的記錄
+ */
+bool flushReady() {
+  return flushRequested && !eepromStore.busy();
+}
+
+/**
+ * @brief FLUSH 工作：回覆 FLUSHED SEQ=<n>，表示此前的 WRITE 都已寫入 EEPROM
+ */
+void reportFlushed() {
+  StoreStats s;
+  eepromStore.getStats(&s);
+  flushRequested = false;
+  bleSerial.print(F("FLUSHED SEQ="));
+  bleSerial.println(s.seq);
 }
 
 // ========== EEPROM 寫入 ==========
 // 根據 FirmwareSpec.md：接受四位二進位數值（由 PC 端轉十進位後傳送）
 // 四位二進位範圍：0000-1111 (0-15)，但規格允許更大範圍（0-255）
-// 使用簽名機制驗證 EEPROM 初始化狀態
+// 更新 RAM 設定鏡像並排入背景寫入（立即返回）；數值未改變時不燒寫 EEPROM
 void writeEEPROM(int value) {
   // 檢查數值範圍
   if (value >= 0 && value <= 255) {
-    EEPROM.write(EEPROM_ADDR_VALUE, value);      // 寫入數值
-    EEPROM.write(EEPROM_ADDR_SIGNATURE, EEPROM_SIGNATURE);  // 寫入簽名（標記為已初始化）
+    settings.storedValue = value;
+    settings.valueSet = 1;
+    eepromStore.commit(&settings);
     eepromValue = value;
     eepromValid = true;
   } else {
@@ -1115,22 +1933,25 @@ void writeEEPROM(int value) {
 }
 
 // ========== EEPROM 讀取 ==========
-// 從 EEPROM 地址讀取儲存的數值
-// 使用簽名驗證 EEPROM 的有效性（確保已初始化）
+// 掃描記錄區，載入最新一筆 CRC 正確的設定區塊
+// 找不到記錄時，若有舊版韌體的簽名則匯入其數值並寫成第一筆記錄
+// 記錄也可能只由 DIM 或 HC-05 鮑率產生：F8 數值以 valueSet 判斷是否有效
 int readEEPROM() {
-  int signature = EEPROM.read(EEPROM_ADDR_SIGNATURE);
+  if (eepromStore.begin(0, E2END + 1, sizeof(AppSettings))) {
+    eepromStore.load(&settings);
+    eepromValid = settings.valueSet;
+    return settings.storedValue;
+  }
   
-  // 檢查簽名是否正確（表示已初始化）
-  if (signature == EEPROM_SIGNATURE) {
-    int value = EEPROM.read(EEPROM_ADDR_VALUE);
-    // 驗證讀取的數值在有效範圍內
-    if (value >= 0 && value <= 255) {
-      eepromValid = true;
-      return value;
-    }
+  if (EEPROM.read(EEPROM_LEGACY_ADDR_SIGNATURE) == EEPROM_LEGACY_SIGNATURE) {
+    settings.storedValue = EEPROM.read(EEPROM_LEGACY_ADDR_VALUE);
+    settings.valueSet = 1;
+    eepromStore.commit(&settings);
+    eepromValid = true;
+    return settings.storedValue;
   }
   
-  // 若簽名不符或讀取失敗，返回 0 並標記為無效
+  // 沒有任何記錄：使用預設值並標記為無效
   // 此時需要用戶從 PC 端傳送 WRITE 命令進行初始化
   eepromValid = false;
   return 0;
@@ -1138,66 +1959,40 @@ int readEEPROM() {
 
 // ========== 顯示 EEPROM 數值 ==========
 void displayEEPROMValue() {
-  static bool displayUpdated = false;
-  static int lastDisplayValue = -1;  // 追蹤上次顯示的值
+  static int lastDisplayValue = -1;    // 追蹤上次顯示的值
+  static bool lastDisplayValid = false;
   
-  // 如果值改變或首次顯示，強制更新
-  if (!displayUpdated || lastDisplayValue != eepromValue) {
-    displayUpdated = true;
+  // 如果值改變或首次顯示，更新畫面（合成器只傳送變化的字元格）
+  if (eepromFirstDisplay || lastDisplayValue != eepromValue || lastDisplayValid != eepromValid) {
+    eepromFirstDisplay = false;
     lastDisplayValue = eepromValue;
+    lastDisplayValid = eepromValid;
     
-    tft.fillScreen(ST77XX_BLACK);
-    tft.setTextColor(ST77XX_CYAN);
-    tft.setTextSize(1);
-    tft.setCursor(50, 5);
-    tft.print("EEPROM");
-    tft.drawFastHLine(0, 17, 160, ST77XX_WHITE);
-    
-    tft.setTextColor(ST77XX_WHITE);
-    tft.setTextSize(1);
-    tft.setCursor(10, 30);
-    tft.print("Stored Value:");
-    
-    tft.setTextSize(3);
-    tft.setCursor(40, 55);
+    ui.beginScreen();
+    ui.text(UI_TITLE, 50, 5, 1, 6, F("EEPROM"), ST77XX_CYAN);
+    ui.bar(UI_RULE, 0, 17, 160, 1, ST77XX_WHITE);
+    ui.text(UI_LINE0, 10, 30, 1, 13, F("Stored Value:"), ST77XX_WHITE);
     
     if (eepromValid) {
-      tft.setTextColor(ST77XX_GREEN);
-      tft.print(eepromValue);
-      
+      ui.number(UI_MAIN, 40, 55, 3, 3, eepromValue, ST77XX_GREEN);
       // 顯示十進位說明
-      tft.setTextSize(1);
-      tft.setTextColor(ST77XX_YELLOW);
-      tft.setCursor(10, 90);
-      tft.print("(Decimal Value)");
+      ui.text(UI_DETAIL, 10, 90, 1, 15, F("(Decimal Value)"), ST77XX_YELLOW);
     } else {
-      tft.setTextColor(ST77XX_RED);
-      tft.print("ERR");
-      
-      tft.setTextSize(1);
-      tft.setCursor(10, 90);
-      tft.print("Error: EEPROM");
+      ui.text(UI_MAIN, 40, 55, 3, 3, F("ERR"), ST77XX_RED);
+      ui.text(UI_DETAIL, 10, 90, 1, 15, F("Error: EEPROM"), ST77XX_RED);
     }
     
     // 操作提示
-    tft.setTextColor(ST77XX_CYAN);
-    tft.setTextSize(1);
-    tft.setCursor(5, 112);
-    tft.print("Return:Exit");
-  }
-  
-  // 離開選單時重置標記
-  if (!inSubMenu) {
-    displayUpdated = false;
-    lastDisplayValue = -1;  // 重置比較值
+    ui.text(UI_HINT2, 5, 112, 1, 11, F("Return:Exit"), ST77XX_CYAN);
+    ui.flush();
   }
 }
 
 // ========== 取得二進位字串 ==========
-String getBinaryString(int number) {
-  String binary = "";
+// 將 number 的低 4 位元寫成 "BBBB"（out 至少 5 位元組，含結尾 '\0'）
+void getBinaryString(int number, char* out) {
   for (int i = 3; i >= 0; i--) {
-    binary += ((number >> i) & 1) ? "1" : "0";
+    *out++ = ((number >> i) & 1) ? '1' : '0';
   }
-  return binary;
+  *out = '\0';
 }
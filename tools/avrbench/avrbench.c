@@ -0,0 +1,487 @@
+/*
+ * ============================================================================
+ * avrbench.c
+ * 以 simavr 執行 uno 韌體映像，量測 loop() 延遲與各函式的 CPU 週期數
+ *
+ * 使用方式：
+ *   avrbench [-f 腳本] [-b 預算微秒] [-p 函式名稱]... firmware.elf
+ *   建議使用 tools/avrbench/run.sh（會先建置 [env:uno_bench] 再執行）
+ *
+ * 腳本語法與 [env:native] 模擬器相同（send / raw / wait / key），另外支援：
+ *   report <名稱>   輸出目前區段的統計並清除（每個選單一個區段）
+ *
+ * 量測方式：
+ * - 從 ELF 符號表找出函式進入位址（C++ 名稱以 Itanium 規則比對，例如
+ *   loop -> _Z4loopv、BleUart::onRxByte -> _ZN7BleUart8onRxByteE...）
+ * - 逐指令執行，PC 到達進入位址時記錄週期數與 SP；SP 回到呼叫前的位置
+ *   （回傳位址被 RET 取出）即視為函式結束。時間包含期間發生的中斷
+ * - 每次 loop() 結束時讀取 SRAM 中的 currentMenu / inSubMenu，分選單統計
+ * - 「輪詢間隔」為相鄰兩次進入 Scheduler::boundary()（排程切片邊界）的最大間隔，
+ *   代表序列資料最久多少時間沒有機會被 SERIAL 工作處理
+ *   （包含 PowerManager::idle() 的睡眠時間；USART RX 會立即喚醒，實際等待只會更短）
+ *
+ * 結束碼：最大輪詢間隔超過 -b 指定的預算時回傳 1（供建置流程判斷退化）
+ *
+ * 狀態：未驗證。本程式尚未在安裝 simavr 的環境中編譯或執行過（只做過語法檢查），
+ * 沒有任何量測結果，也不在 tools/sim/check.sh 的回歸流程中；
+ * 第一次執行時需確認符號比對、函式結束判斷與 currentMenu / inSubMenu 的讀取是否正確
+ * ============================================================================
+ */
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <avr_ioport.h>
+#include <avr_uart.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+
+#define F_CPU_HZ      16000000UL
+#define MAX_FUNCS     32
+#define MAX_SEND      4096
+#define KEY_HOLD_MS   80
+#define MENU_COUNT    5
+
+// ========== 量測資料 ==========
+typedef struct {
+  const char* name;      // 顯示名稱（原始輸入）
+  uint32_t addr;         // 進入位址（位元組位址）
+  int active;            // 是否正在執行
+  uint16_t entrySp;      // 進入時的 SP（已推入回傳位址）
+  uint64_t entryCycle;
+  uint64_t calls;
+  uint64_t total;
+  uint64_t max;
+} FuncStat;
+
+typedef struct {
+  uint64_t loops;
+  uint64_t total;
+  uint64_t max;
+} LoopStat;
+
+static const char* const defaultFuncs[] = {
+  "loop", "handleKeys", "handleBluetoothData", "dispatchCommand", "handleBinaryFrame",
+  "updateMainMenuItems", "displayMainMenu", "updateScreen", "updateCountdown",
+  "updateRGBOffline", "displayEEPROMValue", "LedFx::render", "updateCPULed",
+  "UiCompositor::flush", "UiCompositor::drawCell",
+  "Scheduler::boundary", "LedStage::show", "TimerWheel::run", "PowerManager::idle",
+};
+
+static const char* const menuNames[MENU_COUNT] = {
+  "MAIN", "CONNECT_BLE", "RGB_OFFLINE", "COUNTDOWN", "EEPROM"
+};
+
+static avr_t* avr;
+static FuncStat funcs[MAX_FUNCS];
+static int funcCount;
+static int loopIdx = -1;
+static int pollIdx = -1;
+
+static LoopStat menuStats[MENU_COUNT][2];  // [選單][是否在子選單]
+static uint64_t lastPoll;
+static uint64_t maxPollGap;
+static uint64_t sectionMaxPollGap;
+
+static uint32_t addrCurrentMenu;  // SRAM 位址（0 表示找不到）
+static uint32_t addrInSubMenu;
+
+// 序列埠送出佇列（依 9600bps 逐位元組送入 UART）
+static uint8_t sendBuf[MAX_SEND];
+static int sendHead, sendTail;
+static uint64_t nextByteAt;
+static uint64_t byteCycles = 10ULL * F_CPU_HZ / 9600;
+
+static int atLineStart = 1;
+
+// ========== ELF 符號 ==========
+// 產生 Itanium 名稱前綴：foo -> _Z3foo、A::b -> _ZN1A1bE
+static void mangledPrefix(const char* name, char* out, size_t size) {
+  const char* sep = strstr(name, "::");
+  if (!sep) {
+    snprintf(out, size, "_Z%zu%s", strlen(name), name);
+    return;
+  }
+  size_t n = snprintf(out, size, "_ZN");
+  const char* p = name;
+  while (p && n < size) {
+    const char* next = strstr(p, "::");
+    size_t len = next ? (size_t)(next - p) : strlen(p);
+    n += snprintf(out + n, size - n, "%zu%.*s", len, (int)len, p);
+    p = next ? next + 2 : NULL;
+  }
+  snprintf(out + n, size - n, "E");
+}
+
+static int symbolMatches(const char* sym, const char* name) {
+  char prefix[128];
+  if (strcmp(sym, name) == 0) {
+    return 1;
+  }
+  mangledPrefix(name, prefix, sizeof(prefix));
+  size_t len = strlen(prefix);
+  if (strncmp(sym, prefix, len) != 0) {
+    return 0;
+  }
+  // 前綴後必須是參數型別，不可以是更長名稱的一部分
+  return !isdigit((unsigned char)sym[len]);
+}
+
+static void loadSymbols(const char* path) {
+  elf_version(EV_CURRENT);
+  int fd = open(path, O_RDONLY);
+  Elf* elf = fd < 0 ? NULL : elf_begin(fd, ELF_C_READ, NULL);
+  if (!elf) {
+    fprintf(stderr, "avrbench: cannot read symbols from '%s'\n", path);
+    exit(2);
+  }
+
+  Elf_Scn* scn = NULL;
+  while ((scn = elf_nextscn(elf, scn)) != NULL) {
+    GElf_Shdr shdr;
+    gelf_getshdr(scn, &shdr);
+    if (shdr.sh_type != SHT_SYMTAB) {
+      continue;
+    }
+    Elf_Data* data = elf_getdata(scn, NULL);
+    size_t count = shdr.sh_size / shdr.sh_entsize;
+    for (size_t i = 0; i < count; i++) {
+      GElf_Sym sym;
+      gelf_getsym(data, i, &sym);
+      const char* name = elf_strptr(elf, shdr.sh_link, sym.st_name);
+      if (!name || !*name) {
+        continue;
+      }
+      if (GELF_ST_TYPE(sym.st_info) == STT_FUNC) {
+        for (int f = 0; f < funcCount; f++) {
+          if (funcs[f].addr == 0 && symbolMatches(name, funcs[f].name)) {
+            funcs[f].addr = (uint32_t)sym.st_value;
+          }
+        }
+      } else if (GELF_ST_TYPE(sym.st_info) == STT_OBJECT && sym.st_value >= 0x800000) {
+        // 資料符號位於 0x800000 之後（avr-gcc 的 SRAM 位址空間）
+        if (strcmp(name, "currentMenu") == 0) {
+          addrCurrentMenu = (uint32_t)sym.st_value - 0x800000;
+        } else if (strcmp(name, "inSubMenu") == 0) {
+          addrInSubMenu = (uint32_t)sym.st_value - 0x800000;
+        }
+      }
+    }
+  }
+  elf_end(elf);
+  close(fd);
+
+  for (int f = 0; f < funcCount; f++) {
+    if (funcs[f].addr == 0) {
+      fprintf(stderr, "avrbench: '%s' not found (inlined?), not profiled\n", funcs[f].name);
+    }
+    if (strcmp(funcs[f].name, "loop") == 0) {
+      loopIdx = f;
+    } else if (strcmp(funcs[f].name, "Scheduler::boundary") == 0) {
+      pollIdx = f;
+    }
+  }
+  if (!addrCurrentMenu) {
+    fprintf(stderr, "avrbench: 'currentMenu' not found, per-menu stats disabled\n");
+  }
+}
+
+static void addFunc(const char* name) {
+  if (funcCount < MAX_FUNCS) {
+    funcs[funcCount++].name = name;
+  }
+}
+
+// ========== 逐指令量測 ==========
+static uint16_t readSp(void) {
+  return avr->data[R_SPL] | (avr->data[R_SPH] << 8);
+}
+
+static void onLoopDone(uint64_t cycles) {
+  int menu = addrCurrentMenu ? avr->data[addrCurrentMenu] : 0;
+  int sub = addrInSubMenu ? (avr->data[addrInSubMenu] != 0) : 0;
+  if (menu >= MENU_COUNT) {
+    return;
+  }
+  LoopStat* s = &menuStats[menu][sub];
+  s->loops++;
+  s->total += cycles;
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+}
+
+static void profileStep(void) {
+  uint16_t sp = readSp();
+  uint32_t pc = avr->pc;
+
+  for (int f = 0; f < funcCount; f++) {
+    FuncStat* fs = &funcs[f];
+    if (fs->active && sp > fs->entrySp) {
+      uint64_t d = avr->cycle - fs->entryCycle;
+      fs->active = 0;
+      fs->calls++;
+      fs->total += d;
+      if (d > fs->max) {
+        fs->max = d;
+      }
+      if (f == loopIdx) {
+        onLoopDone(d);
+      }
+    }
+    if (!fs->active && fs->addr != 0 && pc == fs->addr) {
+      fs->active = 1;
+      fs->entrySp = sp;
+      fs->entryCycle = avr->cycle;
+      if (f == pollIdx) {
+        if (lastPoll != 0) {
+          uint64_t gap = avr->cycle - lastPoll;
+          if (gap > sectionMaxPollGap) {
+            sectionMaxPollGap = gap;
+          }
+          if (gap > maxPollGap) {
+            maxPollGap = gap;
+          }
+        }
+        lastPoll = avr->cycle;
+      }
+    }
+  }
+}
+
+// ========== 周邊注入 ==========
+static void onUartOutput(struct avr_irq_t* irq, uint32_t value, void* param) {
+  (void)irq;
+  (void)param;
+  if (atLineStart && value != '\r' && value != '\n') {
+    printf("[%10.3f] ", avr->cycle / (F_CPU_HZ / 1000.0));
+  }
+  if (value != '\r') {
+    putchar((int)value);
+  }
+  atLineStart = (value == '\n');
+}
+
+static void queueBytes(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    int next = (sendHead + 1) % MAX_SEND;
+    if (next == sendTail) {
+      fprintf(stderr, "avrbench: send queue full\n");
+      return;
+    }
+    sendBuf[sendHead] = data[i];
+    sendHead = next;
+  }
+}
+
+static void setKey(int pin, int level) {
+  avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), pin), level);
+}
+
+static void runCycles(uint64_t n) {
+  uint64_t end = avr->cycle + n;
+  while (avr->cycle < end) {
+    if (sendHead != sendTail && avr->cycle >= nextByteAt) {
+      avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT),
+                    sendBuf[sendTail]);
+      sendTail = (sendTail + 1) % MAX_SEND;
+      nextByteAt = avr->cycle + byteCycles;
+    }
+    profileStep();
+    int state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed) {
+      fprintf(stderr, "avrbench: CPU stopped (state %d) at pc=0x%04x\n", state, avr->pc);
+      exit(2);
+    }
+  }
+}
+
+static uint64_t msToCycles(double ms) {
+  return (uint64_t)(ms * (F_CPU_HZ / 1000.0));
+}
+
+static double cyclesToUs(uint64_t c) {
+  return c / (F_CPU_HZ / 1000000.0);
+}
+
+// ========== 報告 ==========
+static void report(const char* label) {
+  fprintf(stderr, "\n== %s ==\n", label);
+  fprintf(stderr, "  %-22s %8s %12s %12s\n", "function", "calls", "avg(us)", "max(us)");
+  for (int f = 0; f < funcCount; f++) {
+    FuncStat* fs = &funcs[f];
+    if (fs->calls == 0) {
+      continue;
+    }
+    fprintf(stderr, "  %-22s %8llu %12.1f %12.1f\n", fs->name, (unsigned long long)fs->calls,
+            cyclesToUs(fs->total / fs->calls), cyclesToUs(fs->max));
+    fs->calls = fs->total = fs->max = 0;
+  }
+  fprintf(stderr, "  max serial poll gap: %.1f us\n", cyclesToUs(sectionMaxPollGap));
+  sectionMaxPollGap = 0;
+}
+
+static void reportMenus(void) {
+  fprintf(stderr, "\n== loop() latency per menu ==\n");
+  fprintf(stderr, "  %-18s %10s %12s %12s\n", "menu", "loops", "avg(us)", "max(us)");
+  for (int m = 0; m < MENU_COUNT; m++) {
+    for (int sub = 0; sub < 2; sub++) {
+      LoopStat* s = &menuStats[m][sub];
+      if (s->loops == 0) {
+        continue;
+      }
+      char name[32];
+      snprintf(name, sizeof(name), "%s%s", menuNames[m], sub ? " (sub)" : "");
+      fprintf(stderr, "  %-18s %10llu %12.1f %12.1f\n", name, (unsigned long long)s->loops,
+              cyclesToUs(s->total / s->loops), cyclesToUs(s->max));
+    }
+  }
+  fprintf(stderr, "  worst serial poll gap: %.1f us\n", cyclesToUs(maxPollGap));
+}
+
+// ========== 腳本 ==========
+static int keyPin(const char* name) {
+  if (strcmp(name, "UP") == 0) return 0;      // A0 = PC0
+  if (strcmp(name, "DOWN") == 0) return 1;    // A1 = PC1
+  if (strcmp(name, "ENTER") == 0) return 2;   // A2 = PC2
+  if (strcmp(name, "RETURN") == 0) return 3;  // A3 = PC3
+  return -1;
+}
+
+static void runScriptLine(char* line) {
+  char* arg = strchr(line, ' ');
+  if (arg) {
+    *arg++ = '\0';
+  } else {
+    arg = line + strlen(line);
+  }
+
+  if (strcmp(line, "send") == 0) {
+    queueBytes((const uint8_t*)arg, strlen(arg));
+    queueBytes((const uint8_t*)"\n", 1);
+  } else if (strcmp(line, "raw") == 0) {
+    char* end;
+    for (;;) {
+      long v = strtol(arg, &end, 16);
+      if (end == arg) break;
+      uint8_t b = (uint8_t)v;
+      queueBytes(&b, 1);
+      arg = end;
+    }
+  } else if (strcmp(line, "wait") == 0) {
+    runCycles(msToCycles(atof(arg)));
+  } else if (strcmp(line, "key") == 0) {
+    char* hold = strchr(arg, ' ');
+    if (hold) {
+      *hold++ = '\0';
+    }
+    int pin = keyPin(arg);
+    if (pin < 0) {
+      fprintf(stderr, "avrbench: unknown key '%s'\n", arg);
+      return;
+    }
+    setKey(pin, 0);
+    runCycles(msToCycles(hold ? atof(hold) : KEY_HOLD_MS));
+    setKey(pin, 1);
+  } else if (strcmp(line, "report") == 0) {
+    report(*arg ? arg : "section");
+  } else if (strcmp(line, "screenshot") == 0 || strcmp(line, "bench") == 0) {
+    // 只有 [env:native] 模擬器支援，忽略
+  } else if (*line && *line != '#') {
+    fprintf(stderr, "avrbench: unknown command '%s'\n", line);
+  }
+}
+
+int main(int argc, char** argv) {
+  FILE* script = stdin;
+  double budgetUs = 0;
+  const char* elfPath = NULL;
+  int customFuncs = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      script = fopen(argv[++i], "r");
+      if (!script) {
+        fprintf(stderr, "avrbench: cannot open '%s'\n", argv[i]);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      budgetUs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      addFunc(argv[++i]);
+      customFuncs = 1;
+    } else if (argv[i][0] != '-' && !elfPath) {
+      elfPath = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [-f script] [-b budget_us] [-p function]... firmware.elf\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (!elfPath) {
+    fprintf(stderr, "avrbench: no firmware given\n");
+    return 2;
+  }
+  if (!customFuncs) {
+    for (size_t i = 0; i < sizeof(defaultFuncs) / sizeof(defaultFuncs[0]); i++) {
+      addFunc(defaultFuncs[i]);
+    }
+  } else {
+    addFunc("loop");  // per-menu 統計需要 loop()
+    addFunc("Scheduler::boundary");  // 序列輪詢間隔
+  }
+
+  elf_firmware_t fw;
+  memset(&fw, 0, sizeof(fw));
+  if (elf_read_firmware(elfPath, &fw) != 0) {
+    fprintf(stderr, "avrbench: cannot load '%s'\n", elfPath);
+    return 2;
+  }
+  avr = avr_make_mcu_by_name("atmega328p");
+  if (!avr) {
+    fprintf(stderr, "avrbench: simavr has no atmega328p core\n");
+    return 2;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &fw);
+  avr->frequency = F_CPU_HZ;
+  loadSymbols(elfPath);
+
+  // 關閉 simavr 內建的 UART 標準輸出，改由 onUartOutput() 加上時間戳記
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+                          onUartOutput, NULL);
+
+  // 按鍵未按下（外部上拉）
+  for (int pin = 0; pin < 4; pin++) {
+    setKey(pin, 1);
+  }
+
+  char buf[512];
+  while (fgets(buf, sizeof(buf), script)) {
+    buf[strcspn(buf, "\r\n")] = '\0';
+    runScriptLine(buf);
+  }
+  runCycles(msToCycles(100) + (uint64_t)((sendHead - sendTail + MAX_SEND) % MAX_SEND) * byteCycles);
+  fflush(stdout);
+
+  report("tail");
+  reportMenus();
+
+  if (budgetUs > 0 && cyclesToUs(maxPollGap) > budgetUs) {
+    fprintf(stderr, "\navrbench: FAIL serial poll gap %.1f us exceeds budget %.1f us\n",
+            cyclesToUs(maxPollGap), budgetUs);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,26 @@
+#!/bin/sh
+# ============================================================================
+# run.sh
+# 建置 [env:uno_bench] 韌體與 avrbench，並以 simavr 執行選單巡覽腳本
+#
+# 需求：PlatformIO、simavr（libsimavr-dev）、libelf-dev
+# 用法：tools/avrbench/run.sh [腳本] [預算微秒]
+#   預算為最大序列輪詢間隔（兩個排程切片邊界之間），超過時結束碼為 1
+#
+# 狀態：未驗證（avrbench.c 尚未對 simavr 編譯或執行過，見該檔說明）
+# ============================================================================
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+SCRIPT=${1:-$ROOT/tools/avrbench/menus.txt}
+BUDGET_US=${2:-20000}
+OUT=$ROOT/.pio/build/avrbench
+
+pio run -d "$ROOT" -e uno_bench
+
+mkdir -p "$OUT"
+SIMAVR_FLAGS=$(pkg-config --cflags --libs simavr 2>/dev/null || echo "-I/usr/include/simavr -lsimavr")
+cc -std=c99 -O2 -D_POSIX_C_SOURCE=200809L -o "$OUT/avrbench" "$ROOT/tools/avrbench/avrbench.c" \
+  $SIMAVR_FLAGS -lelf
+
+"$OUT/avrbench" -f "$SCRIPT" -b "$BUDGET_US" "$ROOT/.pio/build/uno_bench/firmware.elf"
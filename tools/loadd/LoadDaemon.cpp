@@ -0,0 +1,500 @@
+/*
+ * ============================================================================
+ * LoadDaemon.cpp
+ * [env:loadd] Linux 端 CPU Loading 傳送程式：取樣 /proc/stat，只在顏色區間改變時送出 LOAD
+ *
+ * 使用方式：
+ *   pio run -e loadd && .pio/build/loadd/program [選項] <序列裝置>
+ *   例如 .pio/build/loadd/program -i 250 -n 8 /dev/rfcomm0
+ *
+ * 選項：
+ *   -b <bps>   鮑率（預設 9600，與韌體相同；裝置不是終端機時忽略）
+ *   -i <ms>    取樣週期（預設 500）
+ *   -k <ms>    PING 間隔：超過此時間沒有送出任何命令時送出 PING
+ *              （預設 4500，必須小於韌體的 BLE_TIMEOUT 5000）
+ *   -n <組數>  LOAD 數值個數：1 = 全部核心合計（預設），2 ~ 8 = 依核心編號平均分組
+ *              （韌體的對應方式見 README「多核心 LOAD」）
+ *   -x         使用二進位命令框（PING 3 位元組、LOAD 3 + 組數位元組，回覆 1 位元組）
+ *   -r <s>     傳輸統計的報告間隔（預設 10；0 = 只在結束時報告；寫到 stderr）
+ *   -t <s>     執行指定秒數後結束（預設 0 = 直到 SIGINT / SIGTERM）
+ *   -s <檔>    取樣檔案（預設 /proc/stat；測試時可指定由腳本改寫的檔案）
+ *   -v         將韌體的回覆輸出到 stdout
+ *   -R <檔>    將送出的命令與韌體的回覆寫成序列流量記錄（格式見 tools/replay/SerialTrace.h，
+ *              可用 [env:native_replay] 重播並比對回覆）
+ *
+ * 傳送規則：
+ * - 負載 = 兩次取樣之間 (總時間 - idle - iowait) / 總時間，四捨五入為整數百分比
+ * - 顏色區間與韌體 cpuLoadColor() 相同：0-50 綠、51-84 黃、85-100 紅；
+ *   任一組的區間改變時才送出 LOAD（帶目前數值），同一區間內的變化不佔用頻寬
+ * - 開始時送出 CONNECT 與第一個 LOAD，結束時送出 DISCONNECT
+ * - 9600bps 約可傳 960 位元組/秒；負載穩定時只有每 4.5 秒一個 PING（約 1.1 位元組/秒）
+ *
+ * 序列裝置：任何可讀寫的字元裝置（/dev/rfcomm0、/dev/ttyUSB0、測試用的 pty 從端）；
+ * 終端機裝置設為 raw 8N1，韌體的回覆以非阻塞方式讀出（-v 時輸出，否則只計數）
+ * ============================================================================
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "../replay/SerialTrace.h"
+
+#define MAX_GROUPS 8               // 韌體的 LED 數
+#define MAX_CORES 1024
+#define FIRMWARE_TIMEOUT_MS 5000   // 韌體 BLE_TIMEOUT
+#define LOAD_YELLOW 51             // 與韌體 cpuLoadColor() 相同的區間下限
+#define LOAD_RED 85
+
+#define BIN_SYNC 0xA5
+#define BIN_OP_PING 0x1
+#define BIN_OP_CONNECT 0x2
+#define BIN_OP_DISCONNECT 0x3
+#define BIN_OP_LOAD 0x4
+
+// ========== 設定 ==========
+struct Options {
+  const char* device = NULL;
+  const char* statPath = "/proc/stat";
+  long baud = 9600;
+  long sampleMs = 500;
+  long keepaliveMs = 4500;
+  long reportSec = 10;
+  long runSec = 0;
+  int groups = 1;
+  bool binary = false;
+  bool verbose = false;
+  const char* tracePath = NULL;
+};
+
+// 傳輸統計
+struct LinkStats {
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  uint32_t loads;
+  uint32_t pings;
+  uint32_t samples;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+static FILE* traceFile = NULL;   // -R：序列流量記錄
+static int64_t traceStart = 0;
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static int64_t nowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ========== CPU 取樣 ==========
+// 一個 cpu 行的累計時間（jiffies）
+struct CpuTimes {
+  uint64_t busy;
+  uint64_t total;
+};
+
+/**
+ * @brief 讀取 /proc/stat 的 "cpu" 合計行與各 "cpuN" 行
+ * @param all   輸出：合計
+ * @param cores 輸出：各核心（最多 MAX_CORES 個）
+ * @return 核心數；無法讀取時回傳 -1
+ *
+ * 欄位：user nice system idle iowait irq softirq steal（guest 已計入 user，不重複加總）
+ */
+static int readCpuTimes(const char* path, CpuTimes* all, CpuTimes* cores) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    return -1;
+  }
+  char line[512];
+  int n = 0;
+  bool found = false;
+  while (fgets(line, sizeof(line), f)) {
+    if (strncmp(line, "cpu", 3) != 0) {
+      break;  // cpu 行都在檔案開頭
+    }
+    unsigned long long v[8] = {0};
+    const char* p = line + 3;
+    bool perCore = (*p >= '0' && *p <= '9');
+    while (*p && *p != ' ') {
+      p++;
+    }
+    if (sscanf(p, "%llu %llu %llu %llu %llu %llu %llu %llu",
+               &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) < 4) {
+      continue;
+    }
+    CpuTimes t = {0, 0};
+    for (int i = 0; i < 8; i++) {
+      t.total += v[i];
+    }
+    t.busy = t.total - v[3] - v[4];
+    if (!perCore) {
+      *all = t;
+      found = true;
+    } else if (n < MAX_CORES) {
+      cores[n++] = t;
+    }
+  }
+  fclose(f);
+  return found ? n : -1;
+}
+
+// 兩次取樣之間的負載百分比（四捨五入）；沒有經過時間時為 0
+static int loadPercent(const CpuTimes& prev, const CpuTimes& cur) {
+  uint64_t total = cur.total - prev.total;
+  uint64_t busy = cur.busy - prev.busy;
+  if (total == 0 || busy > total) {
+    return 0;
+  }
+  return (int)((busy * 200 + total) / (total * 2));
+}
+
+// 顏色區間（0 綠、1 黃、2 紅）
+static int loadBucket(int load) {
+  return (load >= LOAD_RED) ? 2 : (load >= LOAD_YELLOW) ? 1 : 0;
+}
+
+// ========== 序列裝置 ==========
+static speed_t baudConstant(long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    default: return 0;
+  }
+}
+
+/**
+ * @brief 開啟序列裝置（非阻塞）；終端機設為 raw 8N1 與指定鮑率
+ * @return 檔案描述元；失敗時回傳 -1 並輸出原因
+ */
+static int openDevice(const char* path, long baud) {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) {
+    fprintf(stderr, "loadd: %s: %s\n", path, strerror(errno));
+    return -1;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    cfsetispeed(&tio, baudConstant(baud));
+    cfsetospeed(&tio, baudConstant(baud));
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+      fprintf(stderr, "loadd: %s: tcsetattr: %s\n", path, strerror(errno));
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+}
+
+// 寫入全部資料（非阻塞裝置：緩衝區滿時等待可寫）
+static bool writeAll(int fd, const uint8_t* data, size_t len) {
+  if (traceFile) {
+    traceWrite(traceFile, (double)(nowMs() - traceStart), true, data, len);
+  }
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n > 0) {
+      data += n;
+      len -= n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      struct pollfd p = {fd, POLLOUT, 0};
+      poll(&p, 1, 100);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 讀出並計數韌體的回覆（-v 時原樣輸出；二進位模式以十六進位輸出）
+static void drainReplies(int fd, const Options& opt, LinkStats& stats) {
+  uint8_t buf[256];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    stats.rxBytes += n;
+    if (traceFile) {
+      traceWrite(traceFile, (double)(nowMs() - traceStart), false, buf, n);
+    }
+    if (!opt.verbose) {
+      continue;
+    }
+    if (opt.binary) {
+      for (ssize_t i = 0; i < n; i++) {
+        printf("%02X%s", buf[i], (buf[i] == 0x06 || buf[i] == 0x15) ? "\n" : " ");
+      }
+    } else {
+      fwrite(buf, 1, n, stdout);
+    }
+    fflush(stdout);
+  }
+}
+
+// ========== 命令 ==========
+// CRC-8（多項式 0x07、初始值 0），與韌體 _crc8_ccitt_update() 相同
+static uint8_t crc8(const uint8_t* data, size_t len) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// 二進位命令框：[0xA5] [opcode<<4 | len] [payload] [CRC-8]
+static size_t binaryFrame(uint8_t* out, uint8_t opcode, const int* values, int n) {
+  out[0] = BIN_SYNC;
+  out[1] = (uint8_t)((opcode << 4) | n);
+  for (int i = 0; i < n; i++) {
+    out[2 + i] = (uint8_t)values[i];
+  }
+  out[2 + n] = crc8(out + 1, 1 + n);
+  return 3 + n;
+}
+
+/**
+ * @brief 送出一個無參數命令（PING / CONNECT / DISCONNECT）
+ */
+static bool sendSimple(int fd, const Options& opt, LinkStats& stats, const char* text, uint8_t opcode) {
+  uint8_t buf[32];
+  size_t len;
+  if (opt.binary) {
+    len = binaryFrame(buf, opcode, NULL, 0);
+  } else {
+    len = (size_t)snprintf((char*)buf, sizeof(buf), "%s\n", text);
+  }
+  stats.txBytes += len;
+  return writeAll(fd, buf, len);
+}
+
+/**
+ * @brief 送出 LOAD（文字 "LOAD v1,v2,...\n" 或二進位 opcode 0x4）
+ */
+static bool sendLoad(int fd, const Options& opt, LinkStats& stats, const int* loads, int n) {
+  uint8_t buf[64];
+  size_t len;
+  if (opt.binary) {
+    len = binaryFrame(buf, BIN_OP_LOAD, loads, n);
+  } else {
+    char* p = (char*)buf;
+    p += sprintf(p, "LOAD ");
+    for (int i = 0; i < n; i++) {
+      p += sprintf(p, i ? ",%d" : "%d", loads[i]);
+    }
+    *p++ = '\n';
+    len = p - (char*)buf;
+  }
+  stats.txBytes += len;
+  stats.loads++;
+  return writeAll(fd, buf, len);
+}
+
+// ========== 統計報告 ==========
+static void addStats(LinkStats& into, const LinkStats& from) {
+  into.txBytes += from.txBytes;
+  into.rxBytes += from.rxBytes;
+  into.loads += from.loads;
+  into.pings += from.pings;
+  into.samples += from.samples;
+}
+
+static void report(const char* label, const LinkStats& s, double seconds, const Options& opt) {
+  double linkBytes = opt.baud / 10.0;  // 8N1：每位元組 10 位元
+  double rate = seconds > 0 ? s.txBytes / seconds : 0;
+  fprintf(stderr, "loadd: %s %.1fs TX=%llu (%.1f B/s, %.2f%% of %ld bps) RX=%llu LOAD=%u PING=%u SAMPLES=%u\n",
+          label, seconds, (unsigned long long)s.txBytes, rate, rate * 100.0 / linkBytes, opt.baud,
+          (unsigned long long)s.rxBytes, s.loads, s.pings, s.samples);
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: loadd [-b bps] [-i ms] [-k ms] [-n groups] [-x] [-r s] [-t s] [-s stat] [-v] [-R trace] <device>\n");
+  exit(2);
+}
+
+static bool parseOptions(int argc, char** argv, Options& opt) {
+  int c;
+  while ((c = getopt(argc, argv, "b:i:k:n:xr:t:s:vR:")) != -1) {
+    switch (c) {
+      case 'b': opt.baud = atol(optarg); break;
+      case 'i': opt.sampleMs = atol(optarg); break;
+      case 'k': opt.keepaliveMs = atol(optarg); break;
+      case 'n': opt.groups = atoi(optarg); break;
+      case 'x': opt.binary = true; break;
+      case 'r': opt.reportSec = atol(optarg); break;
+      case 't': opt.runSec = atol(optarg); break;
+      case 's': opt.statPath = optarg; break;
+      case 'v': opt.verbose = true; break;
+      case 'R': opt.tracePath = optarg; break;
+      default: return false;
+    }
+  }
+  if (optind != argc - 1) {
+    return false;
+  }
+  opt.device = argv[optind];
+  if (baudConstant(opt.baud) == 0) {
+    fprintf(stderr, "loadd: unsupported baud %ld\n", opt.baud);
+    return false;
+  }
+  if (opt.sampleMs < 10 || opt.keepaliveMs < 100 || opt.keepaliveMs >= FIRMWARE_TIMEOUT_MS) {
+    fprintf(stderr, "loadd: need -i >= 10 and 100 <= -k < %d\n", FIRMWARE_TIMEOUT_MS);
+    return false;
+  }
+  if (opt.groups < 1 || opt.groups > MAX_GROUPS) {
+    fprintf(stderr, "loadd: -n must be 1..%d\n", MAX_GROUPS);
+    return false;
+  }
+  return true;
+}
+
+// ========== 主迴圈 ==========
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseOptions(argc, argv, opt)) {
+    usage();
+  }
+
+  static CpuTimes prevCores[MAX_CORES], curCores[MAX_CORES];
+  CpuTimes prevAll, curAll;
+  int cores = readCpuTimes(opt.statPath, &prevAll, prevCores);
+  if (cores < 0) {
+    fprintf(stderr, "loadd: cannot read %s\n", opt.statPath);
+    return 1;
+  }
+  if (opt.groups > 1 && opt.groups > cores) {
+    fprintf(stderr, "loadd: %d cores, using %d groups\n", cores, cores);
+    opt.groups = cores > 0 ? cores : 1;
+  }
+
+  int fd = openDevice(opt.device, opt.baud);
+  if (fd < 0) {
+    return 1;
+  }
+  if (opt.tracePath) {
+    traceFile = fopen(opt.tracePath, "w");
+    if (!traceFile) {
+      fprintf(stderr, "loadd: cannot write %s: %s\n", opt.tracePath, strerror(errno));
+      return 1;
+    }
+    fputs(SERIAL_TRACE_HEADER, traceFile);
+    traceStart = nowMs();
+  }
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  LinkStats total = {}, window = {};
+  int64_t start = nowMs();
+  int64_t lastTx = start;
+  int64_t nextSample = start + opt.sampleMs;
+  int64_t windowStart = start;
+  int lastBuckets[MAX_GROUPS];
+  bool sentLoad = false;
+  bool ok = sendSimple(fd, opt, window, "CONNECT", BIN_OP_CONNECT);
+
+  while (ok && !stopRequested) {
+    int64_t now = nowMs();
+    if (opt.runSec > 0 && now - start >= opt.runSec * 1000) {
+      break;
+    }
+
+    // 取樣：任一組換區間（或第一次取樣）時送出 LOAD
+    if (now >= nextSample) {
+      nextSample += opt.sampleMs;
+      if (nextSample <= now) {
+        nextSample = now + opt.sampleMs;  // 延誤（例如系統休眠）後不補送
+      }
+      if (readCpuTimes(opt.statPath, &curAll, curCores) >= 0) {
+        int loads[MAX_GROUPS];
+        if (opt.groups == 1) {
+          loads[0] = loadPercent(prevAll, curAll);
+        } else {
+          for (int g = 0; g < opt.groups; g++) {
+            CpuTimes a = {0, 0}, b = {0, 0};
+            for (int c = g * cores / opt.groups; c < (g + 1) * cores / opt.groups; c++) {
+              a.busy += prevCores[c].busy;
+              a.total += prevCores[c].total;
+              b.busy += curCores[c].busy;
+              b.total += curCores[c].total;
+            }
+            loads[g] = loadPercent(a, b);
+          }
+        }
+        bool changed = !sentLoad;
+        for (int g = 0; g < opt.groups; g++) {
+          int bucket = loadBucket(loads[g]);
+          changed |= bucket != lastBuckets[g];
+          lastBuckets[g] = bucket;
+        }
+        if (changed) {
+          ok = sendLoad(fd, opt, window, loads, opt.groups);
+          lastTx = now;
+          sentLoad = true;
+        }
+        window.samples++;
+        prevAll = curAll;
+        memcpy(prevCores, curCores, sizeof(CpuTimes) * cores);
+      }
+    }
+
+    // 保持連線：韌體 BLE_TIMEOUT 內沒有收到任何命令就會顯示中斷
+    if (ok && now - lastTx >= opt.keepaliveMs) {
+      ok = sendSimple(fd, opt, window, "PING", BIN_OP_PING);
+      window.pings++;
+      lastTx = now;
+    }
+
+    // 週期報告
+    if (opt.reportSec > 0 && now - windowStart >= opt.reportSec * 1000) {
+      report("window", window, (now - windowStart) / 1000.0, opt);
+      addStats(total, window);
+      window = LinkStats();
+      windowStart = now;
+    }
+
+    // 等待下一個事件（取樣、PING）或韌體回覆
+    int64_t next = nextSample < lastTx + opt.keepaliveMs ? nextSample : lastTx + opt.keepaliveMs;
+    int timeout = (int)(next > now ? next - now : 0);
+    struct pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, timeout) > 0) {
+      if (p.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        fprintf(stderr, "loadd: %s: device closed\n", opt.device);
+        ok = false;
+      }
+      drainReplies(fd, opt, window);
+    }
+  }
+
+  if (ok) {
+    sendSimple(fd, opt, window, "DISCONNECT", BIN_OP_DISCONNECT);
+    tcdrain(fd);
+    usleep(50000);
+    drainReplies(fd, opt, window);
+  }
+  addStats(total, window);
+  report("total", total, (nowMs() - start) / 1000.0, opt);
+  close(fd);
+  if (traceFile) {
+    fclose(traceFile);
+  }
+  return ok ? 0 : 1;
+}
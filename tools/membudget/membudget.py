@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# ============================================================================
+# membudget.py
+# 列出韌體 ELF 中每個符號的 .data / .bss / .text 用量，超過預算時結束碼為 1
+#
+# SRAM = .data + .bss + .noinit（其餘為堆疊）；Flash = .text + .data（初始值存在 Flash）
+# PROGMEM 字串與表格在 AVR 的連結結果中屬於 .text
+#
+# 用法：tools/membudget/membudget.py [--objdump 指令] [--ram 位元組] [--flash 位元組]
+#                                      [--top N] firmware.elf
+#   --objdump 預設 avr-objdump（主機 ELF 可用 objdump）
+#   --ram / --flash 為 0 時只輸出報告不檢查
+#   一般透過 PlatformIO 目標執行：pio run -e uno -t membudget
+#   （預算設定於 platformio.ini 的 custom_membudget_ram / custom_membudget_flash）
+# ============================================================================
+import argparse
+import re
+import subprocess
+import sys
+
+RAM_SECTIONS = (".data", ".bss", ".noinit")
+REPORT_SECTIONS = (".data", ".bss", ".noinit", ".text")
+
+# objdump -h：Idx Name Size VMA LMA File-off Algn
+HEADER_RE = re.compile(r"^\s*\d+\s+(\S+)\s+([0-9a-fA-F]+)\s")
+# objdump -t：位址 旗標(7 字元) 區段 大小 名稱
+SYMBOL_RE = re.compile(r"^([0-9a-fA-F]+)\s(.{7})\s(\S+)\s+([0-9a-fA-F]+)\s+(.*)$")
+
+
+def run(objdump, *args):
+    try:
+        return subprocess.run([objdump] + list(args), check=True, capture_output=True,
+                              text=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit("membudget: %s 執行失敗：%s" % (objdump, e))
+
+
+def section_sizes(objdump, elf):
+    sizes = {}
+    for line in run(objdump, "-h", elf).splitlines():
+        m = HEADER_RE.match(line)
+        if m:
+            sizes[m.group(1)] = int(m.group(2), 16)
+    return sizes
+
+
+def symbols(objdump, elf):
+    result = {name: [] for name in REPORT_SECTIONS}
+    for line in run(objdump, "-t", "-C", elf).splitlines():
+        m = SYMBOL_RE.match(line)
+        if not m:
+            continue
+        flags, section, size, name = m.group(2), m.group(3), int(m.group(4), 16), m.group(5)
+        if section in result and size > 0 and ("O" in flags or "F" in flags):
+            result[section].append((size, name.strip()))
+    for items in result.values():
+        items.sort(key=lambda item: (-item[0], item[1]))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="per-symbol memory report with budget check")
+    parser.add_argument("--objdump", default="avr-objdump")
+    parser.add_argument("--ram", type=int, default=0, help="SRAM budget in bytes (0 = report only)")
+    parser.add_argument("--flash", type=int, default=0, help="flash budget in bytes (0 = report only)")
+    parser.add_argument("--top", type=int, default=0, help="symbols per section (0 = all)")
+    parser.add_argument("elf")
+    args = parser.parse_args()
+
+    sizes = section_sizes(args.objdump, args.elf)
+    syms = symbols(args.objdump, args.elf)
+
+    for section in REPORT_SECTIONS:
+        items = syms[section]
+        if not items and section not in sizes:
+            continue
+        print("== %s  %d bytes ==" % (section, sizes.get(section, 0)))
+        shown = items if args.top <= 0 else items[:args.top]
+        for size, name in shown:
+            print("%8d  %s" % (size, name))
+        if len(shown) < len(items):
+            rest = sum(size for size, _ in items[len(shown):])
+            print("%8d  (其他 %d 個符號)" % (rest, len(items) - len(shown)))
+        print()
+
+    ram = sum(sizes.get(name, 0) for name in RAM_SECTIONS)
+    flash = sizes.get(".text", 0) + sizes.get(".data", 0)
+    failed = False
+    for label, used, budget in (("RAM", ram, args.ram), ("FLASH", flash, args.flash)):
+        if budget > 0:
+            status = "OK" if used <= budget else "OVER"
+            failed |= used > budget
+            print("%-5s %6d / %6d bytes  %s (%+d)" % (label, used, budget, status, used - budget))
+        else:
+            print("%-5s %6d bytes" % (label, used))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,30 @@
+# ============================================================================
+# pio_membudget.py
+# PlatformIO extra script：註冊 membudget 目標（pio run -e uno -t membudget）
+#
+# 讀取環境設定：
+#   custom_membudget_ram   = SRAM 預算（.data + .bss，位元組；0 = 只輸出報告）
+#   custom_membudget_flash = Flash 預算（.text + .data，位元組；0 = 只輸出報告）
+#   custom_membudget_top   = 每個區段列出的符號數（0 = 全部）
+# ============================================================================
+import os
+
+Import("env")
+
+script = os.path.join(env.subst("$PROJECT_DIR"), "tools", "membudget", "membudget.py")
+# 與 objcopy 同一組工具鏈（uno：avr-objdump；native：objdump）
+objdump = env.subst("$OBJCOPY").replace("objcopy", "objdump")
+
+env.AddCustomTarget(
+    name="membudget",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        '"$PYTHONEXE" "%s" --objdump "%s" --ram %s --flash %s --top %s "$BUILD_DIR/${PROGNAME}.elf"'
+        % (script, objdump,
+           env.GetProjectOption("custom_membudget_ram", "0"),
+           env.GetProjectOption("custom_membudget_flash", "0"),
+           env.GetProjectOption("custom_membudget_top", "0"))
+    ],
+    title="Memory budget",
+    description="Per-symbol .data/.bss/.text report; fails when over budget",
+)
@@ -0,0 +1,772 @@
+/*
+ * ============================================================================
+ * ReplayMain.cpp
+ * [env:native_replay] 序列流量重播：將記錄或合成的 RX 流量送進真正的 handleBluetoothData()
+ *
+ * 使用方式：
+ *   .pio/build/native_replay/program [選項] <記錄檔>     重播記錄並比對回覆
+ *   .pio/build/native_replay/program [選項] -z <案例數>  產生模糊測試流量並檢查回覆
+ *   記錄格式見 SerialTrace.h；tools/loadd 的 -R 可在實機連線上錄製
+ *
+ * 選項：
+ *   -B <bps>  PC 端送出速率（預設依韌體設定的 UBRR0；沒有 HC-05 模型時為 9600）
+ *   -w <檔>   將重播結果（RX 與實際回覆）寫成新的記錄檔（產生比對基準、保存失敗案例）
+ *   -x <動詞> 不比對此命令的回覆（可重複；例如 STATS、TASKS 這類含時間的查詢）
+ *   -S <種子> 模糊測試的亂數種子（預設 1；相同種子產生相同流量）
+ *   -v        列出全部差異 / 失敗案例（預設只列前 10 個）
+ *
+ * 重播方式：
+ * - setup() 後先執行 loop() 4 秒（開機畫面與 HC-05 探測），之後的輸出才開始記錄
+ * - 每筆 RX 依記錄時間送出，位元組依鮑率到達 USART；期間不執行 loop()，
+ *   只要有完整命令框就立刻呼叫 handleBluetoothData() 並量測主機執行時間
+ *   （理想的服務延遲：不會因排程延誤而觸發環形緩衝區不足）
+ * - 兩筆 RX 之間執行 loop()（LED、計時器、EEPROM 背景寫入、FLUSH 回覆照常運作）
+ * - 一筆 RX 之後到下一筆 RX 之前的所有輸出為此 RX 的回覆，與記錄中同一區間的 TX 比對；
+ *   記錄中沒有任何 TX 時（合成流量）只統計不比對
+ *
+ * 模糊測試（-z）針對 64 位元組命令框上限（BLE_FRAME_MAX）與分框狀態機：
+ *   LENGTH   前後補空白的 PING，長度 BLE_FRAME_MAX-4 ~ BLE_FRAME_MAX+3，結尾 \n / \r / \r\n
+ *   SPLIT    同上，分成 2 ~ 3 段、間隔 0 ~ 40ms 送出
+ *   BATCH    長度在上限附近的批次：串接的 PING、整行只有 ';'、隨機的空命令 / PING / 未知命令，
+ *            依每段內容預期 "BATCH <狀態>"
+ *   GARBAGE  任意位元組（含 0x00、0x18、0xA5 與 0 ~ 50% 的 ';'，不含結尾）組成的一行，
+ *            應只回覆一行 ERR 或 BATCH
+ *   BINARY   正確 / CRC 錯誤 / 中途停止的二進位命令框
+ *   BURST    2 ~ 5 行最大長度的命令連續送出
+ *   RECOVERY 任意位元組後停頓 30ms 再送 "\nPING\n"，必須回覆 ACK（分框狀態機恢復同步）
+ * 另外檢查每一行 "BLE RX: " 回顯不超過 BLE_FRAME_MAX - 1 字元；有失敗時結束碼為 1
+ *
+ * 記憶體錯誤（例如命令處理中的堆疊陣列越界）不一定改變回覆，
+ * 模糊測試應同時以 [env:native_replay_asan]（-fsanitize=address,undefined）執行：
+ *   pio run -e native_replay_asan && .pio/build/native_replay_asan/program -z 20000
+ * ============================================================================
+ */
+
+#include <Arduino.h>
+#include <BleUart.h>
+#include <DeviceStats.h>
+#include <HalSim.h>
+#include <stdio.h>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "SerialTrace.h"
+
+void setup();
+void loop();
+void handleBluetoothData();
+extern char receivedData[];
+
+namespace {
+
+#define REPLAY_BOOT_MS 4000        // 開機後等待時間（與模擬腳本的 wait 4000 相同）
+#define REPLAY_TAIL_MS 200         // 最後一筆 RX 之後繼續執行的時間（收集延後的回覆）
+#define REPLAY_LOOP_US 20          // 每次 loop() 額外計入的 CPU 時間（與 tools/sim 預設相同）
+#define REPLAY_LIST_MAX 10         // 未指定 -v 時列出的差異數
+#define FUZZ_GAP_MS 30             // 案例之間的停頓（大於 BLE_BIN_TIMEOUT_MS）
+
+// ===== 記錄 =====
+struct Event {
+  double ms;
+  bool rx;
+  std::string data;
+};
+
+// 一筆 RX 與它之後到下一筆 RX 之前的回覆
+struct Window {
+  double ms;             // 實際送出時間（相對於重播開始）
+  std::string rx;
+  std::string expected;  // 記錄中的回覆
+  std::string actual;    // 重播的回覆
+};
+
+// 各命令的處理時間（依 handleBluetoothData() 處理的最後一個框分類）
+struct CommandStat {
+  uint32_t count = 0;
+  double totalNs = 0;
+  double maxNs = 0;
+};
+
+uint32_t lineBaud = 0;
+FILE* traceOut = NULL;
+uint64_t replayStart = 0;
+std::string txPending;                       // 尚未寫入 -w 記錄的輸出
+double txPendingMs = 0;                      // txPending 第一個位元組的時間
+std::string* txWindow = NULL;                // 目前 RX 區間的回覆
+std::map<std::string, CommandStat> commandStats;
+uint32_t commandTotal = 0;
+double handlerNs = 0;
+
+double replayMs() {
+  return (HalSim::cycles() - replayStart) * 1000.0 / F_CPU;
+}
+
+void captureTx(uint8_t c) {
+  if (txPending.empty()) {
+    txPendingMs = replayMs();
+  }
+  txPending.push_back((char)c);
+  if (txWindow) {
+    txWindow->push_back((char)c);
+  }
+}
+
+// 將目前累積的輸出寫成一筆 TX 記錄
+void flushTx() {
+  if (traceOut && !txPending.empty()) {
+    traceWrite(traceOut, txPendingMs, false, (const uint8_t*)txPending.data(), txPending.size());
+  }
+  txPending.clear();
+}
+
+void runUntil(uint64_t end) {
+  while (HalSim::cycles() < end) {
+    loop();
+    HalSim::advanceMicros(REPLAY_LOOP_US);
+  }
+}
+
+// ========== 命令處理量測 ==========
+/**
+ * @brief 呼叫 handleBluetoothData() 並依計數器變化分類最後處理的命令框：
+ *        (DROP) 損壞框、(BIN) 二進位框、(BATCH) 批次、(ERR) 未知命令或參數錯誤，其餘為命令動詞
+ */
+void timedHandle() {
+  BleRxCounters before, after;
+  bleSerial.getCounters(&before);
+  uint16_t bin = devStats.binaryFrameCount();
+  uint16_t batches = devStats.batchCount();
+  uint16_t errors = devStats.parseErrorCount();
+  uint8_t frames = bleSerial.framesReady();
+
+  auto start = std::chrono::steady_clock::now();
+  handleBluetoothData();
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  bleSerial.getCounters(&after);
+  std::string name;
+  if (after.framesDropped != before.framesDropped) {
+    name = "(DROP)";
+  } else if (devStats.binaryFrameCount() != bin) {
+    name = "(BIN)";
+  } else if (devStats.batchCount() != batches) {
+    name = "(BATCH)";
+  } else if (devStats.parseErrorCount() != errors) {
+    name = "(ERR)";
+  } else {
+    const char* p = receivedData;
+    while (*p == ' ' || *p == '\t') {
+      p++;
+    }
+    while (*p >= 'A' && *p <= 'Z') {
+      name.push_back(*p++);
+    }
+  }
+
+  CommandStat& s = commandStats[name];
+  s.count += frames;
+  s.totalNs += ns;
+  if (ns > s.maxNs) {
+    s.maxNs = ns;
+  }
+  commandTotal += frames;
+  handlerNs += ns;
+}
+
+/**
+ * @brief 送出一筆 RX，位元組到達期間有完整命令框就立刻處理
+ */
+void feed(const std::string& data) {
+  uint32_t baud = lineBaud ? lineBaud : HalSim::serialBaud();
+  uint64_t stepUs = 2500000UL / baud;  // 約 1/4 個位元組時間
+  if (stepUs == 0) {
+    stepUs = 1;
+  }
+  HalSim::serialSend((const uint8_t*)data.data(), data.size());
+  while (HalSim::serialPending() > 0 || bleSerial.framesReady() > 0) {
+    if (bleSerial.framesReady() > 0) {
+      timedHandle();
+    } else {
+      HalSim::advanceMicros(stepUs);
+    }
+  }
+}
+
+// ========== 重播 ==========
+/**
+ * @brief 依記錄時間送出每筆 RX，收集各區間的回覆
+ * @param events  記錄（TX 只作為比對基準）
+ * @param windows 輸出：每筆 RX 一個區間
+ */
+void replay(const std::vector<Event>& events, std::vector<Window>& windows) {
+  // 先建立全部區間（之後 txWindow 指向的位置不會再移動）；RX 之前的 TX 不屬於任何區間
+  size_t rxCount = 0;
+  for (const Event& e : events) {
+    rxCount += e.rx ? 1 : 0;
+  }
+  windows.assign(rxCount, Window());
+  size_t w = 0;
+  for (const Event& e : events) {
+    if (e.rx) {
+      windows[w++].rx = e.data;
+    } else if (w > 0) {
+      windows[w - 1].expected += e.data;
+    }
+  }
+
+  w = 0;
+  for (const Event& e : events) {
+    if (!e.rx) {
+      continue;
+    }
+    runUntil(replayStart + (uint64_t)(e.ms * (F_CPU / 1000.0)));
+    flushTx();
+    Window& win = windows[w++];
+    win.ms = replayMs();
+    txWindow = &win.actual;
+    if (traceOut) {
+      traceWrite(traceOut, win.ms, true, (const uint8_t*)e.data.data(), e.data.size());
+    }
+    feed(e.data);
+    flushTx();
+  }
+  runUntil(HalSim::cycles() + (uint64_t)REPLAY_TAIL_MS * (F_CPU / 1000UL));
+  flushTx();
+  txWindow = NULL;
+}
+
+bool loadTrace(const char* path, std::vector<Event>& events) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "replay: cannot open '%s'\n", path);
+    return false;
+  }
+  char buf[4096];
+  int lineNo = 0;
+  double last = 0;
+  while (fgets(buf, sizeof(buf), f)) {
+    lineNo++;
+    Event e;
+    int r = traceParse(buf, &e.ms, &e.rx, &e.data);
+    if (r == 0) {
+      continue;
+    }
+    if (r < 0 || e.ms < last) {
+      fprintf(stderr, "replay: %s:%d: %s\n", path, lineNo, r < 0 ? "malformed record" : "time goes backwards");
+      fclose(f);
+      return false;
+    }
+    last = e.ms;
+    events.push_back(e);
+  }
+  fclose(f);
+  return true;
+}
+
+// ========== 報告 ==========
+void reportCommands(double virtualMs) {
+  fprintf(stderr, "replay: %u commands  handler %.3f ms  %.0f cmd/s  (virtual %.1f s at %u bps)\n",
+          (unsigned)commandTotal, handlerNs / 1e6, handlerNs > 0 ? commandTotal * 1e9 / handlerNs : 0.0,
+          virtualMs / 1000.0, (unsigned)(lineBaud ? lineBaud : HalSim::serialBaud()));
+  fprintf(stderr, "  %-12s %8s %10s %10s\n", "command", "count", "avg ns", "max ns");
+  for (const auto& it : commandStats) {
+    const CommandStat& s = it.second;
+    fprintf(stderr, "  %-12s %8u %10.0f %10.0f\n", it.first.empty() ? "(EMPTY)" : it.first.c_str(),
+            (unsigned)s.count, s.count ? s.totalNs / s.count : 0.0, s.maxNs);
+  }
+}
+
+// RX 的命令動詞（行首空白之後的連續大寫字母）
+std::string rxVerb(const std::string& rx) {
+  size_t i = 0;
+  while (i < rx.size() && (rx[i] == ' ' || rx[i] == '\t')) {
+    i++;
+  }
+  size_t start = i;
+  while (i < rx.size() && rx[i] >= 'A' && rx[i] <= 'Z') {
+    i++;
+  }
+  return rx.substr(start, i - start);
+}
+
+/**
+ * @brief 比對各區間的回覆
+ * @return 不同的區間數
+ */
+int compareWindows(const std::vector<Window>& windows, const std::vector<std::string>& ignore, bool verbose) {
+  int differ = 0, skipped = 0;
+  for (const Window& w : windows) {
+    bool skip = false;
+    for (const std::string& verb : ignore) {
+      skip |= rxVerb(w.rx) == verb;
+    }
+    if (skip) {
+      skipped++;
+      continue;
+    }
+    if (w.expected == w.actual) {
+      continue;
+    }
+    if (differ++ < REPLAY_LIST_MAX || verbose) {
+      fprintf(stderr, "diff at %.3f ms  RX \"%s\"\n", w.ms, traceEscape(w.rx).c_str());
+      fprintf(stderr, "  recorded \"%s\"\n", traceEscape(w.expected).c_str());
+      fprintf(stderr, "  replayed \"%s\"\n", traceEscape(w.actual).c_str());
+    }
+  }
+  fprintf(stderr, "responses: %u compared  %d differ  %d skipped\n",
+          (unsigned)(windows.size() - skipped), differ, skipped);
+  return differ;
+}
+
+// ========== 模糊測試 ==========
+enum FuzzKind { FUZZ_LENGTH, FUZZ_SPLIT, FUZZ_BATCH, FUZZ_GARBAGE, FUZZ_BINARY, FUZZ_BURST, FUZZ_RECOVERY, FUZZ_KINDS };
+
+const char* const FUZZ_NAMES[FUZZ_KINDS] = {"LENGTH", "SPLIT", "BATCH", "GARBAGE", "BINARY", "BURST", "RECOVERY"};
+
+// 一個案例：連續的數筆 RX 與預期回覆
+struct FuzzCase {
+  FuzzKind kind;
+  size_t first;          // 第一筆 RX 的區間索引
+  size_t count;          // RX 筆數
+  int acks;              // 預期 "ACK" 行數（-1 = 不檢查）
+  int errs;              // 預期 "ERR" 行數（-1 = 不檢查）
+  int replies;           // 預期 "ERR" 與 "BATCH ..." 合計行數（-1 = 不檢查）
+  std::string exact;     // 非空：全部回覆必須完全相同
+  std::string suffix;    // 非空：最後一筆 RX 的回覆必須以此結尾
+};
+
+struct FuzzGen {
+  std::mt19937 rng;
+  std::vector<Event> events;
+  std::vector<FuzzCase> cases;
+  double ms = 0;
+  double byteMs = 0;  // 每位元組的傳輸時間（停頓從上一筆送完後起算）
+
+  int uniform(int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+  }
+
+  void rx(const std::string& data, double gapMs) {
+    ms += gapMs;
+    events.push_back(Event{ms, true, data});
+    ms += data.size() * byteMs;
+  }
+
+  // 開始一個案例（與前一個案例間隔 FUZZ_GAP_MS）
+  FuzzCase& begin(FuzzKind kind) {
+    FuzzCase c;
+    c.kind = kind;
+    c.first = 0;
+    for (const Event& e : events) {
+      c.first += e.rx ? 1 : 0;
+    }
+    c.count = 0;
+    c.acks = -1;
+    c.errs = -1;
+    c.replies = -1;
+    cases.push_back(c);
+    ms += FUZZ_GAP_MS;
+    return cases.back();
+  }
+
+  void end() {
+    size_t n = 0;
+    for (const Event& e : events) {
+      n += e.rx ? 1 : 0;
+    }
+    cases.back().count = n - cases.back().first;
+  }
+
+  // 將命令前後補上空白 / Tab 到指定長度
+  std::string pad(const std::string& cmd, int len) {
+    int fill = len - (int)cmd.size();
+    int before = fill > 0 ? uniform(0, fill) : 0;
+    std::string out;
+    for (int i = 0; i < fill; i++) {
+      char c = uniform(0, 3) ? ' ' : '\t';
+      if (i == before) {
+        out += cmd;
+      }
+      out.push_back(c);
+    }
+    if (before >= fill) {
+      out += cmd;
+    }
+    return out;
+  }
+
+  std::string terminator() {
+    static const char* const ENDS[] = {"\n", "\r", "\r\n"};
+    return ENDS[uniform(0, 2)];
+  }
+
+  uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= data[i];
+      for (int b = 0; b < 8; b++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+      }
+    }
+    return crc;
+  }
+
+  void length(bool split) {
+    int len = uniform(BLE_FRAME_MAX - 4, BLE_FRAME_MAX + 3);
+    std::string line = pad("PING", len) + terminator();
+    FuzzCase& c = begin(split ? FUZZ_SPLIT : FUZZ_LENGTH);
+    bool fits = len <= BLE_FRAME_MAX - 1;
+    c.acks = fits ? 1 : 0;
+    c.errs = fits ? 0 : 1;
+    if (!split) {
+      rx(line, 0);
+    } else {
+      size_t a = uniform(1, line.size() - 1);
+      size_t b = uniform(a, line.size() - 1);
+      rx(line.substr(0, a), 0);
+      if (b > a) {
+        rx(line.substr(a, b - a), uniform(0, 40));
+      }
+      rx(line.substr(b), uniform(0, 40));
+    }
+    end();
+  }
+
+  // 批次的預期狀態：每段去除空白後為 PING 是 '+'，其餘（含空命令）為 '-'
+  std::string batchStatus(const std::string& line) {
+    std::string status;
+    size_t start = 0;
+    for (;;) {
+      size_t sep = line.find(';', start);
+      std::string seg = line.substr(start, sep == std::string::npos ? std::string::npos : sep - start);
+      size_t a = seg.find_first_not_of(" \t");
+      size_t b = seg.find_last_not_of(" \t");
+      status.push_back(a != std::string::npos && seg.substr(a, b - a + 1) == "PING" ? '+' : '-');
+      if (sep == std::string::npos) {
+        return status;
+      }
+      start = sep + 1;
+    }
+  }
+
+  /**
+   * 批次命令，長度在上限附近或填滿整個框：
+   * 0 = 串接的 PING（補空白）、1 = 整行只有 ';'、2 = 隨機的空命令 / 空白 / PING / 未知命令
+   */
+  void batch() {
+    static const char* const SEGMENTS[] = {"", "", "PING", " PING ", "  ", "X"};
+    int len = uniform(BLE_FRAME_MAX - 6, BLE_FRAME_MAX + 4);
+    int variant = uniform(0, 2);
+    std::string line;
+    if (variant == 0) {
+      line = "PING";
+      while ((int)line.size() + 5 <= len) {
+        line += ";PING";
+      }
+      line = pad(line, len);
+    } else if (variant == 1) {
+      line.assign(len, ';');
+    } else {
+      line = SEGMENTS[uniform(0, 5)];
+      while (true) {
+        std::string next = std::string(";") + SEGMENTS[uniform(0, 5)];
+        if ((int)(line.size() + next.size()) > len) {
+          break;
+        }
+        line += next;
+      }
+      line.append(len - line.size(), ';');
+    }
+    FuzzCase& c = begin(FUZZ_BATCH);
+    if (len <= BLE_FRAME_MAX - 1) {
+      c.exact = "BATCH " + batchStatus(line) + "\r\n";
+    } else {
+      c.exact = "ERR\r\n";
+    }
+    rx(line + terminator(), 0);
+    end();
+  }
+
+  // 任意位元組的一行（';' 的比例 0 ~ 50%，含 ';' 時為批次）：只能有一行 ERR 或 BATCH 回覆
+  void garbage() {
+    int len = uniform(1, 100);
+    int semicolons = uniform(0, 4);
+    std::string line;
+    while ((int)line.size() < len) {
+      uint8_t b = uniform(0, 7) < semicolons ? ';' : uniform(0, 255);
+      if (b == '\r' || b == '\n' || (line.empty() && b == BLE_BIN_SYNC)) {
+        continue;
+      }
+      line.push_back((char)b);
+    }
+    FuzzCase& c = begin(FUZZ_GARBAGE);
+    c.acks = 0;
+    c.replies = 1;
+    rx(line + "\n", 0);
+    end();
+  }
+
+  void binary() {
+    uint8_t frame[BLE_BIN_FRAME_MAX];
+    int variant = uniform(0, 3);
+    FuzzCase& c = begin(FUZZ_BINARY);
+    frame[0] = BLE_BIN_SYNC;
+    if (variant == 0) {
+      // 正確的 PING
+      frame[1] = 0x10;
+      frame[2] = crc8(frame + 1, 1);
+      c.exact = "\x06";
+      rx(std::string((const char*)frame, 3), 0);
+    } else if (variant == 1) {
+      // 任意 opcode / payload，CRC 錯誤
+      uint8_t len = uniform(0, BLE_BIN_PAYLOAD_MAX);
+      frame[1] = (uint8_t)(uniform(0, 15) << 4) | len;
+      for (uint8_t i = 0; i < len; i++) {
+        frame[2 + i] = uniform(0, 255);
+      }
+      frame[2 + len] = crc8(frame + 1, 1 + len) ^ (uint8_t)uniform(1, 255);
+      c.exact = "\x15";
+      rx(std::string((const char*)frame, 3 + len), 0);
+    } else if (variant == 2) {
+      // 任意 opcode / payload，CRC 正確：只檢查回覆一個 ACK / NAK 位元組
+      uint8_t len = uniform(0, BLE_BIN_PAYLOAD_MAX);
+      frame[1] = (uint8_t)(uniform(0, 15) << 4) | len;
+      for (uint8_t i = 0; i < len; i++) {
+        frame[2 + i] = uniform(0, 255);
+      }
+      frame[2 + len] = crc8(frame + 1, 1 + len);
+      c.exact = "?";  // 由 checkCase() 特別處理
+      rx(std::string((const char*)frame, 3 + len), 0);
+    } else {
+      // 送到一半停止：逾時後補 0 結束（NAK），之後的文字命令正常處理
+      uint8_t len = uniform(1, BLE_BIN_PAYLOAD_MAX);
+      frame[1] = 0x40 | len;
+      int sent = uniform(1, 1 + len);
+      for (int i = 2; i <= sent; i++) {
+        frame[i] = uniform(0, 100);
+      }
+      c.exact = "\x15" "BLE RX: PING\r\nACK\r\n";
+      rx(std::string((const char*)frame, sent), 0);
+      rx("PING\n", FUZZ_GAP_MS);
+    }
+    end();
+  }
+
+  void burst() {
+    int n = uniform(2, 5);
+    std::string data;
+    for (int i = 0; i < n; i++) {
+      data += pad("PING", BLE_FRAME_MAX - 1) + "\n";
+    }
+    FuzzCase& c = begin(FUZZ_BURST);
+    c.acks = n;
+    c.errs = 0;
+    rx(data, 0);
+    end();
+  }
+
+  void recovery() {
+    int chunks = uniform(1, 3);
+    FuzzCase& c = begin(FUZZ_RECOVERY);
+    c.suffix = "BLE RX: PING\r\nACK\r\n";
+    for (int i = 0; i < chunks; i++) {
+      std::string data;
+      int len = uniform(1, 50);
+      for (int j = 0; j < len; j++) {
+        data.push_back((char)uniform(0, 255));
+      }
+      rx(data, i ? uniform(0, FUZZ_GAP_MS) : 0);
+    }
+    rx("\nPING\n", FUZZ_GAP_MS);
+    end();
+  }
+
+  void generate(int count) {
+    for (int i = 0; i < count; i++) {
+      switch ((FuzzKind)(i % FUZZ_KINDS)) {
+        case FUZZ_LENGTH: length(false); break;
+        case FUZZ_SPLIT: length(true); break;
+        case FUZZ_BATCH: batch(); break;
+        case FUZZ_GARBAGE: garbage(); break;
+        case FUZZ_BINARY: binary(); break;
+        case FUZZ_BURST: burst(); break;
+        default: recovery(); break;
+      }
+    }
+  }
+};
+
+// 完全等於 line（prefix = true 時以 line 開頭）的行數
+int countLines(const std::string& text, const char* line, bool prefix = false) {
+  int n = 0;
+  std::string want = prefix ? std::string(line) : std::string(line) + "\r\n";
+  for (size_t pos = 0; (pos = text.find(want, pos)) != std::string::npos; pos += want.size()) {
+    n += (pos == 0 || text[pos - 1] == '\n') ? 1 : 0;
+  }
+  return n;
+}
+
+// 回顯長度：每一行 "BLE RX: " 之後不超過 BLE_FRAME_MAX - 1 字元
+bool echoFits(const std::string& text) {
+  for (size_t pos = 0; (pos = text.find("BLE RX: ", pos)) != std::string::npos; pos++) {
+    size_t end = text.find("\r\n", pos);
+    if (end != std::string::npos && end - pos - 8 > BLE_FRAME_MAX - 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool checkCase(const FuzzCase& c, const std::vector<Window>& windows) {
+  std::string all;
+  for (size_t i = c.first; i < c.first + c.count; i++) {
+    all += windows[i].actual;
+  }
+  if (!echoFits(all)) {
+    return false;
+  }
+  if (c.exact == "?") {
+    return all == "\x06" || all == "\x15";
+  }
+  if (!c.exact.empty() && all != c.exact) {
+    return false;
+  }
+  if (!c.suffix.empty()) {
+    const std::string& last = windows[c.first + c.count - 1].actual;
+    if (last.size() < c.suffix.size() || last.compare(last.size() - c.suffix.size(), c.suffix.size(), c.suffix) != 0) {
+      return false;
+    }
+  }
+  if (c.acks >= 0 && countLines(all, "ACK") != c.acks) {
+    return false;
+  }
+  if (c.errs >= 0 && countLines(all, "ERR") != c.errs) {
+    return false;
+  }
+  if (c.replies >= 0 && countLines(all, "ERR") + countLines(all, "BATCH ", true) != c.replies) {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 檢查全部案例並輸出各類別的結果
+ * @return 失敗的案例數
+ */
+int checkFuzz(const FuzzGen& gen, const std::vector<Window>& windows, bool verbose) {
+  int total[FUZZ_KINDS] = {0}, failed[FUZZ_KINDS] = {0};
+  int failures = 0;
+  for (const FuzzCase& c : gen.cases) {
+    total[c.kind]++;
+    if (checkCase(c, windows)) {
+      continue;
+    }
+    failed[c.kind]++;
+    if (failures++ < REPLAY_LIST_MAX || verbose) {
+      fprintf(stderr, "fail %s at %.3f ms\n", FUZZ_NAMES[c.kind], windows[c.first].ms);
+      for (size_t i = c.first; i < c.first + c.count; i++) {
+        fprintf(stderr, "  RX \"%s\"\n  -> \"%s\"\n", traceEscape(windows[i].rx).c_str(),
+                traceEscape(windows[i].actual).c_str());
+      }
+    }
+  }
+  fprintf(stderr, "fuzz: %u cases  %d failed\n", (unsigned)gen.cases.size(), failures);
+  for (int k = 0; k < FUZZ_KINDS; k++) {
+    fprintf(stderr, "  %-9s %6d cases %6d failed\n", FUZZ_NAMES[k], total[k], failed[k]);
+  }
+  return failures;
+}
+
+void usage(const char* prog) {
+  fprintf(stderr, "usage: %s [-B bps] [-w out.trace] [-x VERB]... [-v] <trace>\n", prog);
+  fprintf(stderr, "       %s [-B bps] [-w out.trace] [-S seed] [-v] -z <cases>\n", prog);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* tracePath = NULL;
+  const char* outPath = NULL;
+  std::vector<std::string> ignore;
+  int fuzzCases = 0;
+  unsigned seed = 1;
+  bool verbose = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "-B" && i + 1 < argc) {
+      lineBaud = atol(argv[++i]);
+    } else if (a == "-w" && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (a == "-x" && i + 1 < argc) {
+      ignore.push_back(argv[++i]);
+    } else if (a == "-z" && i + 1 < argc) {
+      fuzzCases = atoi(argv[++i]);
+    } else if (a == "-S" && i + 1 < argc) {
+      seed = strtoul(argv[++i], NULL, 10);
+    } else if (a == "-v") {
+      verbose = true;
+    } else if (a[0] != '-' && !tracePath) {
+      tracePath = argv[i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if ((tracePath == NULL) == (fuzzCases <= 0)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::vector<Event> events;
+  if (tracePath && !loadTrace(tracePath, events)) {
+    return 2;
+  }
+
+  if (outPath) {
+    traceOut = fopen(outPath, "w");
+    if (!traceOut) {
+      fprintf(stderr, "replay: cannot write '%s'\n", outPath);
+      return 2;
+    }
+    fputs(SERIAL_TRACE_HEADER, traceOut);
+  }
+
+  HalSim::reset();
+  HalSim::setLineBaud(lineBaud);
+  HalSim::setTxHook(captureTx);
+  setup();
+  runUntil((uint64_t)REPLAY_BOOT_MS * (F_CPU / 1000UL));
+  txPending.clear();  // 開機訊息不列入記錄
+  replayStart = HalSim::cycles();
+
+  // 模糊測試流量在開機後產生（依實際鮑率計算傳輸時間）
+  FuzzGen gen;
+  if (fuzzCases > 0) {
+    gen.rng.seed(seed);
+    gen.byteMs = 10000.0 / (lineBaud ? lineBaud : HalSim::serialBaud());
+    gen.generate(fuzzCases);
+    events = gen.events;
+  }
+
+  std::vector<Window> windows;
+  replay(events, windows);
+  if (traceOut) {
+    fclose(traceOut);
+  }
+
+  reportCommands(replayMs());
+  if (fuzzCases > 0) {
+    return checkFuzz(gen, windows, verbose) ? 1 : 0;
+  }
+  bool recorded = false;
+  for (const Event& e : events) {
+    recorded |= !e.rx;
+  }
+  if (!recorded) {
+    fprintf(stderr, "responses: trace has no TX records, not compared\n");
+    return 0;
+  }
+  return compareWindows(windows, ignore, verbose) ? 1 : 0;
+}
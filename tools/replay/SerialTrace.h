@@ -0,0 +1,140 @@
+/*
+ * ============================================================================
+ * SerialTrace.h
+ * 序列流量記錄格式（tools/replay 重播、tools/loadd -R 記錄共用）
+ *
+ * 一行一筆記錄，# 開頭為註解：
+ *   <毫秒> <RX|TX> "<資料>"
+ *   0.000 RX "PING\n"
+ *   1.180 TX "BLE RX: PING\r\nACK\r\n"
+ *
+ * - 方向以板子為準：RX = PC → 板子（命令），TX = 板子 → PC（回覆）
+ * - 時間為相對於第一筆記錄的毫秒數（小數 3 位），必須遞增
+ * - 資料以 C 字串跳脫：\r \n \t \\ \" 與 \xHH（固定兩位十六進位），其餘可見 ASCII 原樣
+ * - 一筆 TX 記錄的內容屬於它之前最近的一筆 RX（重播時以此比對回覆）
+ * ============================================================================
+ */
+
+#ifndef SERIAL_TRACE_H
+#define SERIAL_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#define SERIAL_TRACE_HEADER "# serial-trace 1\n"
+
+/**
+ * @brief 將資料跳脫為記錄格式的字串內容（不含引號）
+ */
+inline std::string traceEscape(const uint8_t* data, size_t len) {
+  std::string out;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t c = data[i];
+    switch (c) {
+      case '\r': out += "\\r"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      case '\\': out += "\\\\"; break;
+      case '"': out += "\\\""; break;
+      default:
+        if (c >= 0x20 && c < 0x7F) {
+          out += (char)c;
+        } else {
+          char hex[5];
+          snprintf(hex, sizeof(hex), "\\x%02X", c);
+          out += hex;
+        }
+        break;
+    }
+  }
+  return out;
+}
+
+inline std::string traceEscape(const std::string& data) {
+  return traceEscape((const uint8_t*)data.data(), data.size());
+}
+
+/**
+ * @brief 寫入一筆記錄
+ * @param rx true = PC → 板子
+ */
+inline void traceWrite(FILE* f, double ms, bool rx, const uint8_t* data, size_t len) {
+  fprintf(f, "%.3f %s \"%s\"\n", ms, rx ? "RX" : "TX", traceEscape(data, len).c_str());
+}
+
+inline int traceHexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * @brief 解析一行記錄
+ * @return 1 = 取得一筆記錄；0 = 空白行或註解；-1 = 格式錯誤
+ */
+inline int traceParse(const char* line, double* ms, bool* rx, std::string* data) {
+  while (*line == ' ' || *line == '\t') {
+    line++;
+  }
+  if (*line == '\0' || *line == '\n' || *line == '\r' || *line == '#') {
+    return 0;
+  }
+  char* end;
+  *ms = strtod(line, &end);
+  if (end == line || *end != ' ') {
+    return -1;
+  }
+  line = end + 1;
+  if (line[0] == 'R' && line[1] == 'X') {
+    *rx = true;
+  } else if (line[0] == 'T' && line[1] == 'X') {
+    *rx = false;
+  } else {
+    return -1;
+  }
+  line += 2;
+  if (line[0] != ' ' || line[1] != '"') {
+    return -1;
+  }
+  line += 2;
+
+  data->clear();
+  for (;;) {
+    char c = *line++;
+    if (c == '"') {
+      return 1;
+    }
+    if (c == '\0' || c == '\n') {
+      return -1;  // 缺少結尾引號
+    }
+    if (c != '\\') {
+      data->push_back(c);
+      continue;
+    }
+    c = *line++;
+    switch (c) {
+      case 'r': data->push_back('\r'); break;
+      case 'n': data->push_back('\n'); break;
+      case 't': data->push_back('\t'); break;
+      case '\\': data->push_back('\\'); break;
+      case '"': data->push_back('"'); break;
+      case 'x': {
+        int hi = traceHexDigit(line[0]);
+        int lo = hi < 0 ? -1 : traceHexDigit(line[1]);
+        if (lo < 0) {
+          return -1;
+        }
+        data->push_back((char)(hi * 16 + lo));
+        line += 2;
+        break;
+      }
+      default:
+        return -1;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,10 @@
+# ============================================================================
+# pio_sanitize.py
+# PlatformIO extra script：以 AddressSanitizer / UBSan 編譯與連結 [env:native_replay_asan]
+# （build_flags 只加到編譯參數，-fsanitize 必須同時出現在連結參數）
+# ============================================================================
+Import("env")
+
+SANITIZE = ["-fsanitize=address,undefined", "-fno-omit-frame-pointer", "-fno-sanitize-recover=all"]
+
+env.Append(CCFLAGS=SANITIZE, LINKFLAGS=SANITIZE)
@@ -0,0 +1,123 @@
+/*
+ * ============================================================================
+ * Rgb565Bench.cpp
+ * [env:native_rgb565] RGB888 → RGB565 轉換基準測試
+ *
+ * 使用方式：
+ *   pio run -e native_rgb565 && .pio/build/native_rgb565/program [重複次數]
+ *
+ * 比較：
+ * - convert24to16()：Engnin_comp_2025.h 原本的寫法（3 次 map()）
+ * - rgb565()：constexpr 函式的執行時期路徑（乘法 + 移位）
+ * - rgb565Convert()：批次轉換
+ * - RGB565()：編譯時期常數（以 static_assert 與執行時期比對，不計時間）
+ *
+ * 正確性：三個分量各 256 個值逐一比對（分量彼此獨立，等同涵蓋全部 16M 色），
+ * 另以隨機顏色比對整個 24 位元值；任何不一致時結束碼為 1
+ *
+ * 時間為主機上的每色奈秒數，只代表相對成本：AVR 上 map() 的 32 位元除法
+ * 由函式庫迴圈完成，差距會比主機上大得多
+ * ============================================================================
+ */
+
+#include <Engnin_comp_2025.h>
+#include <Rgb565.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#define BENCH_COLORS 4096
+
+// 編譯時期常數：與 ST77XX 內建色（已是 RGB565）及手算結果比對
+static_assert(RGB565(0x000000) == 0x0000, "black");
+static_assert(RGB565(0xFFFFFF) == 0xFFFF, "white");
+static_assert(RGB565(0xFF0000) == 0xF800, "red");
+static_assert(RGB565(0x00FF00) == 0x07E0, "green");
+static_assert(RGB565(0x0000FF) == 0x001F, "blue");
+static_assert(RGB565(0x080808) == 0x0020, "rounds down like map(): 8*31/255 = 0, 8*63/255 = 1");
+static_assert(RGB565(0xFF5500) == ((31 << 11) | ((0x55 * 63 / 255) << 5)), "orange");
+
+static uint32_t colors[BENCH_COLORS];
+static uint16_t out[BENCH_COLORS];
+static volatile uint16_t sink;
+
+typedef std::chrono::steady_clock Clock;
+
+static double nsPerColor(Clock::time_point t0, Clock::time_point t1, long reps) {
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)reps * BENCH_COLORS);
+}
+
+// ========== 正確性 ==========
+static long checkChannels() {
+  long errors = 0;
+  for (uint32_t v = 0; v < 256; v++) {
+    const uint32_t c[3] = {v << 16, v << 8, v};
+    for (int ch = 0; ch < 3; ch++) {
+      uint16_t expect = convert24to16(c[ch]);
+      if (rgb565(c[ch]) != expect) {
+        if (errors++ < 8) {
+          printf("MISMATCH %06lX: convert24to16=%04X rgb565=%04X\n",
+                 (unsigned long)c[ch], expect, rgb565(c[ch]));
+        }
+      }
+    }
+  }
+  return errors;
+}
+
+static long checkColors() {
+  long errors = 0;
+  rgb565Convert(colors, out, BENCH_COLORS);
+  for (int i = 0; i < BENCH_COLORS; i++) {
+    uint16_t expect = convert24to16(colors[i]);
+    if (rgb565(colors[i]) != expect || out[i] != expect) {
+      if (errors++ < 8) {
+        printf("MISMATCH %06lX: convert24to16=%04X rgb565=%04X batch=%04X\n",
+               (unsigned long)colors[i], expect, rgb565(colors[i]), out[i]);
+      }
+    }
+  }
+  return errors;
+}
+
+// ========== 執行時間 ==========
+int main(int argc, char** argv) {
+  long reps = (argc > 1) ? atol(argv[1]) : 2000;
+  srand(1);
+  for (int i = 0; i < BENCH_COLORS; i++) {
+    colors[i] = ((uint32_t)(rand() & 0xFF) << 16) | ((rand() & 0xFF) << 8) | (rand() & 0xFF);
+  }
+
+  long errors = checkChannels() + checkColors();
+  printf("equality: %s (%d channel values x 3, %d random colors)\n",
+         errors ? "FAIL" : "OK", 256, BENCH_COLORS);
+
+  Clock::time_point t0 = Clock::now();
+  for (long r = 0; r < reps; r++) {
+    for (int i = 0; i < BENCH_COLORS; i++) {
+      sink = convert24to16(colors[i]);
+    }
+  }
+  Clock::time_point t1 = Clock::now();
+  for (long r = 0; r < reps; r++) {
+    for (int i = 0; i < BENCH_COLORS; i++) {
+      sink = rgb565(colors[i]);
+    }
+  }
+  Clock::time_point t2 = Clock::now();
+  for (long r = 0; r < reps; r++) {
+    rgb565Convert(colors, out, BENCH_COLORS);
+    sink = out[r % BENCH_COLORS];
+  }
+  Clock::time_point t3 = Clock::now();
+
+  double base = nsPerColor(t0, t1, reps);
+  double fast = nsPerColor(t1, t2, reps);
+  double batch = nsPerColor(t2, t3, reps);
+  printf("%-16s %8s %8s\n", "function", "ns/color", "speedup");
+  printf("%-16s %8.2f %8.1fx\n", "convert24to16", base, 1.0);
+  printf("%-16s %8.2f %8.1fx\n", "rgb565", fast, base / fast);
+  printf("%-16s %8.2f %8.1fx\n", "rgb565Convert", batch, base / batch);
+  printf("%-16s %8s %8s\n", "RGB565()", "0", "const");
+  return errors ? 1 : 0;
+}
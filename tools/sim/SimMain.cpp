@@ -0,0 +1,510 @@
+/*
+ * ============================================================================
+ * SimMain.cpp
+ * [env:native] 執行入口：在 Linux 上以虛擬時鐘執行 setup() / loop()
+ *
+ * 使用方式：
+ *   .pio/build/native/program [-f 腳本檔] [-q 每圈微秒] [-B 鮑率] [-e EEPROM 檔] [-H HC-05] [-C] [-t]
+ *   未指定 -f 時從標準輸入讀取腳本；韌體輸出寫到標準輸出
+ *
+ * 腳本命令（一行一個，# 開頭為註解）：
+ *   send <文字>         由 PC 端送出一行命令（自動加上 '\n'）
+ *   raw <hex> <hex>...  送出原始位元組（例如 raw A5 11 32 9C）
+ *   wait <ms>           執行 loop() 直到經過指定毫秒
+ *   key <UP|DOWN|ENTER|RETURN> [按住毫秒] [彈跳次數]
+ *                       按下並放開按鍵（預設 80ms）；指定彈跳次數時，按下與放開前
+ *                       各多切換電位 2 × 次數次（間隔 0.3ms）
+ *   screenshot <檔名>    輸出目前 TFT 畫面（PPM 格式）
+ *   bench <次數> <文字>  連續送出同一行命令並統計處理速度（輸出靜音，結果寫到 stderr）
+ *   report <名稱>        輸出目前區段的 loop() 延遲統計並清除（寫到 stderr）
+ *   wear <名稱>          輸出 EEPROM 寫入次數與單一位元組最大寫入次數（寫到 stderr）
+ *   leds <名稱>          輸出 WS2812 show() 次數與中斷關閉時間並清除（寫到 stderr）
+ *   pixels <名稱>        輸出每顆 WS2812 目前的顏色（RRGGBB，已套用亮度；寫到 stderr）
+ *   tft <名稱>           輸出 TFT 位址視窗數、像素段數、像素數與傳輸時間並清除（寫到 stderr）
+ *   timer1 <名稱> <週期us> 輸出區段內 Timer1 中斷次數，並與最後一次計時器事件的時間比較，
+ *                       以指定的中斷週期計算累積誤差（寫到 stderr）
+ *   power <名稱>         輸出區段內 sleep_cpu() 睡眠時間、CPU 活動比例與背光 PWM（D6）並清除（寫到 stderr）
+ *   hc05 <名稱>          輸出 HC-05 模型的名稱、鮑率、區段內的 AT 命令數、Flash 寫入數
+ *                       與鮑率不符的位元組數並清除（寫到 stderr）
+ *
+ * 參數：
+ *   -q <us>  每次 loop() 額外計入的 CPU 時間（預設 20µs，代表未建模的運算）
+ *   -B <bps> PC 端送出速率（預設依韌體設定的 UBRR0，即 9600bps）
+ *   -e <檔>  開機前從檔案載入 EEPROM 內容（1024 位元組，檔案不存在時為全 0xFF），
+ *            結束時寫回（用於驗證重新開機後的資料復原）
+ *   -H <設定> HC-05 模型：none = 未接 KEY（AT 命令直接送到 PC），
+ *            或 最高鮑率[:目前鮑率[:名稱]]（預設 115200:9600:HC-05，即出廠設定）
+ *   -C       HC-05 開機時已與 PC 連線（只重置 MCU）：AT 命令轉送到 PC 而不回覆，
+ *            雙向資料在 MCU 鮑率與模組不符時變成亂碼
+ *   -t       每行輸出前加上虛擬時間戳記（毫秒）
+ * ============================================================================
+ */
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <Adafruit_NeoPixel.h>
+#include <BleUart.h>
+#include <EEPROM.h>
+#include <HalSim.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+
+void setup();
+void loop();
+extern Adafruit_ST7735 tft;
+extern Adafruit_NeoPixel strip;
+
+namespace {
+
+uint32_t loopQuantumUs = 20;
+uint32_t lineBaud = 0;
+bool timestamps = false;
+bool atLineStart = true;
+bool muted = false;
+
+// loop() 延遲統計（report 命令輸出後清除）
+uint64_t loopCount = 0;
+uint64_t loopTotalCycles = 0;
+uint64_t loopMaxCycles = 0;
+
+// ========== HC-05 模型 ==========
+// 模擬 D7（KEY）拉高時的 mini AT 模式：韌體 USART 鮑率與模組鮑率相差 3% 以上時收不到命令；
+// AT+UART 只在 AT+RESET 後生效，重新開機期間不回應。KEY 拉低時為資料模式，
+// 送出的資料直接給 PC（鮑率不符時以 '?' 代表亂碼）。已連線（connected）時 KEY 不影響，
+// 一律為資料模式
+#define SIM_HC05_KEY 7  // 與 main.cpp 的 HC05_KEY 相同
+#define SIM_HC05_BOOT_MS 600
+
+struct Hc05Model {
+  bool present = true;
+  bool connected = false;      // 已與 PC 連線：不進入 AT 模式
+  uint32_t maxBaud = 115200;   // 模組接受的最高 AT+UART 鮑率
+  uint32_t baud = 9600;        // 目前 UART 鮑率
+  uint32_t storedBaud = 9600;  // AT+UART 儲存的鮑率（重新開機後生效）
+  std::string name = "HC-05";
+  std::string line;
+  uint64_t bootUntil = 0;      // 重新開機完成的時間（cycles）
+  uint32_t commands = 0;
+  uint32_t writes = 0;         // 寫入模組 Flash 的命令數
+  uint32_t garbled = 0;        // 鮑率不符而遺失 / 亂碼的位元組
+
+  bool booting() {
+    if (bootUntil && HalSim::cycles() >= bootUntil) {
+      bootUntil = 0;
+      baud = storedBaud;
+      line.clear();
+    }
+    return bootUntil != 0;
+  }
+
+  bool baudMatches() const {
+    uint32_t mcu = HalSim::serialBaud();
+    uint32_t diff = mcu > baud ? mcu - baud : baud - mcu;
+    return diff * 100 < baud * 3;
+  }
+
+  void reply(const std::string& text) {
+    HalSim::serialSend((text + "\r\n").c_str());
+  }
+
+  void execute(const std::string& cmd) {
+    commands++;
+    if (cmd == "AT") {
+      reply("OK");
+    } else if (cmd == "AT+NAME?") {
+      reply("+NAME:" + name);
+      reply("OK");
+    } else if (cmd.compare(0, 8, "AT+NAME=") == 0) {
+      name = cmd.substr(8);
+      writes++;
+      reply("OK");
+    } else if (cmd == "AT+UART?") {
+      reply("+UART:" + std::to_string(storedBaud) + ",0,0");
+      reply("OK");
+    } else if (cmd.compare(0, 8, "AT+UART=") == 0) {
+      uint32_t b = strtoul(cmd.c_str() + 8, NULL, 10);
+      if (b < 4800 || b > maxBaud) {
+        reply("ERROR:(1D)");
+        return;
+      }
+      storedBaud = b;
+      writes++;
+      reply("OK");
+    } else if (cmd == "AT+RESET") {
+      reply("OK");
+      bootUntil = HalSim::cycles() + (uint64_t)SIM_HC05_BOOT_MS * (F_CPU / 1000UL);
+    } else {
+      reply("ERROR:(0)");
+    }
+  }
+
+  // 韌體送出一個位元組；回傳 true 表示由模組處理（不送到 PC）
+  bool onTx(uint8_t& c) {
+    if (!present) {
+      return false;
+    }
+    if (connected) {
+      if (!baudMatches()) {
+        garbled++;
+        c = '?';
+      }
+      return false;
+    }
+    if (booting()) {
+      garbled++;
+      return true;
+    }
+    if (!baudMatches()) {
+      garbled++;
+      if (HalSim::pinOutput(SIM_HC05_KEY)) {
+        return true;
+      }
+      c = '?';
+      return false;
+    }
+    if (!HalSim::pinOutput(SIM_HC05_KEY)) {
+      return false;
+    }
+    if (c == '\n') {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      execute(line);
+      line.clear();
+    } else if (line.size() < 64) {
+      line.push_back((char)c);
+    }
+    return true;
+  }
+};
+
+Hc05Model hc05Model;
+
+// PC 送出的資料經已連線的模組轉送：MCU 鮑率與模組不符時收到亂碼
+void pcSend(std::string data) {
+  if (hc05Model.present && hc05Model.connected && !hc05Model.baudMatches()) {
+    hc05Model.garbled += data.size();
+    data.assign(data.size(), '?');
+  }
+  HalSim::serialSend((const uint8_t*)data.data(), data.size());
+}
+
+// HC-05 模型目前的設定與區段內的 AT 命令統計
+void reportHc05(const std::string& label) {
+  if (!hc05Model.present) {
+    fprintf(stderr, "== %s ==  hc05 none\n", label.c_str());
+    return;
+  }
+  fprintf(stderr, "== %s ==  hc05 name %s  baud %u (mcu %u)  at %u  flash writes %u  garbled %u%s\n",
+          label.c_str(), hc05Model.name.c_str(), (unsigned)hc05Model.baud,
+          (unsigned)HalSim::serialBaud(), (unsigned)hc05Model.commands, (unsigned)hc05Model.writes,
+          (unsigned)hc05Model.garbled, hc05Model.connected ? "  connected" : "");
+  hc05Model.commands = hc05Model.writes = hc05Model.garbled = 0;
+}
+
+void printTx(uint8_t c) {
+  if (hc05Model.onTx(c)) {
+    return;
+  }
+  if (muted) {
+    return;
+  }
+  if (timestamps && atLineStart && c != '\r' && c != '\n') {
+    printf("[%10.3f] ", HalSim::cycles() / (F_CPU / 1000.0));
+  }
+  if (c != '\r') {
+    putchar(c);
+  }
+  atLineStart = (c == '\n');
+}
+
+void runFor(uint32_t ms) {
+  uint64_t end = HalSim::cycles() + (uint64_t)ms * (F_CPU / 1000UL);
+  while (HalSim::cycles() < end) {
+    uint64_t start = HalSim::cycles();
+    loop();
+    HalSim::advanceMicros(loopQuantumUs);
+    uint64_t d = HalSim::cycles() - start;
+    loopCount++;
+    loopTotalCycles += d;
+    if (d > loopMaxCycles) {
+      loopMaxCycles = d;
+    }
+  }
+}
+
+void report(const std::string& label) {
+  double usPerCycle = 1e6 / F_CPU;
+  fprintf(stderr, "== %s ==  loops %llu  avg %.1f us  max %.1f us\n", label.c_str(),
+          (unsigned long long)loopCount,
+          loopCount ? loopTotalCycles * usPerCycle / loopCount : 0.0, loopMaxCycles * usPerCycle);
+  loopCount = loopTotalCycles = loopMaxCycles = 0;
+}
+
+// EEPROM 耗損統計：全部寫入次數、寫入過的位元組數與單一位元組最大寫入次數
+void reportWear(const std::string& label) {
+  uint32_t maxWear = 0;
+  int maxAddr = 0;
+  int used = 0;
+  for (int i = 0; i <= E2END; i++) {
+    if (EEPROM.wear(i) > maxWear) {
+      maxWear = EEPROM.wear(i);
+      maxAddr = i;
+    }
+    used += EEPROM.wear(i) ? 1 : 0;
+  }
+  fprintf(stderr, "== %s ==  eeprom writes %u  cells used %d  max cell %u (addr %d)\n", label.c_str(),
+          (unsigned)EEPROM.totalWrites(), used, (unsigned)maxWear, maxAddr);
+}
+
+// WS2812 統計：區段內的 show() 次數與中斷關閉時間
+void reportLeds(const std::string& label) {
+  static uint32_t lastShows = 0;
+  static uint64_t lastIrqOff = 0;
+  uint32_t shows = strip.showCount() - lastShows;
+  double irqOffMs = (strip.irqOffCycles() - lastIrqOff) * 1000.0 / F_CPU;
+  fprintf(stderr, "== %s ==  ws2812 show %u  irq off %.1f ms\n", label.c_str(), (unsigned)shows, irqOffMs);
+  lastShows = strip.showCount();
+  lastIrqOff = strip.irqOffCycles();
+}
+
+// WS2812 目前每顆的顏色
+void reportPixels(const std::string& label) {
+  fprintf(stderr, "== %s ==  ws2812", label.c_str());
+  for (uint16_t i = 0; i < strip.numPixels(); i++) {
+    fprintf(stderr, " %06X", (unsigned)strip.getPixelColor(i));
+  }
+  fprintf(stderr, "\n");
+}
+
+// TFT 統計：區段內的位址視窗、writeColor() 段數、像素數與 SPI 傳輸時間
+void reportTft(const std::string& label) {
+  const HalTftStats& s = tft.halStats();
+  fprintf(stderr, "== %s ==  tft windows %u  writes %u  pixels %u  bus %.2f ms\n", label.c_str(),
+          (unsigned)s.windows, (unsigned)s.writes, (unsigned)s.pixels, s.cycles * 1000.0 / F_CPU);
+  tft.halResetStats();
+}
+
+// Timer1 誤差：區段內最後一次計時器事件的時間 與 中斷次數 × 標稱週期 相比
+// （以事件發生時間計算，中斷延後執行的抖動不算誤差，重新載入遺失的計數會累積）
+void reportTimer1(const std::string& label, double periodUs) {
+  static uint32_t lastIsr = 0;
+  static uint64_t lastEvent = 0;
+  uint32_t isr = HalSim::isrStats().timer1 - lastIsr;
+  double spanMs = (HalSim::timer1LastEvent() - lastEvent) * 1000.0 / F_CPU;
+  double driftMs = spanMs - isr * periodUs / 1000.0;
+  fprintf(stderr, "== %s ==  timer1 isr %u  span %.3f ms  drift %.3f ms\n", label.c_str(),
+          (unsigned)isr, spanMs, driftMs);
+  lastIsr = HalSim::isrStats().timer1;
+  lastEvent = HalSim::timer1LastEvent();
+}
+
+// 睡眠統計：區段內 sleep_cpu() 睡眠的時間，其餘為 CPU 執行中
+void reportPower(const std::string& label) {
+  static uint64_t lastCycles = 0;
+  static uint64_t lastSlept = 0;
+  uint64_t span = HalSim::cycles() - lastCycles;
+  uint64_t slept = HalSim::sleptCycles() - lastSlept;
+  fprintf(stderr, "== %s ==  span %.1f ms  slept %.1f ms  active %.1f%%  backlight %d\n", label.c_str(),
+          span * 1000.0 / F_CPU, slept * 1000.0 / F_CPU, span ? 100.0 * (span - slept) / span : 0.0,
+          HalSim::pinPwm(6));
+  lastCycles = HalSim::cycles();
+  lastSlept = HalSim::sleptCycles();
+}
+
+// 逐一送出命令並執行 loop() 直到處理完畢，統計主機與虛擬時間的處理速度
+void runBench(long count, const std::string& text) {
+  std::string line = text + "\n";
+  uint64_t startCycles = HalSim::cycles();
+  size_t startOut = HalSim::serialOutput().size();
+  auto startWall = std::chrono::steady_clock::now();
+
+  muted = true;
+  for (long i = 0; i < count; i++) {
+    HalSim::serialSend(line.c_str());
+    do {
+      loop();
+      HalSim::advanceMicros(loopQuantumUs);
+    } while (HalSim::serialPending() > 0 || bleSerial.framesReady() > 0);
+  }
+  muted = false;
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - startWall).count();
+  double virt = (HalSim::cycles() - startCycles) / (double)F_CPU;
+  fprintf(stderr, "bench: %ld x '%s'\n", count, text.c_str());
+  fprintf(stderr, "  host    %.3f s  %.0f cmd/s\n", wall, count / wall);
+  fprintf(stderr, "  virtual %.3f s  %.0f cmd/s  (line %u bps)\n", virt, count / virt,
+          (unsigned)(lineBaud ? lineBaud : HalSim::serialBaud()));
+  fprintf(stderr, "  reply   %.1f bytes/cmd\n",
+          (HalSim::serialOutput().size() - startOut) / (double)count);
+  HalSim::serialOutput().resize(startOut);  // 不保留大量基準測試輸出
+}
+
+int keyPin(const std::string& name) {
+  if (name == "UP") return A0;
+  if (name == "DOWN") return A1;
+  if (name == "ENTER") return A2;
+  if (name == "RETURN") return A3;
+  return -1;
+}
+
+void runScriptLine(const std::string& line) {
+  size_t sp = line.find(' ');
+  std::string cmd = line.substr(0, sp);
+  std::string arg = (sp == std::string::npos) ? "" : line.substr(sp + 1);
+
+  if (cmd == "send") {
+    pcSend(arg + "\n");
+  } else if (cmd == "raw") {
+    std::string bytes;
+    const char* p = arg.c_str();
+    char* end;
+    for (;;) {
+      long v = strtol(p, &end, 16);
+      if (end == p) break;
+      bytes.push_back((char)v);
+      p = end;
+    }
+    pcSend(bytes);
+  } else if (cmd == "wait") {
+    runFor(atoi(arg.c_str()));
+  } else if (cmd == "key") {
+    char name[16] = {0};
+    unsigned hold = 80, bounces = 0;
+    sscanf(arg.c_str(), "%15s %u %u", name, &hold, &bounces);
+    int pin = keyPin(name);
+    if (pin < 0) {
+      fprintf(stderr, "sim: unknown key '%s'\n", arg.c_str());
+      return;
+    }
+    for (int level = LOW; level <= HIGH; level++) {
+      for (unsigned i = 0; i < bounces; i++) {
+        HalSim::setPinInput(pin, level);
+        HalSim::advanceMicros(300);
+        HalSim::setPinInput(pin, !level);
+        HalSim::advanceMicros(300);
+      }
+      HalSim::setPinInput(pin, level);
+      if (level == LOW) {
+        runFor(hold);
+      }
+    }
+  } else if (cmd == "screenshot") {
+    if (!tft.halSavePpm(arg.c_str())) {
+      fprintf(stderr, "sim: cannot write '%s'\n", arg.c_str());
+    }
+  } else if (cmd == "bench") {
+    size_t sp2 = arg.find(' ');
+    long count = atol(arg.substr(0, sp2).c_str());
+    if (count <= 0 || sp2 == std::string::npos) {
+      fprintf(stderr, "sim: usage: bench <count> <text>\n");
+      return;
+    }
+    runBench(count, arg.substr(sp2 + 1));
+  } else if (cmd == "report") {
+    report(arg.empty() ? "section" : arg);
+  } else if (cmd == "leds") {
+    reportLeds(arg.empty() ? "ws2812" : arg);
+  } else if (cmd == "pixels") {
+    reportPixels(arg.empty() ? "ws2812" : arg);
+  } else if (cmd == "tft") {
+    reportTft(arg.empty() ? "tft" : arg);
+  } else if (cmd == "timer1") {
+    char name[32] = "timer1";
+    double periodUs = 1000;
+    sscanf(arg.c_str(), "%31s %lf", name, &periodUs);
+    reportTimer1(name, periodUs);
+  } else if (cmd == "power") {
+    reportPower(arg.empty() ? "power" : arg);
+  } else if (cmd == "hc05") {
+    reportHc05(arg.empty() ? "hc05" : arg);
+  } else if (cmd == "wear") {
+    reportWear(arg.empty() ? "eeprom" : arg);
+  } else if (!cmd.empty() && cmd[0] != '#') {
+    fprintf(stderr, "sim: unknown command '%s'\n", cmd.c_str());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FILE* script = stdin;
+  const char* eepromFile = NULL;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "-f" && i + 1 < argc) {
+      script = fopen(argv[++i], "r");
+      if (!script) {
+        fprintf(stderr, "sim: cannot open '%s'\n", argv[i]);
+        return 1;
+      }
+    } else if (a == "-q" && i + 1 < argc) {
+      loopQuantumUs = atoi(argv[++i]);
+    } else if (a == "-B" && i + 1 < argc) {
+      lineBaud = atol(argv[++i]);
+    } else if (a == "-e" && i + 1 < argc) {
+      eepromFile = argv[++i];
+    } else if (a == "-H" && i + 1 < argc) {
+      std::string spec = argv[++i];
+      if (spec == "none") {
+        hc05Model.present = false;
+      } else {
+        char name[32] = "";
+        unsigned maxBaud = 0, baud = 0;
+        int n = sscanf(spec.c_str(), "%u:%u:%31s", &maxBaud, &baud, name);
+        hc05Model.maxBaud = maxBaud;
+        if (n >= 2) {
+          hc05Model.baud = hc05Model.storedBaud = baud;
+        }
+        if (n >= 3) {
+          hc05Model.name = name;
+        }
+      }
+    } else if (a == "-C") {
+      hc05Model.connected = true;
+    } else if (a == "-t") {
+      timestamps = true;
+    } else {
+      fprintf(stderr, "usage: %s [-f script] [-q loop_us] [-B bps] [-e eeprom.bin] [-H none|max[:baud[:name]]] [-C] [-t]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  HalSim::reset();
+  HalSim::setLineBaud(lineBaud);
+  HalSim::setTxHook(printTx);
+  if (eepromFile) {
+    FILE* f = fopen(eepromFile, "rb");
+    if (f) {
+      fread(EEPROM.image(), 1, E2END + 1, f);
+      fclose(f);
+    }
+  }
+  setup();
+
+  char buf[512];
+  while (fgets(buf, sizeof(buf), script)) {
+    std::string line = buf;
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    runScriptLine(line);
+  }
+
+  // 腳本結束後再執行一小段時間，讓尚未到達的序列資料處理完畢
+  runFor(100 + HalSim::serialPending() * 2);
+  fflush(stdout);
+
+  if (eepromFile) {
+    FILE* f = fopen(eepromFile, "wb");
+    if (!f) {
+      fprintf(stderr, "sim: cannot write '%s'\n", eepromFile);
+      return 1;
+    }
+    fwrite(EEPROM.image(), 1, E2END + 1, f);
+    fclose(f);
+  }
+  return 0;
+}
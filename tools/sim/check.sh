@@ -0,0 +1,92 @@
+#!/bin/sh
+# ============================================================================
+# check.sh
+# 主機回歸測試：以 [env:native] 執行 tools/sim/tests/*.txt 並與 *.expected 比對，
+# 以 [env:native_replay] 重播 tools/replay/traces/*.trace 並執行固定種子的模糊測試
+#
+# 需求：PlatformIO（或以 SIM / REPLAY 指定已建置的程式）
+# 用法：tools/sim/check.sh [-u] [腳本名稱...]
+#   -u  以目前韌體的輸出更新比對基準（修改行為後使用，提交前檢查差異）
+#   比對內容為模擬器的 stdout、stderr，以及腳本輸出截圖的 SHA-256；任一項不符時結束碼為 1
+#   腳本中的 "# sim: <參數>" 行各代表一次開機（依序以同一腳本、同一執行目錄執行，
+#   例如以 -e 保留 EEPROM 內容模擬重新開機）；沒有時以預設參數執行一次
+# ============================================================================
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+TESTS=$ROOT/tools/sim/tests
+UPDATE=0
+if [ "$1" = "-u" ]; then
+  UPDATE=1
+  shift
+fi
+
+if [ -z "$SIM" ]; then
+  pio run -d "$ROOT" -e native
+  SIM=$ROOT/.pio/build/native/program
+fi
+if [ -z "$REPLAY" ]; then
+  pio run -d "$ROOT" -e native_replay
+  REPLAY=$ROOT/.pio/build/native_replay/program
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+# ===== 模擬腳本 =====
+if [ $# -eq 0 ]; then
+  set -- $(cd "$TESTS" && ls *.txt | sed 's/\.txt$//')
+fi
+for name in "$@"; do
+  rm -rf "$WORK/run" && mkdir "$WORK/run"
+  # stdout（韌體的序列輸出）與 stderr（report / leds / wear 等統計）分開附加，
+  # 截圖寫在執行目錄，依檔名排序附加雜湊值
+  sed -n 's/^# sim://p' "$TESTS/$name.txt" > "$WORK/boots"
+  [ -s "$WORK/boots" ] || echo > "$WORK/boots"
+  : > "$WORK/out"
+  : > "$WORK/err"
+  while IFS= read -r opts; do
+    if [ -n "$opts" ]; then
+      if [ -s "$WORK/out" ] && [ -n "$(tail -c 1 "$WORK/out")" ]; then
+        echo >> "$WORK/out"  # 上一次開機的輸出不是以換行結束（亂碼）
+      fi
+      echo "---- sim:$opts" | tee -a "$WORK/out" >> "$WORK/err"
+    fi
+    (cd "$WORK/run" && "$SIM" $opts -f "$TESTS/$name.txt" >> ../out 2>> ../err || echo "exit $?" >> ../out)
+  done < "$WORK/boots"
+  echo "---- stderr" >> "$WORK/out"
+  cat "$WORK/err" >> "$WORK/out"
+  echo "---- screenshots" >> "$WORK/out"
+  (cd "$WORK/run" && for f in $(ls *.ppm 2>/dev/null); do sha256sum "$f"; done) >> "$WORK/out"
+  if [ $UPDATE -eq 1 ]; then
+    cp "$WORK/out" "$TESTS/$name.expected"
+    echo "$name: updated"
+  elif diff -u "$TESTS/$name.expected" "$WORK/out" > "$WORK/diff"; then
+    echo "$name: ok"
+  else
+    echo "$name: FAILED"
+    head -40 "$WORK/diff"
+    FAILED=1
+  fi
+done
+
+# ===== 重播與模糊測試 =====
+for trace in "$ROOT"/tools/replay/traces/*.trace; do
+  if "$REPLAY" "$trace" > "$WORK/replay" 2>&1; then
+    echo "$(basename "$trace"): ok"
+  else
+    echo "$(basename "$trace"): FAILED"
+    cat "$WORK/replay"
+    FAILED=1
+  fi
+done
+if "$REPLAY" -z 5000 -S 1 > "$WORK/fuzz" 2>&1; then
+  echo "fuzz: ok"
+else
+  echo "fuzz: FAILED"
+  cat "$WORK/fuzz"
+  FAILED=1
+fi
+
+exit $FAILED